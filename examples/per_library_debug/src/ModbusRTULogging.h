@@ -46,13 +46,13 @@
     #endif
 #endif
 
-// Conditional packet logging
-#ifdef MODBUS_LOG_PACKETS
+// Conditional packet logging - one log call per packet, not per byte
+#if defined(MODBUS_LOG_PACKETS) && defined(USE_CUSTOM_LOGGER)
+    #define MODBUS_LOG_PACKET(msg, data, len) LOG_HEX(MODBUS_LOG_LEVEL_D, MODBUS_LOG_TAG, msg, data, len)
+#elif defined(MODBUS_LOG_PACKETS)
     #define MODBUS_LOG_PACKET(msg, data, len) do { \
         MODBUS_LOG_D("%s:", msg); \
-        for (int i = 0; i < len; i++) { \
-            MODBUS_LOG_D("  [%02d] = 0x%02X", i, data[i]); \
-        } \
+        ESP_LOG_BUFFER_HEX_LEVEL(MODBUS_LOG_TAG, data, len, ESP_LOG_DEBUG); \
     } while(0)
 #else
     #define MODBUS_LOG_PACKET(msg, data, len) ((void)0)
@@ -0,0 +1,213 @@
+/*
+ * AsyncRingBackend.cpp - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// AsyncRingBackend.cpp
+#include "AsyncRingBackend.h"
+#include "LoggerConfig.h"
+
+// Idle wake-up period; also bounds latency if a notification is ever missed
+static constexpr uint32_t DRAIN_IDLE_TIMEOUT_MS = 100;
+
+AsyncRingBackend::AsyncRingBackend(std::shared_ptr<ILogBackend> sink)
+    : AsyncRingBackend(std::move(sink), Config()) {
+}
+
+AsyncRingBackend::AsyncRingBackend(std::shared_ptr<ILogBackend> sink, const Config& config)
+    : config_(config) {
+    ring_.init(config_.capacity, config_.usePsram);
+    addSink(std::move(sink));
+}
+
+AsyncRingBackend::~AsyncRingBackend() {
+    stop();
+}
+
+bool AsyncRingBackend::addSink(std::shared_ptr<ILogBackend> sink) {
+    // Sinks are read by the drain task without locking
+    if (!sink || drainTask_ != nullptr || sinkCount_ >= CONFIG_LOG_ASYNC_MAX_SINKS) {
+        return false;
+    }
+    sinks_[sinkCount_++] = std::move(sink);
+    return true;
+}
+
+bool AsyncRingBackend::start() {
+    // Already running?
+    if (drainTask_ != nullptr) {
+        return true;
+    }
+    if (!ring_.isInitialized()) {
+        return false;
+    }
+
+    running_.store(true);
+
+    // The task cannot exit before stop(), so storing the handle after
+    // creation does not race with its own clear
+    LogPlatform::TaskHandle task = nullptr;
+    if (!LogPlatform::startTask(drainTaskFunc, config_.taskName, config_.stackSize, this, config_.priority,
+                                config_.coreId, &task)) {
+        running_.store(false);
+        return false;
+    }
+    drainTask_.store(task);
+
+    return true;
+}
+
+void AsyncRingBackend::stop() {
+    if (drainTask_ == nullptr) {
+        return;
+    }
+
+    // Signal task to stop; it drains the ring once more before exiting
+    running_.store(false);
+    LogPlatform::notifyTask(drainTask_);
+
+    // Wait for task to finish (with timeout)
+    for (int i = 0; i < 50 && drainTask_ != nullptr; i++) {
+        LogPlatform::delayMs(10);
+    }
+
+    // Force delete if still running
+    if (drainTask_ != nullptr) {
+        LogPlatform::killTask(drainTask_);
+        drainTask_ = nullptr;
+    }
+}
+
+void AsyncRingBackend::write(const std::string& logMessage) {
+    write(logMessage.c_str(), logMessage.length());
+}
+
+void AsyncRingBackend::write(const char* logMessage, size_t length) {
+    if (!logMessage || length == 0) return;
+
+    // Full ring: dropped and counted by LogRingBuffer
+    if (!ring_.push(logMessage, length)) return;
+
+    // Only pay for a notification when the drain task is actually asleep
+    if (drainWaiting_.load(std::memory_order_seq_cst) &&
+        drainWaiting_.exchange(false, std::memory_order_acq_rel)) {
+        wakeDrainTask();
+    }
+}
+
+void AsyncRingBackend::flush() {
+    if (drainTask_ == nullptr) {
+        // No drain task - empty the ring on the caller's task
+        drainPending();
+        flushSinks();
+        return;
+    }
+
+    flushRequested_.store(true, std::memory_order_release);
+    wakeDrainTask();
+
+    // Bounded wait: flush() must not turn into an unbounded stall
+    uint32_t start = LogPlatform::millis();
+    while ((ring_.hasPending() || flushRequested_.load(std::memory_order_acquire)) &&
+           (LogPlatform::millis() - start) < LoggerConfig::MUTEX_STANDARD_TIMEOUT_MS) {
+        LogPlatform::delayMs(1);
+    }
+}
+
+void AsyncRingBackend::wakeDrainTask() {
+    LogPlatform::TaskHandle task = drainTask_;
+    if (task) LogPlatform::notifyTask(task);
+}
+
+void AsyncRingBackend::drainPending() {
+    LogRecordView batch[CONFIG_LOG_ASYNC_BATCH_SIZE];
+    for (;;) {
+        // Collect what is committed; records stay in place until popUntil()
+        uint32_t cursor = ring_.cursor();
+        size_t count = 0;
+        const uint8_t* data;
+        size_t length;
+        while (count < CONFIG_LOG_ASYNC_BATCH_SIZE && ring_.peekNext(cursor, data, length)) {
+            batch[count].data = reinterpret_cast<const char*>(data);
+            batch[count].length = length;
+            count++;
+        }
+        if (count == 0) return;
+
+        for (size_t i = 0; i < sinkCount_; i++) {
+            sinks_[i]->writeBatch(batch, count);
+        }
+        ring_.popUntil(cursor);
+        written_.fetch_add(count, std::memory_order_relaxed);
+    }
+}
+
+void AsyncRingBackend::flushSinks() {
+    for (size_t i = 0; i < sinkCount_; i++) {
+        sinks_[i]->flush();
+    }
+}
+
+void AsyncRingBackend::drainTaskFunc(void* param) {
+    AsyncRingBackend* self = static_cast<AsyncRingBackend*>(param);
+    bool unflushed = false;  // Records written since the sinks were last flushed
+
+    while (self->running_.load()) {
+        // Linger so records arriving together leave together
+        if (self->config_.batchDelayMs > 0 && self->ring_.hasPending() &&
+            self->ring_.used() < self->ring_.capacity() / 2 &&
+            !self->flushRequested_.load(std::memory_order_acquire)) {
+            LogPlatform::delayMs(self->config_.batchDelayMs);
+        }
+        uint32_t drained = self->written_.load(std::memory_order_relaxed);
+        self->drainPending();
+        bool idle = self->written_.load(std::memory_order_relaxed) == drained;
+        if (!idle) unflushed = true;
+
+        if (self->flushRequested_.load(std::memory_order_acquire) && !self->ring_.hasPending()) {
+            self->flushSinks();
+            self->flushRequested_.store(false, std::memory_order_release);
+            unflushed = false;
+        } else if (idle && unflushed && !self->ring_.hasPending()) {
+            // Quiet for a whole idle timeout: flush so sinks that stage output
+            // (FlashRingBackend) do not keep the last lines before a hang in RAM
+            self->flushSinks();
+            unflushed = false;
+        }
+
+        // Announce sleep before re-checking so a concurrent write() either
+        // sees the flag and notifies, or its record is seen here
+        self->drainWaiting_.store(true, std::memory_order_seq_cst);
+        if (self->ring_.hasPending()) {
+            // Record reserved but not yet committed - poll the producer
+            LogPlatform::waitNotify(1);
+        } else {
+            LogPlatform::waitNotify(DRAIN_IDLE_TIMEOUT_MS);
+        }
+        self->drainWaiting_.store(false, std::memory_order_relaxed);
+    }
+
+    // Final drain so stop() does not lose queued messages
+    self->drainPending();
+    self->flushSinks();
+    self->flushRequested_.store(false);
+
+    self->drainTask_ = nullptr;
+    LogPlatform::endTask();
+}
@@ -0,0 +1,165 @@
+/*
+ * AsyncRingBackend.h - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// AsyncRingBackend.h
+// Never-blocking front end: lock-free ring + low-priority drain task
+#pragma once
+
+#include "ILogBackend.h"
+#include "LogRingBuffer.h"
+#include "LogPlatform.h"
+#include <atomic>
+#include <memory>
+
+#ifndef CONFIG_LOG_ASYNC_RING_SIZE
+#define CONFIG_LOG_ASYNC_RING_SIZE 4096  // Ring size in bytes (power of two)
+#endif
+
+#ifndef CONFIG_LOG_ASYNC_TASK_STACK
+#define CONFIG_LOG_ASYNC_TASK_STACK 3072  // Stack size for drain task
+#endif
+
+#ifndef CONFIG_LOG_ASYNC_TASK_PRIORITY
+#define CONFIG_LOG_ASYNC_TASK_PRIORITY 1  // Below subscriber task, above idle
+#endif
+
+#ifndef CONFIG_LOG_ASYNC_MAX_SINKS
+#define CONFIG_LOG_ASYNC_MAX_SINKS 4  // Wrapped backends per ring
+#endif
+
+#ifndef CONFIG_LOG_ASYNC_BATCH_SIZE
+#define CONFIG_LOG_ASYNC_BATCH_SIZE 16  // Max records per writeBatch() call
+#endif
+
+/**
+ * @brief Backend that decouples logging tasks from slow output
+ *
+ * write() copies the formatted message into a lock-free MPSC ring
+ * (LogRingBuffer) and returns immediately - no mutex, no waiting on the
+ * UART. A dedicated drain task empties the ring into the wrapped backend(s)
+ * using their normal blocking writes, so a message is only lost when the
+ * ring itself overflows. Overflows and the ring high-water mark are counted.
+ * Queued messages reach the sinks through writeBatch(), up to
+ * CONFIG_LOG_ASYNC_BATCH_SIZE at a time. With Config::batchDelayMs the drain
+ * task lingers that long after waking so network sinks get fuller batches;
+ * it drains at once when the ring is half full or a flush is requested.
+ * After a burst, once the ring has stayed empty for the idle timeout
+ * (~100 ms), the sinks are flushed, so staged output is never stranded.
+ *
+ * Wrap a blocking backend (ConsoleBackend, SynchronizedConsoleBackend) -
+ * wrapping a non-blocking one brings back FIFO drops in the drain task.
+ *
+ * Messages written before start() are held in the ring until the drain
+ * task runs, which is useful for capturing early boot output.
+ *
+ * Usage:
+ *   auto async = std::make_shared<AsyncRingBackend>(std::make_shared<ConsoleBackend>());
+ *   async->start();
+ *   logger.setBackend(async);
+ */
+class AsyncRingBackend : public ILogBackend {
+public:
+    struct Config {
+        size_t capacity = CONFIG_LOG_ASYNC_RING_SIZE;   // Bytes, rounded down to a power of two
+        bool usePsram = false;                          // Place ring storage in PSRAM if present
+        int coreId = -1;                                // -1 = no affinity, 0/1 = pin drain task
+        uint32_t priority = CONFIG_LOG_ASYNC_TASK_PRIORITY;
+        uint32_t stackSize = CONFIG_LOG_ASYNC_TASK_STACK;
+        const char* taskName = "LogDrain";
+        uint32_t batchDelayMs = 0;                      // Wait after the first record so batches fill up
+    };
+
+    explicit AsyncRingBackend(std::shared_ptr<ILogBackend> sink);
+    AsyncRingBackend(std::shared_ptr<ILogBackend> sink, const Config& config);
+    ~AsyncRingBackend() override;
+
+    AsyncRingBackend(const AsyncRingBackend&) = delete;
+    AsyncRingBackend& operator=(const AsyncRingBackend&) = delete;
+
+    /**
+     * @brief Add another backend fed from the same ring
+     * @return false if the drain task is running or CONFIG_LOG_ASYNC_MAX_SINKS is reached
+     */
+    bool addSink(std::shared_ptr<ILogBackend> sink);
+
+    /**
+     * @brief Start the drain task
+     * @return true if the task is running
+     */
+    bool start();
+
+    /**
+     * @brief Drain what is left, flush the sinks and stop the drain task
+     */
+    void stop();
+
+    bool isRunning() const { return drainTask_ != nullptr; }
+
+    // ILogBackend - safe from any task and from ISRs, never blocks
+    void write(const std::string& logMessage) override;
+    void write(const char* logMessage, size_t length) override;
+
+    /**
+     * @brief Wait (bounded) for the ring to drain, then flush the sinks
+     * @note Waits at most LoggerConfig::MUTEX_STANDARD_TIMEOUT_MS
+     */
+    void flush() override;
+
+    // Statistics getters
+    size_t getHighWaterMark() const { return ring_.getHighWaterMark(); }   // Bytes
+    uint32_t getOverflowCount() const { return ring_.getOverflowCount(); } // Dropped messages
+    uint32_t getWrittenCount() const { return written_.load(std::memory_order_relaxed); }
+    size_t getQueuedBytes() const { return ring_.used(); }
+    size_t getCapacity() const { return ring_.capacity(); }
+    uint32_t getDroppedMessages() const override { return getOverflowCount(); }
+
+    bool getQueueStats(BackendQueueStats& stats) const override {
+        stats.queuedBytes = getQueuedBytes();
+        stats.highWaterMark = getHighWaterMark();
+        stats.capacity = getCapacity();
+        stats.written = getWrittenCount();
+        stats.dropped = getOverflowCount();
+        return true;
+    }
+
+    void resetStats() {
+        ring_.resetStats();
+        written_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static void drainTaskFunc(void* param);
+    void drainPending();
+    void flushSinks();
+    void wakeDrainTask();
+
+    LogRingBuffer ring_;
+    Config config_;
+
+    std::shared_ptr<ILogBackend> sinks_[CONFIG_LOG_ASYNC_MAX_SINKS];
+    size_t sinkCount_ = 0;
+
+    std::atomic<LogPlatform::TaskHandle> drainTask_{nullptr};  // Cleared by the task as it exits
+    std::atomic<bool> running_{false};
+    std::atomic<bool> drainWaiting_{false};     // Drain task is (about to be) blocked
+    std::atomic<bool> flushRequested_{false};
+    std::atomic<uint32_t> written_{0};
+};
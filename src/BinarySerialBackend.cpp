@@ -0,0 +1,231 @@
+/*
+ * BinarySerialBackend.cpp - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// BinarySerialBackend.cpp
+#include "BinarySerialBackend.h"
+#include "DeferredFormat.h"
+#include "LogTag.h"
+#include <algorithm>
+#include <cstring>
+
+// Payload starts after the start and length bytes
+static constexpr size_t PAYLOAD_OFFSET = 2;
+
+static size_t putVarint(uint8_t* out, uint32_t v) {
+    size_t n = 0;
+    do {
+        uint8_t byte = v & 0x7F;
+        v >>= 7;
+        out[n++] = byte | (v ? 0x80 : 0);
+    } while (v);
+    return n;
+}
+
+uint8_t BinarySerialBackend::crc8(const uint8_t* data, size_t length, uint8_t crc) {
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+bool BinarySerialBackend::sendFrame(size_t payloadLength) {
+    frame_[0] = FRAME_START;
+    frame_[1] = static_cast<uint8_t>(payloadLength);
+    frame_[PAYLOAD_OFFSET + payloadLength] = crc8(frame_ + 1, payloadLength + 1);
+    size_t total = payloadLength + 3;
+
+    // Never split a frame: the decoder would have to resync on the next 0xA5
+    if (!blocking_ && LogPlatform::consoleAvailableForWrite() < total) {
+        droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    LogPlatform::consoleWrite(reinterpret_cast<const char*>(frame_), total);
+    framesWritten_.fetch_add(1, std::memory_order_relaxed);
+    bytesWritten_.fetch_add(total, std::memory_order_relaxed);
+    return true;
+}
+
+bool BinarySerialBackend::lock() {
+    // Pre-scheduler there is only one caller
+    if (!mutex_ || !LogPlatform::schedulerRunning()) return true;
+    if (LogPlatform::takeMutex(mutex_, LoggerConfig::MUTEX_SHORT_TIMEOUT_MS)) return true;
+    droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void BinarySerialBackend::unlock() {
+    if (mutex_ && LogPlatform::schedulerRunning()) LogPlatform::giveMutex(mutex_);
+}
+
+void BinarySerialBackend::syncIfDue(uint32_t now) {
+    if (resyncRequested_.exchange(false)) synced_ = false;
+    if (synced_ && (now - lastSync_) < CONFIG_LOG_BINARY_SYNC_INTERVAL_MS) return;
+
+    uint8_t* p = frame_ + PAYLOAD_OFFSET;
+    size_t n = 0;
+    p[n++] = FRAME_SYNC;
+    n += putVarint(p + n, now);
+    uint32_t base = static_cast<uint32_t>(DeferredFormat::flashBase());
+    memcpy(p + n, &base, sizeof(base));  // Little-endian on all ESP32 targets
+    n += sizeof(base);
+    p[n++] = PROTOCOL_VERSION;
+
+    // Only treat the session as synced once the decoder can have seen it
+    if (sendFrame(n)) {
+        synced_ = true;
+        lastSync_ = now;
+        lastTimestamp_ = now;
+        tagCount_ = 0;  // Re-announce tags after every sync
+    }
+}
+
+uint8_t BinarySerialBackend::tagIndex(const char* tag) {
+    // Only flash tags can be cached by pointer; RAM tags travel inline
+    if (!tag || !DeferredFormat::isInFlash(tag)) return TAG_INLINE;
+
+    for (size_t i = 0; i < tagCount_; i++) {
+        if (tags_[i] == tag) return static_cast<uint8_t>(i);
+    }
+    if (tagCount_ >= MAX_TAGS) return TAG_INLINE;
+
+    // Announce the new index before the first record that uses it
+    uint8_t* p = frame_ + PAYLOAD_OFFSET;
+    size_t nameLen = strnlen(tag, CONFIG_LOG_SUBSCRIBER_TAG_SIZE - 1);
+    p[0] = FRAME_TAG;
+    p[1] = static_cast<uint8_t>(tagCount_);
+    memcpy(p + 2, tag, nameLen);
+    if (!sendFrame(nameLen + 2)) return TAG_INLINE;
+
+    tags_[tagCount_] = tag;
+    return static_cast<uint8_t>(tagCount_++);
+}
+
+// Type, time delta, level|tag index and the inline tag if it has no index
+size_t BinarySerialBackend::putRecordHeader(uint8_t* p, uint8_t type, esp_log_level_t level, const char* tag,
+                                            uint32_t now) {
+    uint8_t index = synced_ ? tagIndex(tag) : TAG_INLINE;
+
+    size_t n = 0;
+    p[n++] = type;
+    n += putVarint(p + n, now - lastTimestamp_);
+    p[n++] = static_cast<uint8_t>((static_cast<uint8_t>(level) & 0x07) << 5) | index;
+
+    if (index == TAG_INLINE) {
+        size_t tagLen = tag ? strnlen(tag, CONFIG_LOG_SUBSCRIBER_TAG_SIZE - 1) : 0;
+        p[n++] = static_cast<uint8_t>(tagLen);
+        if (tagLen) memcpy(p + n, tag, tagLen);
+        n += tagLen;
+    }
+    return n;
+}
+
+void BinarySerialBackend::writeUnformatted(esp_log_level_t level, const char* tag, const char* format, va_list args) {
+    if (!lock()) return;
+
+    uint32_t now = LogPlatform::millis();
+    syncIfDue(now);
+
+    uint8_t* p = frame_ + PAYLOAD_OFFSET;
+    size_t n = putRecordHeader(p, FRAME_LOG, level, tag, now);
+
+    n += putVarint(p + n, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(format) - DeferredFormat::flashBase()));
+
+    // Arguments that do not fit are dropped; the decoder prints "<?>" for them
+    bool truncated;
+    n += DeferredFormat::encodeWire(format, args, p + n, MAX_PAYLOAD - n, truncated);
+
+    if (sendFrame(n)) {
+        lastTimestamp_ = now;
+    }
+    unlock();
+}
+
+bool BinarySerialBackend::writeBytes(esp_log_level_t level, const char* tag, const char* label,
+                                     const uint8_t* data, size_t length) {
+    if (!lock()) return true;  // Counted as a dropped frame
+
+    uint32_t now = LogPlatform::millis();
+    syncIfDue(now);
+
+    // Frames are consecutive under the lock, so chunks cannot interleave
+    size_t labelLen = label ? strnlen(label, CONFIG_LOG_SUBSCRIBER_TAG_SIZE - 1) : 0;
+    size_t offset = 0;
+    do {
+        uint8_t* p = frame_ + PAYLOAD_OFFSET;
+        size_t n = putRecordHeader(p, FRAME_HEX, level, tag, now);
+        p[n++] = static_cast<uint8_t>(labelLen);
+        if (labelLen) memcpy(p + n, label, labelLen);
+        n += labelLen;
+        n += putVarint(p + n, static_cast<uint32_t>(length));
+        n += putVarint(p + n, static_cast<uint32_t>(offset));
+
+        size_t chunk = std::min(length - offset, MAX_PAYLOAD - n);
+        memcpy(p + n, data + offset, chunk);
+        if (sendFrame(n + chunk)) lastTimestamp_ = now;
+        offset += chunk;
+    } while (offset < length);
+
+    unlock();
+    return true;
+}
+
+bool BinarySerialBackend::writeFields(esp_log_level_t level, const char* tag, const char* message,
+                                      const uint8_t* fields, size_t length) {
+    if (!lock()) return true;  // Counted as a dropped frame
+
+    uint32_t now = LogPlatform::millis();
+    syncIfDue(now);
+
+    uint8_t* p = frame_ + PAYLOAD_OFFSET;
+    size_t n = putRecordHeader(p, FRAME_FIELDS, level, tag, now);
+    size_t messageLen = message ? strnlen(message, MAX_PAYLOAD) : 0;
+
+    // Never split: an event too big for one frame goes out as text
+    if (n + 1 + messageLen + length > MAX_PAYLOAD) {
+        unlock();
+        return false;
+    }
+    p[n++] = static_cast<uint8_t>(messageLen);
+    if (messageLen) memcpy(p + n, message, messageLen);
+    n += messageLen;
+    if (length) memcpy(p + n, fields, length);
+    n += length;
+
+    if (sendFrame(n)) lastTimestamp_ = now;
+    unlock();
+    return true;
+}
+
+void BinarySerialBackend::write(const char* logMessage, size_t length) {
+    if (!logMessage || length == 0) return;
+    if (!lock()) return;
+
+    uint8_t* p = frame_ + PAYLOAD_OFFSET;
+    if (length > MAX_PAYLOAD - 1) length = MAX_PAYLOAD - 1;
+    p[0] = FRAME_TEXT;
+    memcpy(p + 1, logMessage, length);
+    sendFrame(length + 1);
+    unlock();
+}
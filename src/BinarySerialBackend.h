@@ -0,0 +1,163 @@
+/*
+ * BinarySerialBackend.h - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// BinarySerialBackend.h
+// Compact binary log records over Serial, decoded on the host (tools/log_decode.py)
+#pragma once
+
+#include "ILogBackend.h"
+#include "LoggerConfig.h"
+#include "LogPlatform.h"
+#include <atomic>
+
+#ifndef CONFIG_LOG_BINARY_SYNC_INTERVAL_MS
+#define CONFIG_LOG_BINARY_SYNC_INTERVAL_MS 2000  // Resend absolute time + tag table
+#endif
+
+/**
+ * @brief Backend that writes binary records instead of text
+ *
+ * log() calls with a flash-resident format reach writeUnformatted() before
+ * any formatting happens. They are encoded as a frame:
+ *
+ *   0xA5 | len | payload[len] | crc8(len, payload)
+ *
+ * Payload types:
+ * - SYNC: absolute millis() (varint), flash base address (u32 LE), version
+ * - TAG:  tag index, tag name - announces an index used by LOG frames
+ * - LOG:  millis() delta (varint), level:3|tagIndex:5, format offset from the
+ *         flash base (varint), arguments (DeferredFormat::encodeWire)
+ * - TEXT: preformatted text for calls that could not be encoded
+ * - HEX:  millis() delta, level|tagIndex, label length + label, total length
+ *         and offset (varints), raw bytes - Logger::logHex() payloads, split
+ *         over several frames when longer than one
+ * - FIELDS: millis() delta, level|tagIndex, message length + message, then
+ *         the Logger::event() fields as encoded (LogFields.h); events that
+ *         do not fit one frame arrive as TEXT
+ *
+ * The host decoder reads the firmware ELF to recover format strings from
+ * their offsets, so a typical record is 4-10 bytes instead of 40-80.
+ * SYNC is repeated every CONFIG_LOG_BINARY_SYNC_INTERVAL_MS and re-announces
+ * tags, so a decoder attached mid-stream recovers quickly.
+ *
+ * Thread safety: the Logger calls backends concurrently, so frame assembly
+ * and the tag table are guarded by an internal mutex; a frame that cannot
+ * get it within LoggerConfig::MUTEX_SHORT_TIMEOUT_MS is dropped and counted.
+ * Non-blocking by default: frames that do not fit in the UART buffer are
+ * dropped whole (never split) and counted.
+ *
+ * Usage:
+ *   logger.setBackend(std::make_shared<BinarySerialBackend>());
+ *   // host: python3 tools/log_decode.py firmware.elf --port /dev/ttyUSB0
+ */
+class BinarySerialBackend : public ILogBackend {
+public:
+    static constexpr uint8_t FRAME_START = 0xA5;
+    static constexpr uint8_t PROTOCOL_VERSION = 1;
+    static constexpr size_t MAX_PAYLOAD = 255;
+    static constexpr uint8_t TAG_INLINE = 0x1F;     // Tag index escape: name follows inline
+    static constexpr size_t MAX_TAGS = TAG_INLINE;  // Announced tag slots per sync period
+
+    enum FrameType : uint8_t {
+        FRAME_SYNC = 0x01,
+        FRAME_TAG = 0x02,
+        FRAME_LOG = 0x03,
+        FRAME_TEXT = 0x04,
+        FRAME_HEX = 0x05,
+        FRAME_FIELDS = 0x06
+    };
+
+    /**
+     * @param blocking true = wait for UART space (no drops), false = drop whole frames
+     */
+    explicit BinarySerialBackend(bool blocking = false)
+        : blocking_(blocking), mutex_(LogPlatform::createMutex()) {}
+
+    ~BinarySerialBackend() override {
+        if (mutex_) LogPlatform::deleteMutex(mutex_);
+    }
+
+    BinarySerialBackend(const BinarySerialBackend&) = delete;
+    BinarySerialBackend& operator=(const BinarySerialBackend&) = delete;
+
+    bool acceptsUnformatted() const override { return true; }
+    void writeUnformatted(esp_log_level_t level, const char* tag, const char* format, va_list args) override;
+    bool writeBytes(esp_log_level_t level, const char* tag, const char* label,
+                    const uint8_t* data, size_t length) override;
+    bool writeFields(esp_log_level_t level, const char* tag, const char* message,
+                     const uint8_t* fields, size_t length) override;
+
+    // Preformatted messages (RAM formats, logDirect, ...) become TEXT frames
+    void write(const std::string& logMessage) override {
+        write(logMessage.c_str(), logMessage.length());
+    }
+    void write(const char* logMessage, size_t length) override;
+
+    void flush() override {
+        // Only block on the UART if the caller opted into blocking writes
+        if (blocking_) LogPlatform::consoleFlush();
+    }
+
+    /**
+     * @brief Force a SYNC frame (and tag re-announcement) with the next record
+     */
+    void resync() { resyncRequested_.store(true); }
+
+    // Statistics getters
+    uint32_t getFramesWritten() const { return framesWritten_.load(std::memory_order_relaxed); }
+    uint32_t getDroppedFrames() const { return droppedFrames_.load(std::memory_order_relaxed); }
+    uint32_t getBytesWritten() const { return bytesWritten_.load(std::memory_order_relaxed); }
+    uint32_t getDroppedMessages() const override { return getDroppedFrames(); }
+
+    void resetStats() {
+        framesWritten_.store(0);
+        droppedFrames_.store(0);
+        bytesWritten_.store(0);
+    }
+
+    // CRC-8 (poly 0x07, init 0) over the length byte and payload
+    static uint8_t crc8(const uint8_t* data, size_t length, uint8_t crc = 0);
+
+private:
+    void syncIfDue(uint32_t now);
+    uint8_t tagIndex(const char* tag);
+    size_t putRecordHeader(uint8_t* p, uint8_t type, esp_log_level_t level, const char* tag, uint32_t now);
+    bool sendFrame(size_t payloadLength);
+    bool lock();
+    void unlock();
+
+    bool blocking_;
+    LogPlatform::MutexHandle mutex_;
+    std::atomic<bool> resyncRequested_{false};
+    bool synced_ = false;
+    uint32_t lastSync_ = 0;
+    uint32_t lastTimestamp_ = 0;
+
+    const char* tags_[MAX_TAGS] = {};
+    size_t tagCount_ = 0;
+
+    // Encode buffer: start byte, length byte, payload, crc
+    uint8_t frame_[MAX_PAYLOAD + 3];
+
+    std::atomic<uint32_t> framesWritten_{0};
+    std::atomic<uint32_t> droppedFrames_{0};
+    std::atomic<uint32_t> bytesWritten_{0};
+};
@@ -22,13 +22,13 @@
 // ConsoleBackend.h
 #pragma once
 #include "ILogBackend.h"
-#include <Arduino.h>
+#include "LogPlatform.h"
 
 class ConsoleBackend : public ILogBackend {
 public:
     void write(const std::string& logMessage) override {
-        // Use Serial for ESP32/Arduino compatibility
-        Serial.print(logMessage.c_str());
+        // Serial on the ESP32 (LogPlatform.h)
+        LogPlatform::consoleWrite(logMessage.c_str(), logMessage.length());
         // Note: newline is already included in the formatted message
     }
     
@@ -37,12 +37,12 @@ public:
         // This correctly handles messages that may not be null-terminated
         // or contain embedded nulls
         if (logMessage && length > 0) {
-            Serial.write((const uint8_t*)logMessage, length);
+            LogPlatform::consoleWrite(logMessage, length);
         }
     }
     
     void flush() override {
         // Flush the serial buffer to ensure immediate output
-        Serial.flush();
+        LogPlatform::consoleFlush();
     }
 };
\ No newline at end of file
@@ -0,0 +1,610 @@
+/*
+ * DeferredFormat.cpp - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// DeferredFormat.cpp
+#include "DeferredFormat.h"
+#include <cstdio>
+#include <cstring>
+
+#if defined(LOG_PLATFORM_NATIVE)
+// GNU ld / glibc: read-only data (string literals) sits between these
+extern "C" char etext, __data_start;
+#endif
+
+static_assert(CONFIG_LOG_DEFERRED_STRING_MAX <= 255, "CONFIG_LOG_DEFERRED_STRING_MAX must fit in one length byte");
+
+namespace {
+
+enum class ArgClass : uint8_t { None, Int, Int64, Double, Pointer, String, Count };
+enum class LengthMod : uint8_t { None, HH, H, L, LL, J, Z, T, LongDouble };
+
+// String argument markers
+constexpr uint8_t STR_POINTER = 0xFF;  // Followed by a flash pointer
+constexpr uint8_t STR_INLINE = 0x00;   // Followed by a length byte and the bytes
+
+// Longest conversion spec we re-emit, e.g. "%-+#012.34llx"
+constexpr size_t MAX_SPEC_LENGTH = 24;
+
+struct Spec {
+    const char* begin;          // '%'
+    size_t length;              // Through the conversion character
+    char conversion;
+    LengthMod lengthMod;
+    bool starWidth;
+    bool starPrecision;
+    int precision;              // -1 if none given as digits
+    ArgClass argClass;
+    bool tooLong;               // Valid, but too long to re-emit: rendered as "<?>"
+};
+
+size_t integerSize(LengthMod mod) {
+    switch (mod) {
+        case LengthMod::L:  return sizeof(long);
+        case LengthMod::LL: return sizeof(long long);
+        case LengthMod::J:  return sizeof(intmax_t);
+        case LengthMod::Z:  return sizeof(size_t);
+        case LengthMod::T:  return sizeof(ptrdiff_t);
+        default:            return sizeof(int);
+    }
+}
+
+// Parse the spec starting at '%'. Returns false for "%%" and unknown specs,
+// which are emitted as literal text. A valid spec of MAX_SPEC_LENGTH or more
+// still consumes its argument (tooLong), so the ones after it stay aligned.
+bool parseSpec(const char* p, Spec& spec) {
+    spec.begin = p++;
+    spec.starWidth = false;
+    spec.starPrecision = false;
+    spec.precision = -1;
+    spec.lengthMod = LengthMod::None;
+
+    while (*p && strchr("-+ #0'", *p)) p++;
+    if (*p == '*') { spec.starWidth = true; p++; }
+    while (*p >= '0' && *p <= '9') p++;
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec.starPrecision = true;
+            p++;
+        } else {
+            spec.precision = 0;
+            while (*p >= '0' && *p <= '9') spec.precision = spec.precision * 10 + (*p++ - '0');
+        }
+    }
+
+    switch (*p) {
+        case 'h': p++; spec.lengthMod = (*p == 'h') ? (p++, LengthMod::HH) : LengthMod::H; break;
+        case 'l': p++; spec.lengthMod = (*p == 'l') ? (p++, LengthMod::LL) : LengthMod::L; break;
+        case 'j': p++; spec.lengthMod = LengthMod::J; break;
+        case 'z': p++; spec.lengthMod = LengthMod::Z; break;
+        case 't': p++; spec.lengthMod = LengthMod::T; break;
+        case 'L': p++; spec.lengthMod = LengthMod::LongDouble; break;
+        default: break;
+    }
+
+    spec.conversion = *p;
+    switch (*p) {
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+            spec.argClass = integerSize(spec.lengthMod) > 4 ? ArgClass::Int64 : ArgClass::Int;
+            break;
+        case 'c':
+            spec.argClass = ArgClass::Int;
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            spec.argClass = ArgClass::Double;
+            break;
+        case 'p':
+            spec.argClass = ArgClass::Pointer;
+            break;
+        case 's':
+            spec.argClass = ArgClass::String;
+            break;
+        case 'n':
+            spec.argClass = ArgClass::Count;
+            break;
+        default:
+            return false;
+    }
+
+    spec.length = static_cast<size_t>(p - spec.begin) + 1;
+    spec.tooLong = spec.length >= MAX_SPEC_LENGTH;
+    return true;
+}
+
+bool isSignedConversion(char conversion) {
+    return conversion == 'd' || conversion == 'i';
+}
+
+// Bounded byte writer / reader
+struct Writer {
+    uint8_t* out;
+    size_t size;
+    size_t pos;
+
+    bool put(const void* data, size_t n) {
+        if (size - pos < n) return false;
+        if (out) memcpy(out + pos, data, n);
+        pos += n;
+        return true;
+    }
+};
+
+// LEB128 varint / zig-zag helpers for the wire encoding
+bool putVarint(Writer& writer, uint64_t v) {
+    uint8_t bytes[10];
+    size_t n = 0;
+    do {
+        uint8_t byte = v & 0x7F;
+        v >>= 7;
+        bytes[n++] = byte | (v ? 0x80 : 0);
+    } while (v);
+    return writer.put(bytes, n);
+}
+
+uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+struct Reader {
+    const uint8_t* in;
+    size_t size;
+    size_t pos;
+
+    bool get(void* data, size_t n) {
+        if (size - pos < n) return false;
+        memcpy(data, in + pos, n);
+        pos += n;
+        return true;
+    }
+
+    bool skip(size_t n) {
+        if (size - pos < n) return false;
+        pos += n;
+        return true;
+    }
+};
+
+// Step over one argument as pack() wrote it
+bool skipPacked(Reader& reader, const Spec& spec) {
+    switch (spec.argClass) {
+        case ArgClass::Int:     return reader.skip(sizeof(uint32_t));
+        case ArgClass::Int64:   return reader.skip(sizeof(uint64_t));
+        case ArgClass::Double:  return reader.skip(sizeof(double));
+        case ArgClass::Pointer: return reader.skip(sizeof(void*));
+        case ArgClass::String: {
+            uint8_t marker;
+            if (!reader.get(&marker, 1)) return false;
+            if (marker == STR_POINTER) return reader.skip(sizeof(const char*));
+            uint8_t len;
+            return reader.get(&len, 1) && reader.skip(len);
+        }
+        default:
+            return true;
+    }
+}
+
+// Pull one integer argument with the type the length modifier implies
+uint64_t readInteger(va_list& args, const Spec& spec) {
+    bool isSigned = isSignedConversion(spec.conversion);
+    switch (spec.lengthMod) {
+        case LengthMod::L:
+            return isSigned ? static_cast<uint64_t>(va_arg(args, long)) : va_arg(args, unsigned long);
+        case LengthMod::LL:
+            return isSigned ? static_cast<uint64_t>(va_arg(args, long long)) : va_arg(args, unsigned long long);
+        case LengthMod::J:
+            return isSigned ? static_cast<uint64_t>(va_arg(args, intmax_t)) : va_arg(args, uintmax_t);
+        case LengthMod::Z:
+            return va_arg(args, size_t);
+        case LengthMod::T:
+            return static_cast<uint64_t>(va_arg(args, ptrdiff_t));
+        default:
+            // char/short are promoted to int
+            return isSigned ? static_cast<uint64_t>(va_arg(args, int)) : va_arg(args, unsigned int);
+    }
+}
+
+// snprintf with the '*' arguments the spec asked for
+template <typename T>
+int emit(char* out, size_t size, const char* fmt, const Spec& spec, int width, int precision, T value) {
+    if (spec.starWidth && spec.starPrecision) return snprintf(out, size, fmt, width, precision, value);
+    if (spec.starWidth) return snprintf(out, size, fmt, width, value);
+    if (spec.starPrecision) return snprintf(out, size, fmt, precision, value);
+    return snprintf(out, size, fmt, value);
+}
+
+// Re-emit an integer with its original C type so the length modifier matches
+int emitInteger(char* out, size_t size, const char* fmt, const Spec& spec, int width, int precision, uint64_t v) {
+    bool isSigned = isSignedConversion(spec.conversion);
+    switch (spec.lengthMod) {
+        case LengthMod::L:
+            return isSigned ? emit(out, size, fmt, spec, width, precision, static_cast<long>(v))
+                            : emit(out, size, fmt, spec, width, precision, static_cast<unsigned long>(v));
+        case LengthMod::LL:
+            return isSigned ? emit(out, size, fmt, spec, width, precision, static_cast<long long>(v))
+                            : emit(out, size, fmt, spec, width, precision, static_cast<unsigned long long>(v));
+        case LengthMod::J:
+            return isSigned ? emit(out, size, fmt, spec, width, precision, static_cast<intmax_t>(v))
+                            : emit(out, size, fmt, spec, width, precision, static_cast<uintmax_t>(v));
+        case LengthMod::Z:
+            return emit(out, size, fmt, spec, width, precision, static_cast<size_t>(v));
+        case LengthMod::T:
+            return emit(out, size, fmt, spec, width, precision, static_cast<ptrdiff_t>(v));
+        default:
+            return isSigned ? emit(out, size, fmt, spec, width, precision, static_cast<int>(v))
+                            : emit(out, size, fmt, spec, width, precision, static_cast<unsigned int>(v));
+    }
+}
+
+}  // namespace
+
+bool DeferredFormat::isInFlash(const void* ptr) {
+    if (!ptr) return false;
+    uintptr_t addr = (uintptr_t)ptr;
+
+#if CONFIG_IDF_TARGET_ESP32
+    // ESP32 DROM (flash-mapped data): 0x3F400000 - 0x3F7FFFFF
+    return (addr >= 0x3F400000 && addr < 0x3F800000);
+
+#elif CONFIG_IDF_TARGET_ESP32S2
+    // ESP32-S2 DROM: 0x3F000000 - 0x3FF7FFFF
+    return (addr >= 0x3F000000 && addr < 0x3FF80000);
+
+#elif CONFIG_IDF_TARGET_ESP32S3
+    // ESP32-S3 DROM: 0x3C000000 - 0x3DFFFFFF
+    return (addr >= 0x3C000000 && addr < 0x3E000000);
+
+#elif CONFIG_IDF_TARGET_ESP32C3
+    // ESP32-C3 DROM: 0x3C000000 - 0x3C7FFFFF
+    return (addr >= 0x3C000000 && addr < 0x3C800000);
+
+#elif CONFIG_IDF_TARGET_ESP32C6
+    // ESP32-C6 flash is mapped at 0x42000000 - 0x42FFFFFF (shared I/D)
+    return (addr >= 0x42000000 && addr < 0x43000000);
+
+#elif defined(LOG_PLATFORM_NATIVE)
+    // Host: .rodata stands in for flash, so deferral runs as on the device
+    return addr >= reinterpret_cast<uintptr_t>(&etext) && addr < reinterpret_cast<uintptr_t>(&__data_start);
+
+#else
+    // Unknown target: never defer, always format immediately
+    (void)addr;
+    return false;
+#endif
+}
+
+uintptr_t DeferredFormat::flashBase() {
+#if CONFIG_IDF_TARGET_ESP32
+    return 0x3F400000;
+#elif CONFIG_IDF_TARGET_ESP32S2
+    return 0x3F000000;
+#elif CONFIG_IDF_TARGET_ESP32S3 || CONFIG_IDF_TARGET_ESP32C3
+    return 0x3C000000;
+#elif CONFIG_IDF_TARGET_ESP32C6
+    return 0x42000000;
+#elif defined(LOG_PLATFORM_NATIVE)
+    return reinterpret_cast<uintptr_t>(&etext);
+#else
+    return 0;
+#endif
+}
+
+size_t DeferredFormat::pack(const char* format, va_list args, uint8_t* out, size_t outSize, bool& truncated) {
+    Writer writer = {out, out ? outSize : SIZE_MAX, 0};
+    truncated = false;
+    if (!format) return 0;
+
+    va_list ap;
+    va_copy(ap, args);
+
+    for (const char* p = format; *p; p++) {
+        if (*p != '%') continue;
+        if (p[1] == '%') { p++; continue; }
+
+        Spec spec;
+        if (!parseSpec(p, spec)) continue;
+        p += spec.length - 1;
+
+        bool ok = true;
+        int precision = spec.precision;
+        if (spec.starWidth) {
+            int width = va_arg(ap, int);
+            ok = writer.put(&width, sizeof(width));
+        }
+        if (ok && spec.starPrecision) {
+            precision = va_arg(ap, int);
+            ok = writer.put(&precision, sizeof(precision));
+        }
+
+        if (ok) {
+            switch (spec.argClass) {
+                case ArgClass::Int: {
+                    uint32_t v = static_cast<uint32_t>(readInteger(ap, spec));
+                    ok = writer.put(&v, sizeof(v));
+                    break;
+                }
+                case ArgClass::Int64: {
+                    uint64_t v = readInteger(ap, spec);
+                    ok = writer.put(&v, sizeof(v));
+                    break;
+                }
+                case ArgClass::Double: {
+                    double v = (spec.lengthMod == LengthMod::LongDouble)
+                        ? static_cast<double>(va_arg(ap, long double))
+                        : va_arg(ap, double);
+                    ok = writer.put(&v, sizeof(v));
+                    break;
+                }
+                case ArgClass::Pointer: {
+                    void* v = va_arg(ap, void*);
+                    ok = writer.put(&v, sizeof(v));
+                    break;
+                }
+                case ArgClass::String: {
+                    const char* s = va_arg(ap, const char*);
+                    if (!s || isInFlash(s)) {
+                        // Flash strings outlive the record - keep the pointer
+                        ok = writer.put(&STR_POINTER, 1) && writer.put(&s, sizeof(s));
+                    } else {
+                        // RAM string: copy now, honouring the precision limit
+                        size_t limit = CONFIG_LOG_DEFERRED_STRING_MAX;
+                        if (precision >= 0 && static_cast<size_t>(precision) < limit) limit = precision;
+                        size_t len = strnlen(s, limit);
+                        if (writer.size - writer.pos < 2 + len) {
+                            len = (writer.size - writer.pos > 2) ? writer.size - writer.pos - 2 : 0;
+                        }
+                        uint8_t len8 = static_cast<uint8_t>(len);
+                        ok = writer.put(&STR_INLINE, 1) && writer.put(&len8, 1) && writer.put(s, len);
+                    }
+                    break;
+                }
+                case ArgClass::Count:
+                    (void)va_arg(ap, int*);  // %n: never written through
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        if (!ok) {
+            truncated = true;
+            break;
+        }
+    }
+
+    va_end(ap);
+    return writer.pos;
+}
+
+size_t DeferredFormat::encodeWire(const char* format, va_list args, uint8_t* out, size_t outSize, bool& truncated) {
+    Writer writer = {out, out ? outSize : SIZE_MAX, 0};
+    truncated = false;
+    if (!format) return 0;
+
+    const uintptr_t base = flashBase();
+    va_list ap;
+    va_copy(ap, args);
+
+    for (const char* p = format; *p; p++) {
+        if (*p != '%') continue;
+        if (p[1] == '%') { p++; continue; }
+
+        Spec spec;
+        if (!parseSpec(p, spec)) continue;
+        p += spec.length - 1;
+
+        bool ok = true;
+        int precision = spec.precision;
+        if (spec.starWidth) {
+            ok = putVarint(writer, zigzag(va_arg(ap, int)));
+        }
+        if (ok && spec.starPrecision) {
+            precision = va_arg(ap, int);
+            ok = putVarint(writer, zigzag(precision));
+        }
+
+        if (ok) {
+            switch (spec.argClass) {
+                case ArgClass::Int:
+                case ArgClass::Int64: {
+                    uint64_t v = readInteger(ap, spec);
+                    if (isSignedConversion(spec.conversion)) {
+                        // Sign-extend 32-bit values so small negatives stay short
+                        int64_t sv = (spec.argClass == ArgClass::Int)
+                            ? static_cast<int32_t>(v) : static_cast<int64_t>(v);
+                        ok = putVarint(writer, zigzag(sv));
+                    } else {
+                        ok = putVarint(writer, spec.argClass == ArgClass::Int ? static_cast<uint32_t>(v) : v);
+                    }
+                    break;
+                }
+                case ArgClass::Double: {
+                    double v = (spec.lengthMod == LengthMod::LongDouble)
+                        ? static_cast<double>(va_arg(ap, long double))
+                        : va_arg(ap, double);
+                    ok = writer.put(&v, sizeof(v));
+                    break;
+                }
+                case ArgClass::Pointer:
+                    ok = putVarint(writer, reinterpret_cast<uintptr_t>(va_arg(ap, void*)));
+                    break;
+                case ArgClass::String: {
+                    const char* s = va_arg(ap, const char*);
+                    if (!s) s = "(null)";
+                    if (isInFlash(s)) {
+                        // Odd: flash offset, resolved from the ELF by the decoder
+                        ok = putVarint(writer, ((reinterpret_cast<uintptr_t>(s) - base) << 1) | 1);
+                    } else {
+                        // Even: length, followed by the bytes
+                        size_t limit = CONFIG_LOG_DEFERRED_STRING_MAX;
+                        if (precision >= 0 && static_cast<size_t>(precision) < limit) limit = precision;
+                        size_t len = strnlen(s, limit);
+                        ok = putVarint(writer, len << 1) && writer.put(s, len);
+                    }
+                    break;
+                }
+                case ArgClass::Count:
+                    (void)va_arg(ap, int*);  // %n: never written through
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        if (!ok) {
+            truncated = true;
+            break;
+        }
+    }
+
+    va_end(ap);
+    return writer.pos;
+}
+
+size_t DeferredFormat::render(const char* format, const uint8_t* packed, size_t packedLen,
+                              char* out, size_t outSize) {
+    if (!out || outSize == 0) return 0;
+    out[0] = '\0';
+    if (!format) return 0;
+
+    Reader reader = {packed, packedLen, 0};
+    size_t pos = 0;
+    const size_t limit = outSize - 1;
+
+    for (const char* p = format; *p && pos < limit; p++) {
+        if (*p != '%') {
+            out[pos++] = *p;
+            continue;
+        }
+        if (p[1] == '%') {
+            out[pos++] = '%';
+            p++;
+            continue;
+        }
+
+        Spec spec;
+        if (!parseSpec(p, spec)) {
+            out[pos++] = *p;  // Unknown spec - print literally, like newlib
+            continue;
+        }
+        p += spec.length - 1;
+        if (spec.argClass == ArgClass::Count) continue;
+
+        if (spec.tooLong) {
+            // No room to re-emit it: placeholder, but keep later arguments in step
+            int word;
+            if ((!spec.starWidth || reader.get(&word, sizeof(word))) &&
+                (!spec.starPrecision || reader.get(&word, sizeof(word)))) {
+                skipPacked(reader, spec);
+            }
+            int written = snprintf(out + pos, outSize - pos, "<?>");
+            if (written > 0) {
+                pos += (static_cast<size_t>(written) < outSize - pos) ? static_cast<size_t>(written) : outSize - pos - 1;
+            }
+            continue;
+        }
+
+        // Re-emit just this spec; long double was packed as double
+        char fmt[MAX_SPEC_LENGTH];
+        size_t fmtLen = 0;
+        for (size_t i = 0; i < spec.length; i++) {
+            if (spec.begin[i] != 'L') fmt[fmtLen++] = spec.begin[i];
+        }
+        fmt[fmtLen] = '\0';
+
+        int width = 0;
+        int precision = 0;
+        bool ok = (!spec.starWidth || reader.get(&width, sizeof(width))) &&
+                  (!spec.starPrecision || reader.get(&precision, sizeof(precision)));
+
+        char* dst = out + pos;
+        size_t room = outSize - pos;
+        int written = -1;
+
+        if (ok) {
+            switch (spec.argClass) {
+                case ArgClass::Int: {
+                    uint32_t v;
+                    if ((ok = reader.get(&v, sizeof(v)))) {
+                        // Sign-extend so the 64-bit helper recovers the original int
+                        uint64_t wide = isSignedConversion(spec.conversion)
+                            ? static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(v)))
+                            : v;
+                        written = emitInteger(dst, room, fmt, spec, width, precision, wide);
+                    }
+                    break;
+                }
+                case ArgClass::Int64: {
+                    uint64_t v;
+                    if ((ok = reader.get(&v, sizeof(v)))) {
+                        written = emitInteger(dst, room, fmt, spec, width, precision, v);
+                    }
+                    break;
+                }
+                case ArgClass::Double: {
+                    double v;
+                    if ((ok = reader.get(&v, sizeof(v)))) {
+                        written = emit(dst, room, fmt, spec, width, precision, v);
+                    }
+                    break;
+                }
+                case ArgClass::Pointer: {
+                    void* v;
+                    if ((ok = reader.get(&v, sizeof(v)))) {
+                        written = emit(dst, room, fmt, spec, width, precision, v);
+                    }
+                    break;
+                }
+                case ArgClass::String: {
+                    uint8_t marker;
+                    if (!(ok = reader.get(&marker, 1))) break;
+                    if (marker == STR_POINTER) {
+                        const char* s;
+                        if ((ok = reader.get(&s, sizeof(s)))) {
+                            written = emit(dst, room, fmt, spec, width, precision, s ? s : "(null)");
+                        }
+                    } else {
+                        uint8_t len;
+                        char text[CONFIG_LOG_DEFERRED_STRING_MAX + 1];
+                        if ((ok = reader.get(&len, 1) && len <= CONFIG_LOG_DEFERRED_STRING_MAX &&
+                                  reader.get(text, len))) {
+                            text[len] = '\0';
+                            written = emit(dst, room, fmt, spec, width, precision, static_cast<const char*>(text));
+                        }
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        if (!ok) {
+            // Argument did not fit when the record was packed
+            written = snprintf(dst, room, "<?>");
+        }
+        if (written > 0) {
+            pos += (static_cast<size_t>(written) < room) ? static_cast<size_t>(written) : room - 1;
+        }
+    }
+
+    out[pos] = '\0';
+    return pos;
+}
@@ -0,0 +1,96 @@
+/*
+ * DeferredFormat.h - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// DeferredFormat.h
+// Capture printf arguments now, format them later (defmt/NanoLog style)
+
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef CONFIG_LOG_DEFERRED_STRING_MAX
+#define CONFIG_LOG_DEFERRED_STRING_MAX 48  // Max bytes copied per RAM-resident %s argument
+#endif
+
+/**
+ * @brief Packs printf arguments into bytes and renders them later
+ *
+ * pack() walks the format string once, pulls each argument with the type
+ * its conversion spec implies and appends it to a byte buffer:
+ * - integers as 4 or 8 bytes, floating point as double, %p as a pointer
+ * - %s as a pointer when the string is in flash, otherwise copied inline
+ *   (up to CONFIG_LOG_DEFERRED_STRING_MAX bytes) because RAM strings may
+ *   be gone by the time the record is rendered
+ * - %n is consumed but never written
+ *
+ * render() walks the same format string and feeds each unpacked argument to
+ * snprintf one conversion at a time, so output matches vsnprintf().
+ *
+ * The format string itself is stored by pointer - callers must check
+ * isInFlash(format) before deferring.
+ */
+class DeferredFormat {
+public:
+    /**
+     * @brief Check whether a pointer refers to flash-mapped read-only data
+     * @return true for string literals / const data in DROM; false for
+     *         DRAM, stack, heap and unknown targets
+     */
+    static bool isInFlash(const void* ptr);
+
+    /**
+     * @brief Pack the arguments for `format`
+     * @param out Destination buffer, or nullptr to only measure the packed size
+     * @param outSize Size of `out` (ignored when measuring)
+     * @param truncated Set when not every argument fit
+     * @return Number of bytes written to `out`
+     */
+    static size_t pack(const char* format, va_list args, uint8_t* out, size_t outSize, bool& truncated);
+
+    /**
+     * @brief Encode the arguments in the compact wire format (BinarySerialBackend)
+     *
+     * Integers become LEB128 varints (zig-zag for signed conversions),
+     * floating point 8-byte doubles, %p a varint address. %s is a varint
+     * tag: odd = flash offset from flashBase() << 1 | 1 (the decoder reads
+     * the string from the ELF), even = length << 1 followed by the bytes.
+     * '*' width/precision values are zig-zag varints in front of their argument.
+     *
+     * @return Number of bytes written (or needed when `out` is nullptr)
+     */
+    static size_t encodeWire(const char* format, va_list args, uint8_t* out, size_t outSize, bool& truncated);
+
+    /**
+     * @brief Start of the flash data region isInFlash() accepts (0 if unknown)
+     * @note Format IDs on the wire are offsets from this address
+     */
+    static uintptr_t flashBase();
+
+    /**
+     * @brief Render a packed record
+     * @return Length of the resulting string (clipped to outSize - 1)
+     * @note Arguments missing from a truncated record are printed as "<?>"
+     */
+    static size_t render(const char* format, const uint8_t* packed, size_t packedLen,
+                         char* out, size_t outSize);
+};
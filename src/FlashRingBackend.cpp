@@ -0,0 +1,236 @@
+/*
+ * FlashRingBackend.cpp - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+
+// FlashRingBackend.cpp
+// Needs an ESP-IDF flash partition: not part of the native build (LogPlatform.h)
+#if !defined(LOG_PLATFORM_NATIVE)
+
+#include "FlashRingBackend.h"
+#include "BinarySerialBackend.h"
+#include "LoggerConfig.h"
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <algorithm>
+#include <cstring>
+
+// Records start on word boundaries so every flash program is aligned
+static size_t align4(size_t n) {
+    return (n + 3) & ~static_cast<size_t>(3);
+}
+
+FlashRingBackend::FlashRingBackend(const Config& config)
+    : config_(config), mutex_(xSemaphoreCreateMutex()) {
+    // A batch must hold at least a short line and fit in a sector after its header
+    config_.stagingSize = std::max<size_t>(config_.stagingSize, 64);
+    config_.stagingSize = std::min<size_t>(config_.stagingSize, SECTOR_SIZE - sizeof(SectorHeader));
+    config_.stagingSize &= ~static_cast<size_t>(3);
+}
+
+FlashRingBackend::~FlashRingBackend() {
+    flush();
+    if (staging_) heap_caps_free(staging_);
+    if (mutex_) vSemaphoreDelete(mutex_);
+}
+
+bool FlashRingBackend::lock() {
+    // Pre-scheduler there is only one caller
+    if (!mutex_ || xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) return true;
+    return xSemaphoreTake(mutex_, pdMS_TO_TICKS(LoggerConfig::MUTEX_STANDARD_TIMEOUT_MS)) == pdTRUE;
+}
+
+void FlashRingBackend::unlock() {
+    if (mutex_ && xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) xSemaphoreGive(mutex_);
+}
+
+bool FlashRingBackend::begin() {
+    if (partition_) return true;
+
+    const esp_partition_t* partition =
+        esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, config_.partitionLabel);
+    if (!partition || partition->size < 2 * SECTOR_SIZE) return false;
+
+    // Flash is programmed from internal RAM
+    staging_ = static_cast<uint8_t*>(heap_caps_malloc(config_.stagingSize, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+    if (!staging_) return false;
+
+    partition_ = partition;
+    sectorCount_ = partition->size / SECTOR_SIZE;
+
+    // One header read per sector finds where the previous boot stopped
+    bool found = false;
+    uint32_t newest = 0;
+    size_t newestSector = 0;
+    for (size_t i = 0; i < sectorCount_; i++) {
+        SectorHeader header;
+        if (readSectorHeader(i, header) && (!found || static_cast<int32_t>(header.sequence - newest) > 0)) {
+            found = true;
+            newest = header.sequence;
+            newestSector = i;
+        }
+    }
+
+    // Never append to the last sector: a reset may have torn its final record
+    if (!openSector(found ? (newestSector + 1) % sectorCount_ : 0, found ? newest + 1 : 1)) {
+        partition_ = nullptr;
+        heap_caps_free(staging_);
+        staging_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool FlashRingBackend::readSectorHeader(size_t sector, SectorHeader& header) const {
+    return esp_partition_read(partition_, sector * SECTOR_SIZE, &header, sizeof(header)) == ESP_OK &&
+           header.magic == SECTOR_MAGIC;
+}
+
+bool FlashRingBackend::openSector(size_t sector, uint32_t sequence) {
+    if (esp_partition_erase_range(partition_, sector * SECTOR_SIZE, SECTOR_SIZE) != ESP_OK) return false;
+
+    SectorHeader header = {SECTOR_MAGIC, sequence};
+    if (esp_partition_write(partition_, sector * SECTOR_SIZE, &header, sizeof(header)) != ESP_OK) return false;
+
+    sector_ = sector;
+    offset_ = sizeof(header);
+    sequence_ = sequence;
+    return true;
+}
+
+bool FlashRingBackend::flushStaging() {
+    if (staged_ == 0) return true;
+
+    bool ok = esp_partition_write(partition_, sector_ * SECTOR_SIZE + offset_, staging_, staged_) == ESP_OK;
+    if (ok) {
+        flashWrites_.fetch_add(1, std::memory_order_relaxed);
+        writtenMessages_.fetch_add(stagedRecords_, std::memory_order_relaxed);
+    } else {
+        droppedMessages_.fetch_add(stagedRecords_, std::memory_order_relaxed);
+    }
+
+    // Skip the range even on failure - it may be partly programmed
+    offset_ += staged_;
+    staged_ = 0;
+    stagedRecords_ = 0;
+    return ok;
+}
+
+void FlashRingBackend::write(const char* logMessage, size_t length) {
+    if (!logMessage || length == 0) return;
+    if (!partition_ || !lock()) {
+        droppedMessages_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    length = std::min(length, config_.stagingSize - sizeof(RecordHeader));
+    size_t total = align4(sizeof(RecordHeader) + length);
+
+    // Records never span sectors; a full batch goes out before the next one starts
+    bool ok = true;
+    if (offset_ + staged_ + total > SECTOR_SIZE) {
+        flushStaging();  // A failed batch is counted there
+        ok = openSector((sector_ + 1) % sectorCount_, sequence_ + 1);
+    } else if (staged_ + total > config_.stagingSize) {
+        flushStaging();
+    }
+    if (!ok) {
+        droppedMessages_.fetch_add(1, std::memory_order_relaxed);
+        unlock();
+        return;
+    }
+
+    RecordHeader header;
+    header.length = static_cast<uint16_t>(length);
+    header.crc = BinarySerialBackend::crc8(reinterpret_cast<const uint8_t*>(logMessage), length);
+    header.marker = RECORD_MARKER;
+
+    uint8_t* p = staging_ + staged_;
+    memcpy(p, &header, sizeof(header));
+    memcpy(p + sizeof(header), logMessage, length);
+    memset(p + sizeof(header) + length, 0xFF, total - sizeof(header) - length);  // Padding stays erased
+
+    uint32_t now = millis();
+    if (staged_ == 0) stagedSince_ = now;
+    staged_ += total;
+    stagedRecords_++;
+
+    if (now - stagedSince_ >= config_.flushIntervalMs) flushStaging();
+    unlock();
+}
+
+void FlashRingBackend::flush() {
+    if (!partition_ || !lock()) return;
+    flushStaging();
+    unlock();
+}
+
+size_t FlashRingBackend::readAll(RecordCallback callback, void* context) {
+    if (!partition_ || !callback || !lock()) return 0;
+    flushStaging();
+
+    // Sectors follow the write order, so the one after the current is the oldest
+    size_t count = 0;
+    for (size_t n = 1; n <= sectorCount_; n++) {
+        size_t sector = (sector_ + n) % sectorCount_;
+        SectorHeader header;
+        if (!readSectorHeader(sector, header)) continue;
+
+        // Leftovers from before eraseAll() or another layout are out of range
+        uint32_t age = sequence_ - header.sequence;
+        if (static_cast<int32_t>(age) < 0 || age >= sectorCount_) continue;
+
+        const size_t base = sector * SECTOR_SIZE;
+        const size_t end = (sector == sector_) ? offset_ : SECTOR_SIZE;
+        size_t offset = sizeof(header);
+        while (offset + sizeof(RecordHeader) <= end) {
+            RecordHeader record;
+            if (esp_partition_read(partition_, base + offset, &record, sizeof(record)) != ESP_OK) break;
+            if (record.marker != RECORD_MARKER || record.length > config_.stagingSize - sizeof(record) ||
+                offset + sizeof(record) + record.length > end) {
+                break;  // Erased space, a torn record or a larger staging size
+            }
+
+            // The staging buffer is empty now - reuse it for the payload
+            if (esp_partition_read(partition_, base + offset + sizeof(record), staging_, record.length) == ESP_OK &&
+                BinarySerialBackend::crc8(staging_, record.length) == record.crc) {
+                callback(reinterpret_cast<const char*>(staging_), record.length, header.sequence, context);
+                count++;
+            }
+            offset += align4(sizeof(record) + record.length);
+        }
+    }
+
+    unlock();
+    return count;
+}
+
+bool FlashRingBackend::eraseAll() {
+    if (!partition_ || !lock()) return false;
+
+    droppedMessages_.fetch_add(stagedRecords_, std::memory_order_relaxed);
+    staged_ = 0;
+    stagedRecords_ = 0;
+    bool ok = esp_partition_erase_range(partition_, 0, sectorCount_ * SECTOR_SIZE) == ESP_OK && openSector(0, 1);
+    unlock();
+    return ok;
+}
+
+#endif  // !LOG_PLATFORM_NATIVE
@@ -0,0 +1,184 @@
+/*
+ * FlashRingBackend.h - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+
+// FlashRingBackend.h
+// Persistent log ring on a raw flash partition, readable after reboot
+#pragma once
+
+#include "ILogBackend.h"
+#include <esp_partition.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <atomic>
+
+#ifndef CONFIG_LOG_FLASH_STAGING_SIZE
+#define CONFIG_LOG_FLASH_STAGING_SIZE 512         // RAM batch written per flash program (bytes)
+#endif
+
+#ifndef CONFIG_LOG_FLASH_FLUSH_INTERVAL_MS
+#define CONFIG_LOG_FLASH_FLUSH_INTERVAL_MS 1000   // Checked on write: staging older than this is written
+#endif
+
+#ifndef CONFIG_LOG_FLASH_PARTITION_LABEL
+#define CONFIG_LOG_FLASH_PARTITION_LABEL "logs"
+#endif
+
+/**
+ * @brief Backend that keeps the last N KB of logs in a raw data partition
+ *
+ * Messages are staged in a small RAM buffer and programmed to flash in
+ * batches, so a record costs a memcpy and flash is written every
+ * CONFIG_LOG_FLASH_STAGING_SIZE bytes (or CONFIG_LOG_FLASH_FLUSH_INTERVAL_MS).
+ * There is no filesystem in between: the partition is a ring of 4 KB sectors.
+ *
+ * Sector:  magic (u32) | sequence (u32) | records... | 0xFF (erased)
+ * Record:  length (u16) | crc8 | 0x5A | text[length], padded to 4 bytes
+ *
+ * Records never span sectors. When a sector is full the next one is erased
+ * and stamped with sequence + 1, so sectors are reused round-robin and wear
+ * evenly. begin() finds the newest sequence with one header read per sector
+ * and starts a fresh sector, so a record torn by a reset is never appended
+ * to. readAll() walks the sectors oldest first.
+ *
+ * The flush interval is only checked when the next record arrives. Wrapped
+ * with Logger::addIsolatedBackend(), the drain task also flushes once it has
+ * been idle for ~100 ms, so the last record before a hang reaches flash;
+ * used directly, staged records (at most one batch) are lost on a crash
+ * unless flush() is called. Erasing and programming stall the flash cache
+ * for milliseconds - wrapping also means callers never wait on it.
+ *
+ * Partition table entry (sizes are multiples of 4 KB, at least two sectors):
+ *   logs, data, 0x40, , 64K
+ *
+ * Usage:
+ *   auto flashLog = std::make_shared<FlashRingBackend>();
+ *   if (flashLog->begin()) {
+ *       flashLog->readAll(printPreviousBoot, nullptr);
+ *       logger.addIsolatedBackend(flashLog);
+ *   }
+ */
+class FlashRingBackend : public ILogBackend {
+public:
+    static constexpr size_t SECTOR_SIZE = 4096;
+    static constexpr uint32_t SECTOR_MAGIC = 0x31474F4C;  // "LOG1"
+    static constexpr uint8_t RECORD_MARKER = 0x5A;
+
+    struct Config {
+        const char* partitionLabel = CONFIG_LOG_FLASH_PARTITION_LABEL;
+        size_t stagingSize = CONFIG_LOG_FLASH_STAGING_SIZE;  // Also the longest record
+        uint32_t flushIntervalMs = CONFIG_LOG_FLASH_FLUSH_INTERVAL_MS;
+    };
+
+    /**
+     * @brief Called by readAll() for every stored record, oldest first
+     * @param sequence Sequence number of the sector holding the record
+     */
+    typedef void (*RecordCallback)(const char* record, size_t length, uint32_t sequence, void* context);
+
+    FlashRingBackend() : FlashRingBackend(Config()) {}
+    explicit FlashRingBackend(const Config& config);
+    ~FlashRingBackend() override;
+
+    FlashRingBackend(const FlashRingBackend&) = delete;
+    FlashRingBackend& operator=(const FlashRingBackend&) = delete;
+
+    /**
+     * @brief Find the partition, allocate the staging buffer and open a sector
+     * @return true if the backend is ready to write
+     */
+    bool begin();
+
+    bool isReady() const { return partition_ != nullptr; }
+
+    void write(const std::string& logMessage) override {
+        write(logMessage.c_str(), logMessage.length());
+    }
+    void write(const char* logMessage, size_t length) override;
+
+    /**
+     * @brief Program staged records to flash now
+     */
+    void flush() override;
+
+    /**
+     * @brief Read every stored record, oldest first (previous boots included)
+     * @return Number of records passed to the callback
+     * @note Flushes first and reuses the staging buffer, so writes wait meanwhile.
+     *       Call it before the backend is added to the Logger: records logged
+     *       from the callback would be dropped.
+     */
+    size_t readAll(RecordCallback callback, void* context);
+
+    /**
+     * @brief Erase the whole partition and start again at sequence 1
+     */
+    bool eraseAll();
+
+    // Statistics getters
+    uint32_t getWrittenMessages() const { return writtenMessages_.load(std::memory_order_relaxed); }
+    uint32_t getDroppedMessages() const override { return droppedMessages_.load(std::memory_order_relaxed); }
+    uint32_t getFlashWrites() const { return flashWrites_.load(std::memory_order_relaxed); }
+    uint32_t getSequence() const { return sequence_; }  // Sequence of the sector being written
+
+    void resetStats() {
+        writtenMessages_.store(0);
+        droppedMessages_.store(0);
+        flashWrites_.store(0);
+    }
+
+private:
+    struct SectorHeader {
+        uint32_t magic;
+        uint32_t sequence;
+    };
+
+    struct RecordHeader {
+        uint16_t length;
+        uint8_t crc;
+        uint8_t marker;
+    };
+
+    bool lock();
+    void unlock();
+    bool flushStaging();
+    bool openSector(size_t sector, uint32_t sequence);
+    bool readSectorHeader(size_t sector, SectorHeader& header) const;
+
+    Config config_;
+    SemaphoreHandle_t mutex_;
+    const esp_partition_t* partition_ = nullptr;
+    size_t sectorCount_ = 0;
+
+    // Write position: sector index, byte offset in it, its sequence number
+    size_t sector_ = 0;
+    size_t offset_ = 0;
+    uint32_t sequence_ = 0;
+
+    uint8_t* staging_ = nullptr;
+    size_t staged_ = 0;
+    uint32_t stagedRecords_ = 0;
+    uint32_t stagedSince_ = 0;  // millis() of the oldest staged record
+
+    std::atomic<uint32_t> writtenMessages_{0};
+    std::atomic<uint32_t> droppedMessages_{0};
+    std::atomic<uint32_t> flashWrites_{0};
+};
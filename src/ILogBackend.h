@@ -22,8 +22,30 @@
 // ILogBackend.h
 #pragma once
 
+#include <esp_log.h>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
+// One formatted message inside a batch (see writeBatch())
+struct LogRecordView {
+    const char* data;
+    size_t length;
+};
+
+// Queue statistics of backends that buffer messages (see getQueueStats())
+struct BackendQueueStats {
+    size_t queuedBytes;    // Bytes waiting for the sink right now
+    size_t highWaterMark;  // Most bytes ever waiting
+    size_t capacity;       // Queue size in bytes
+    uint32_t written;      // Messages handed to the sink
+    uint32_t dropped;      // Messages lost because the queue was full
+};
+
+// Backends must be thread-safe: the Logger calls write()/writeUnformatted()
+// from every logging task concurrently and does not hold a lock around them.
+// A backend may still receive a call shortly after it was removed.
 class ILogBackend {
 public:
     virtual ~ILogBackend() {}
@@ -32,5 +54,53 @@ public:
     virtual void write(const char* logMessage, size_t length) = 0;
     // Flush any buffered output
     virtual void flush() = 0;
+
+    // Optional: several messages in one call, in order. Drain tasks
+    // (AsyncRingBackend) hand over what they have queued; override to
+    // coalesce them into one packet or file write. Views are only valid
+    // for the duration of the call.
+    virtual void writeBatch(const LogRecordView* records, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            write(records[i].data, records[i].length);
+        }
+    }
+
+    // Optional: take log() calls before formatting (binary encoders).
+    // Queried when the backend is added to the Logger.
+    virtual bool acceptsUnformatted() const { return false; }
+
+    // Called instead of write() when acceptsUnformatted() is true and the
+    // format string is in flash; `args` must be va_copy'd before use.
+    // Messages that cannot take this path still arrive through write().
+    virtual void writeUnformatted(esp_log_level_t level, const char* tag, const char* format, va_list args) {
+        (void)level; (void)tag; (void)format; (void)args;
+    }
+
+    // Optional, for acceptsUnformatted() backends: Logger::logHex() payloads
+    // as raw bytes. Return false to get the hex text through write() instead.
+    virtual bool writeBytes(esp_log_level_t level, const char* tag, const char* label,
+                            const uint8_t* data, size_t length) {
+        (void)level; (void)tag; (void)label; (void)data; (void)length;
+        return false;
+    }
+
+    // Optional: Logger::event() fields, typed (LogFields.h encoding; message
+    // may be nullptr). Offered to every backend; return false to get the
+    // "message key=value" text line through write() instead.
+    virtual bool writeFields(esp_log_level_t level, const char* tag, const char* message,
+                             const uint8_t* fields, size_t length) {
+        (void)level; (void)tag; (void)message; (void)fields; (void)length;
+        return false;
+    }
+
+    // Optional: queueing backends report depth and drops here
+    virtual bool getQueueStats(BackendQueueStats& stats) const {
+        (void)stats;
+        return false;
+    }
+
+    // Optional: messages this backend lost (queue or device full). The
+    // Logger's adaptive throttle watches it for backpressure.
+    virtual uint32_t getDroppedMessages() const { return 0; }
 };
 
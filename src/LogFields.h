@@ -0,0 +1,330 @@
+/*
+ * LogFields.h - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// LogFields.h
+// Typed key/value fields of Logger::event(): binary encoding, reader and
+// text / JSON renderers. C++11, no dependency on Logger.h
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "LogFormat.h"
+
+/**
+ * Encoding, one field after the other with no header or padding:
+ *
+ *   type:1 | keyLength:1 | key | value
+ *
+ * Values are little-endian (the ESP32's byte order): INT32 / UINT32 /
+ * FLOAT32 4 bytes, INT64 / UINT64 / FLOAT64 8, BOOL 1, STRING a length byte
+ * and the bytes (no NUL). Keys and strings are cut at 255 bytes.
+ *
+ * The same bytes go to ILogBackend::writeFields(), into subscriber records
+ * (LogSubscriberEntryView::fields) and into BinarySerialBackend FIELDS
+ * frames, so nothing is re-encoded on the way.
+ */
+namespace LogFields {
+
+enum class Type : uint8_t {
+    INT32 = 1,
+    UINT32 = 2,
+    INT64 = 3,
+    UINT64 = 4,
+    FLOAT32 = 5,
+    FLOAT64 = 6,
+    BOOL = 7,
+    STRING = 8
+};
+
+inline size_t valueSize(Type type) {
+    switch (type) {
+        case Type::INT32:
+        case Type::UINT32:
+        case Type::FLOAT32:
+            return 4;
+        case Type::INT64:
+        case Type::UINT64:
+        case Type::FLOAT64:
+            return 8;
+        case Type::BOOL:
+            return 1;
+        default:
+            return 0;  // STRING has its own length byte
+    }
+}
+
+/**
+ * @brief Appends fields to a caller-owned buffer
+ *
+ * A field that does not fit whole is left out and sets truncated(); the
+ * fields before it stay valid.
+ */
+class Writer {
+public:
+    Writer(uint8_t* buffer, size_t capacity) : buffer_(buffer), capacity_(capacity), length_(0), truncated_(false) {}
+
+    void put(const char* key, Type type, const void* value) {
+        size_t size = valueSize(type);
+        uint8_t* p = begin(key, type, size);
+        if (p) memcpy(p, value, size);
+    }
+
+    void putString(const char* key, const char* value, size_t length) {
+        if (!value) value = "";
+        if (length > 255) length = 255;
+        uint8_t* p = begin(key, Type::STRING, 1 + length);
+        if (!p) return;
+        *p++ = static_cast<uint8_t>(length);
+        if (length) memcpy(p, value, length);
+    }
+
+    const uint8_t* data() const { return buffer_; }
+    size_t length() const { return length_; }
+    bool truncated() const { return truncated_; }
+
+private:
+    // Writes type and key; returns where the value goes, nullptr if it does not fit
+    uint8_t* begin(const char* key, Type type, size_t valueBytes) {
+        // strlen, not strnlen(key, 255): short key literals would trip -Wstringop-overread
+        size_t keyLength = key ? strlen(key) : 0;
+        if (keyLength > 255) keyLength = 255;
+        size_t needed = 2 + keyLength + valueBytes;
+        if (!buffer_ || needed > capacity_ - length_) {
+            truncated_ = true;
+            return nullptr;
+        }
+        uint8_t* p = buffer_ + length_;
+        *p++ = static_cast<uint8_t>(type);
+        *p++ = static_cast<uint8_t>(keyLength);
+        if (keyLength) memcpy(p, key, keyLength);
+        length_ += needed;
+        return p + keyLength;
+    }
+
+    uint8_t* buffer_;
+    size_t capacity_;
+    size_t length_;
+    bool truncated_;
+};
+
+// One decoded field; key and text point into the encoded bytes (not NUL-terminated)
+struct Field {
+    Type type;
+    const char* key;
+    size_t keyLength;
+    union {
+        int64_t i;   // INT32, INT64
+        uint64_t u;  // UINT32, UINT64
+        double f;    // FLOAT32, FLOAT64
+        bool b;
+    };
+    const char* text;  // STRING
+    size_t textLength;
+};
+
+/**
+ * @brief Walks encoded fields
+ *
+ *   LogFields::Reader fields(view.fields, view.fieldsLength);
+ *   LogFields::Field field;
+ *   while (fields.next(field)) { ... }
+ *
+ * Stops at the end or at the first malformed field.
+ */
+class Reader {
+public:
+    Reader(const uint8_t* data, size_t length) : p_(data), end_(data ? data + length : data) {}
+
+    bool next(Field& field) {
+        if (end_ - p_ < 2) return false;
+        field.type = static_cast<Type>(p_[0]);
+        field.keyLength = p_[1];
+        if (static_cast<size_t>(end_ - p_) < 2 + field.keyLength) return false;
+        const uint8_t* value = p_ + 2 + field.keyLength;
+        field.key = reinterpret_cast<const char*>(p_ + 2);
+        field.text = nullptr;
+        field.textLength = 0;
+
+        size_t size = valueSize(field.type);
+        if (field.type == Type::STRING) {
+            if (value >= end_) return false;
+            size = 1 + value[0];
+            if (static_cast<size_t>(end_ - value) < size) return false;
+            field.text = reinterpret_cast<const char*>(value + 1);
+            field.textLength = value[0];
+        } else if (size == 0 || static_cast<size_t>(end_ - value) < size) {
+            return false;  // Unknown type or cut short
+        }
+
+        switch (field.type) {
+            case Type::INT32: {
+                int32_t v;
+                memcpy(&v, value, 4);
+                field.i = v;
+                break;
+            }
+            case Type::UINT32: {
+                uint32_t v;
+                memcpy(&v, value, 4);
+                field.u = v;
+                break;
+            }
+            case Type::INT64:
+                memcpy(&field.i, value, 8);
+                break;
+            case Type::UINT64:
+                memcpy(&field.u, value, 8);
+                break;
+            case Type::FLOAT32: {
+                float v;
+                memcpy(&v, value, 4);
+                field.f = v;
+                break;
+            }
+            case Type::FLOAT64:
+                memcpy(&field.f, value, 8);
+                break;
+            case Type::BOOL:
+                field.b = value[0] != 0;
+                break;
+            default:
+                break;
+        }
+        p_ = value + size;
+        return true;
+    }
+
+private:
+    const uint8_t* p_;
+    const uint8_t* end_;
+};
+
+// ---- Renderers ----
+
+inline void putNumber(LogFormat::Writer& out, const Field& field) {
+    LogFormat::Spec spec;
+    switch (field.type) {
+        case Type::INT32:
+        case Type::INT64:
+            LogFormat::formatArg(out, spec, field.i);
+            break;
+        case Type::UINT32:
+        case Type::UINT64:
+            LogFormat::formatArg(out, spec, field.u);
+            break;
+        case Type::FLOAT32:
+        case Type::FLOAT64:
+            LogFormat::formatArg(out, spec, field.f);
+            break;
+        case Type::BOOL:
+            LogFormat::formatArg(out, spec, field.b);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief logfmt text: key=value pairs separated by spaces
+ *
+ * Strings are quoted when empty or when they contain a space, '"' or '=';
+ * '"' and '\' inside quotes are escaped. Numbers as in "{}" formatting.
+ */
+inline void renderText(LogFormat::Writer& out, const uint8_t* data, size_t length) {
+    Reader fields(data, length);
+    Field field;
+    bool first = true;
+    while (fields.next(field)) {
+        if (!first) out.put(' ');
+        first = false;
+        out.put(field.key, field.keyLength);
+        out.put('=');
+        if (field.type != Type::STRING) {
+            putNumber(out, field);
+            continue;
+        }
+
+        bool quote = field.textLength == 0;
+        for (size_t i = 0; i < field.textLength && !quote; i++) {
+            char c = field.text[i];
+            quote = c == ' ' || c == '"' || c == '=';
+        }
+        if (!quote) {
+            out.put(field.text, field.textLength);
+            continue;
+        }
+        out.put('"');
+        for (size_t i = 0; i < field.textLength; i++) {
+            char c = field.text[i];
+            if (c == '"' || c == '\\') out.put('\\');
+            out.put(c);
+        }
+        out.put('"');
+    }
+}
+
+inline void putJsonString(LogFormat::Writer& out, const char* s, size_t length) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    out.put('"');
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c == '"' || c == '\\') {
+            out.put('\\');
+            out.put(static_cast<char>(c));
+        } else if (c < 0x20) {
+            out.put("\\u00", 4);
+            out.put(HEX_DIGITS[c >> 4]);
+            out.put(HEX_DIGITS[c & 0x0F]);
+        } else {
+            out.put(static_cast<char>(c));
+        }
+    }
+    out.put('"');
+}
+
+/**
+ * @brief One JSON object: {"key":value,...}
+ * @note NaN and infinity are written as null; duplicate keys are kept
+ */
+inline void renderJson(LogFormat::Writer& out, const uint8_t* data, size_t length) {
+    Reader fields(data, length);
+    Field field;
+    bool first = true;
+    out.put('{');
+    while (fields.next(field)) {
+        if (!first) out.put(',');
+        first = false;
+        putJsonString(out, field.key, field.keyLength);
+        out.put(':');
+        if (field.type == Type::STRING) {
+            putJsonString(out, field.text, field.textLength);
+        } else if ((field.type == Type::FLOAT32 || field.type == Type::FLOAT64) && !(field.f - field.f == 0)) {
+            out.put("null", 4);
+        } else {
+            putNumber(out, field);
+        }
+    }
+    out.put('}');
+}
+
+}  // namespace LogFields
@@ -0,0 +1,208 @@
+/*
+ * LogFilter.h - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// LogFilter.h
+// Immutable level configuration (global level, on/off, tag and pattern
+// levels) that Logger publishes as one unit
+
+#pragma once
+
+#include <esp_log.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "TagLevelTable.h"
+
+#ifndef CONFIG_LOG_MAX_TAG_PATTERNS
+#define CONFIG_LOG_MAX_TAG_PATTERNS 8  // Prefix rules such as "Modbus.*"
+#endif
+
+/**
+ * @brief Everything that decides whether a level is logged for a tag
+ *
+ * Logger never edits the published filter. Writers copy it, change the
+ * copy and publish that with one pointer swap (RcuPointer), so a log call
+ * sees one configuration: never the new global level with the old tag
+ * levels, or half of a LoggerConfig's tags.
+ *
+ * Tag levels are indexed by TagLevelTable slot. For every slot that
+ * existed when the filter was built it holds the tag's own level and the
+ * level it resolves to (own level, else longest matching pattern), so a
+ * lookup is one byte. Tags added to the table later have no level of their
+ * own here; their pattern level is resolved once per filter and cached in
+ * the table entry, tagged with this filter's stamp.
+ *
+ * Plain data: copy by assignment. Writers call the setters on an
+ * unpublished copy, serialized by the caller (Logger's tagMutex, which
+ * also guards the table).
+ */
+class LogFilter {
+public:
+    static constexpr size_t CAPACITY = TagLevelTable::CAPACITY;
+    static constexpr size_t PATTERN_CAPACITY = CONFIG_LOG_MAX_TAG_PATTERNS;
+    static constexpr size_t NAME_SIZE = TagLevelTable::NAME_SIZE;
+    static constexpr uint8_t LEVEL_UNSET = 0xFF;
+
+    esp_log_level_t globalLevel() const { return globalLevel_; }
+    bool enabled() const { return enabled_; }
+    size_t patternCount() const { return patternCount_; }
+
+    // Changes with every published filter (never 0)
+    uint32_t stamp() const { return stamp_; }
+
+    /**
+     * @brief Level for a tag: its own, else its longest matching pattern
+     * @param table Tag table the levels are indexed by (may be nullptr)
+     * @param id Tag ID, or 0 to look the tag up by name
+     * @param unregistered Set when the tag is not in the table and the
+     *        patterns had to be scanned - intern it so the next lookup is O(1)
+     * @return false if neither applies (the tag uses the global level)
+     * @note Lock-free; only reads the filter and the table
+     */
+    bool resolve(const TagLevelTable* table, const char* tag, uint32_t id, esp_log_level_t& level,
+                 bool& unregistered) const {
+        unregistered = false;
+        int slot = table ? table->slotOf(tag, id) : -1;
+        uint8_t stored;
+        if (slot >= 0 && static_cast<size_t>(slot) < tagCount_) {
+            stored = effective_[slot];
+        } else if (patternCount_ == 0) {
+            return false;  // No own level past tagCount_, and nothing to inherit
+        } else if (slot >= 0) {
+            if (!table->cachedLevel(slot, stamp_, stored)) {
+                stored = matchPatterns(table->nameAt(slot));
+                table->cacheLevel(slot, stamp_, stored);
+            }
+        } else {
+            unregistered = true;
+            stored = matchPatterns(tag);
+        }
+        if (stored == LEVEL_UNSET) return false;
+        level = static_cast<esp_log_level_t>(stored);
+        return true;
+    }
+
+    /**
+     * @brief Level set for a pattern, by its exact text ("Modbus.*")
+     */
+    bool lookupPattern(const char* pattern, esp_log_level_t& level) const {
+        int i = findPattern(pattern);
+        if (i < 0) return false;
+        level = static_cast<esp_log_level_t>(patterns_[i].level);
+        return true;
+    }
+
+    // ---- Writers (unpublished copy only) ----
+
+    void setGlobalLevel(esp_log_level_t level) { globalLevel_ = level; }
+    void setEnabled(bool enabled) { enabled_ = enabled; }
+
+    /**
+     * @brief Set the own level of the tag in `slot` (TagLevelTable::slotFor())
+     * @return false if slot is -1 (table full)
+     */
+    bool setTag(const TagLevelTable& table, int slot, esp_log_level_t level) {
+        if (slot < 0) return false;
+        cover(table);
+        own_[slot] = static_cast<uint8_t>(level);
+        effective_[slot] = static_cast<uint8_t>(level);
+        return true;
+    }
+
+    /**
+     * @brief Insert or update a prefix pattern and re-resolve every tag
+     * @param pattern Prefix followed by '*' (see TagLevelTable::isPattern())
+     * @return false if the pattern is new and the pattern list is full
+     */
+    bool setPattern(const TagLevelTable& table, const char* pattern, esp_log_level_t level) {
+        int i = findPattern(pattern);
+        if (i < 0) {
+            if (patternCount_ >= PATTERN_CAPACITY) return false;
+            i = patternCount_++;
+            size_t length = strnlen(pattern, NAME_SIZE - 1) - 1;
+            memcpy(patterns_[i].prefix, pattern, length);
+            patterns_[i].prefix[length] = '\0';
+            patterns_[i].length = static_cast<uint8_t>(length);
+        }
+        patterns_[i].level = static_cast<uint8_t>(level);
+
+        // Resolved once here, not on every log call
+        cover(table);
+        for (size_t slot = 0; slot < tagCount_; slot++) {
+            effective_[slot] = own_[slot] != LEVEL_UNSET ? own_[slot] : matchPatterns(table.nameAt(slot));
+        }
+        return true;
+    }
+
+    // Give the copy its own stamp before it is published
+    void restamp() {
+        stamp_ = (stamp_ + 1) & 0xFFFFFF;  // TagLevelTable::cachedLevel() keeps 24 bits
+        if (stamp_ == 0) stamp_ = 1;
+    }
+
+private:
+    struct Pattern {
+        char prefix[NAME_SIZE];  // Without the '*'
+        uint8_t length;
+        uint8_t level;
+    };
+
+    // Take in the slots the table gained since this filter was built
+    void cover(const TagLevelTable& table) {
+        for (size_t slot = tagCount_; slot < table.size(); slot++) {
+            own_[slot] = LEVEL_UNSET;
+            effective_[slot] = matchPatterns(table.nameAt(slot));
+        }
+        tagCount_ = static_cast<uint16_t>(table.size());
+    }
+
+    int findPattern(const char* pattern) const {
+        size_t length = strnlen(pattern, NAME_SIZE - 1) - 1;
+        for (size_t i = 0; i < patternCount_; i++) {
+            if (patterns_[i].length == length && strncmp(patterns_[i].prefix, pattern, length) == 0) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    // Longest prefix wins
+    uint8_t matchPatterns(const char* tag) const {
+        int best = -1;
+        for (size_t i = 0; i < patternCount_; i++) {
+            const Pattern& pattern = patterns_[i];
+            if ((best < 0 || pattern.length > patterns_[best].length) &&
+                strncmp(tag, pattern.prefix, pattern.length) == 0) {
+                best = static_cast<int>(i);
+            }
+        }
+        return best < 0 ? LEVEL_UNSET : patterns_[best].level;
+    }
+
+    uint32_t stamp_ = 1;
+    esp_log_level_t globalLevel_ = ESP_LOG_INFO;
+    bool enabled_ = true;
+    uint16_t tagCount_ = 0;  // Slots covered by own_ / effective_
+    uint8_t patternCount_ = 0;
+    uint8_t own_[CAPACITY] = {};        // Set for the tag, or LEVEL_UNSET
+    uint8_t effective_[CAPACITY] = {};  // Own level, else pattern level, else LEVEL_UNSET
+    Pattern patterns_[PATTERN_CAPACITY] = {};
+};
@@ -0,0 +1,357 @@
+/*
+ * LogFormat.h - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// LogFormat.h
+// Type-safe "{}" formatting: each argument is written by an overload picked
+// at compile time, no printf parsing. C++11, no dependency on Logger.h
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <tuple>
+#include <type_traits>
+
+#ifndef CONFIG_LOG_FORMAT_FLOAT_PRECISION
+#define CONFIG_LOG_FORMAT_FLOAT_PRECISION 3  // Decimals for "{}" with float/double
+#endif
+
+/**
+ * Format syntax:
+ *   {}      argument in its natural form
+ *   {:x}    integer in hex ({:X} upper case)
+ *   {:.N}   float/double with N decimals (0-9)
+ *   {{ }}   literal braces
+ *
+ * Supported arguments: integers, bool, char, float/double, enums (as their
+ * value), C strings, pointers, and anything with c_str() and length()
+ * (std::string, Arduino String). Other types can be made loggable with a
+ * formatArg(LogFormat::Writer&, const LogFormat::Spec&, const T&) overload
+ * in the type's namespace.
+ */
+namespace LogFormat {
+
+// ---- Compile-time placeholder count (recursive constexpr, C++11) ----
+
+constexpr bool closes(const char* s) {
+    return *s == '\0' ? false : (*s == '}' ? true : closes(s + 1));
+}
+
+constexpr const char* skipSpec(const char* s) {
+    return *s == '}' ? s + 1 : skipSpec(s + 1);
+}
+
+/**
+ * @brief Number of "{...}" placeholders in a format
+ * @note Usable in static_assert for string literals; a '{' without a closing
+ *       '}' is literal text, as in formatTo()
+ */
+constexpr size_t countPlaceholders(const char* s, size_t n = 0) {
+    return *s == '\0' ? n
+        : (s[0] == '{' && s[1] == '{') || (s[0] == '}' && s[1] == '}') ? countPlaceholders(s + 2, n)
+        : (s[0] == '{' && closes(s + 1)) ? countPlaceholders(skipSpec(s + 1), n + 1)
+        : countPlaceholders(s + 1, n);
+}
+
+// sizeof(argCounter(args...)) == number of args + 1, never evaluated
+template <typename... Args>
+char (&argCounter(const Args&...))[sizeof...(Args) + 1];
+
+// ---- Output ----
+
+/**
+ * @brief Bounded writer that keeps counting past the end
+ *
+ * length() is the size the whole output needs, so a caller whose buffer
+ * was too small can retry with a bigger one.
+ */
+class Writer {
+public:
+    // size includes the terminating NUL
+    Writer(char* buffer, size_t size) : buffer_(buffer), size_(size), length_(0) {}
+
+    void put(char c) {
+        if (length_ + 1 < size_) buffer_[length_] = c;
+        length_++;
+    }
+
+    void put(const char* s, size_t n) {
+        if (length_ + 1 < size_) {
+            size_t room = size_ - 1 - length_;
+            memcpy(buffer_ + length_, s, n < room ? n : room);
+        }
+        length_ += n;
+    }
+
+    void putUnsigned(uint64_t value, unsigned base = 10, bool upper = false) {
+        const char* digitChars = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+        char digits[20];
+        size_t n = 0;
+        if (base == 16) {
+            do {
+                digits[n++] = digitChars[value & 0xF];
+                value >>= 4;
+            } while (value);
+        } else {
+            // 32-bit division is a single instruction; 64-bit is a library call
+            while (value > UINT32_MAX) {
+                digits[n++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+            uint32_t low = static_cast<uint32_t>(value);
+            do {
+                digits[n++] = static_cast<char>('0' + low % 10);
+                low /= 10;
+            } while (low);
+        }
+        while (n) put(digits[--n]);
+    }
+
+    size_t length() const { return length_; }                                // Needed, may exceed the buffer
+    size_t written() const { return length_ < size_ ? length_ : size_ - 1; }  // Actually stored
+
+    // NUL-terminate; returns length()
+    size_t finish() {
+        if (size_) buffer_[written()] = '\0';
+        return length_;
+    }
+
+private:
+    char* buffer_;
+    size_t size_;
+    size_t length_;
+};
+
+struct Spec {
+    char type = 0;        // 0, 'x' or 'X'
+    int8_t precision = -1;
+};
+
+// ---- Argument writers ----
+
+inline void formatArg(Writer& out, const Spec&, bool value) {
+    if (value) out.put("true", 4);
+    else out.put("false", 5);
+}
+
+inline void formatArg(Writer& out, const Spec&, char value) {
+    out.put(value);
+}
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type
+formatArg(Writer& out, const Spec& spec, T value) {
+    out.putUnsigned(value, spec.type ? 16 : 10, spec.type == 'X');
+}
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+formatArg(Writer& out, const Spec& spec, T value) {
+    uint64_t magnitude = static_cast<uint64_t>(value);
+    if (value < 0) {
+        out.put('-');
+        magnitude = 0 - magnitude;
+    }
+    out.putUnsigned(magnitude, spec.type ? 16 : 10, spec.type == 'X');
+}
+
+template <typename T>
+typename std::enable_if<std::is_enum<T>::value>::type
+formatArg(Writer& out, const Spec& spec, T value) {
+    formatArg(out, spec, static_cast<typename std::underlying_type<T>::type>(value));
+}
+
+inline void formatArg(Writer& out, const Spec& spec, double value) {
+    static const uint32_t SCALES[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+    int precision = spec.precision < 0 ? CONFIG_LOG_FORMAT_FLOAT_PRECISION : spec.precision;
+    if (precision > 9) precision = 9;
+
+    if (value != value) {
+        out.put("nan", 3);
+        return;
+    }
+    if (value < 0) {
+        out.put('-');
+        value = -value;
+    }
+    if (value >= 1e19) {
+        // Out of integer range and rare: let printf handle it
+        char text[32];
+        int n = snprintf(text, sizeof(text), "%.*g", precision + 1, value);
+        if (n > 0) out.put(text, static_cast<size_t>(n) < sizeof(text) ? n : sizeof(text) - 1);
+        return;
+    }
+
+    uint64_t whole = static_cast<uint64_t>(value);
+    uint32_t scale = SCALES[precision];
+    uint32_t fraction = static_cast<uint32_t>((value - static_cast<double>(whole)) * scale + 0.5);
+    if (fraction >= scale) {
+        whole++;
+        fraction -= scale;
+    }
+
+    out.putUnsigned(whole);
+    if (precision == 0) return;
+    out.put('.');
+    for (uint32_t digit = scale / 10; digit > 1 && fraction < digit; digit /= 10) out.put('0');
+    out.putUnsigned(fraction);
+}
+
+inline void formatArg(Writer& out, const Spec& spec, float value) {
+    formatArg(out, spec, static_cast<double>(value));
+}
+
+inline void formatArg(Writer& out, const Spec&, const char* value) {
+    if (!value) value = "(null)";
+    out.put(value, strlen(value));
+}
+
+inline void formatArg(Writer& out, const Spec&, const void* value) {
+    out.put("0x", 2);
+    out.putUnsigned(reinterpret_cast<uintptr_t>(value), 16);
+}
+
+// std::string, Arduino String, ...
+template <typename S>
+auto formatArg(Writer& out, const Spec&, const S& value) -> decltype(value.c_str(), value.length(), void()) {
+    out.put(value.c_str(), value.length());
+}
+
+// ---- Format walking ----
+
+// Copy literal text up to the next placeholder; returns its '{' or the end
+inline const char* writeLiteral(Writer& out, const char* p) {
+    for (;;) {
+        const char* start = p;
+        while (*p && *p != '{' && *p != '}') p++;
+        out.put(start, p - start);
+        if (!*p) return p;
+        if (p[1] == *p) {  // "{{" or "}}"
+            out.put(*p);
+            p += 2;
+        } else if (*p == '{' && strchr(p + 1, '}')) {
+            return p;
+        } else {
+            out.put(*p++);
+        }
+    }
+}
+
+// p is at '{'; returns the character after the closing '}'
+inline const char* parseSpec(const char* p, Spec& spec) {
+    p++;
+    if (*p == ':') {
+        for (p++; *p != '}'; p++) {
+            if (*p == '.') {
+                spec.precision = 0;
+                while (p[1] >= '0' && p[1] <= '9') spec.precision = static_cast<int8_t>(spec.precision * 10 + (*++p - '0'));
+            } else if (*p == 'x' || *p == 'X') {
+                spec.type = *p;
+            }
+        }
+    }
+    while (*p != '}') p++;
+    return p + 1;
+}
+
+// No arguments left: the rest is literal, unmatched placeholders included
+inline void formatTo(Writer& out, const char* p) {
+    while (*(p = writeLiteral(out, p))) {
+        const char* start = p;
+        Spec unused;
+        p = parseSpec(p, unused);
+        out.put(start, p - start);
+    }
+}
+
+template <typename T, typename... Rest>
+void formatTo(Writer& out, const char* p, const T& arg, const Rest&... rest) {
+    p = writeLiteral(out, p);
+    if (!*p) return;  // More arguments than placeholders (LOGF_* rejects this at compile time)
+
+    Spec spec;
+    p = parseSpec(p, spec);
+    formatArg(out, spec, arg);
+    formatTo(out, p, rest...);
+}
+
+// ---- Type-erased message, rendered where the buffer lives ----
+
+/**
+ * @brief A format plus its arguments, rendered on demand
+ *
+ * Lets Logger pick a buffer (and retry in a bigger one) without being a
+ * template itself. Holds references: only valid within the full expression
+ * that created it.
+ */
+class Message {
+public:
+    explicit Message(const char* format) : format_(format) {}
+    const char* format() const { return format_; }
+
+    // Render into buffer (size includes the NUL); returns the full length
+    virtual size_t render(char* buffer, size_t size) const = 0;
+
+protected:
+    ~Message() = default;
+
+    const char* format_;
+};
+
+template <size_t... I>
+struct Indices {};
+
+template <size_t N, size_t... I>
+struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+
+template <size_t... I>
+struct MakeIndices<0, I...> {
+    using type = Indices<I...>;
+};
+
+template <typename... Args>
+class BoundMessage final : public Message {
+public:
+    BoundMessage(const char* format, const Args&... args) : Message(format), args_(args...) {}
+
+    size_t render(char* buffer, size_t size) const override {
+        Writer out(buffer, size);
+        renderArgs(out, typename MakeIndices<sizeof...(Args)>::type());
+        return out.finish();
+    }
+
+private:
+    template <size_t... I>
+    void renderArgs(Writer& out, Indices<I...>) const {
+        formatTo(out, format_, std::get<I>(args_)...);
+    }
+
+    std::tuple<const Args&...> args_;
+};
+
+template <typename... Args>
+BoundMessage<Args...> bind(const char* format, const Args&... args) {
+    return BoundMessage<Args...>(format, args...);
+}
+
+}  // namespace LogFormat
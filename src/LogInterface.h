@@ -25,33 +25,213 @@
 
 #include <esp_log.h>
 #include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+#include "LogFormat.h"
+#endif
 
 // Function pointer type for custom log implementation
 typedef void (*custom_log_function_t)(esp_log_level_t level, const char* tag, const char* format, va_list args);
 
+/**
+ * Compile-time level stripping.
+ *
+ * Calls more verbose than the compile level are removed by the compiler,
+ * arguments and format strings included - with either backend.
+ *
+ *   -DCONFIG_LOG_COMPILE_LEVEL=ESP_LOG_INFO          all tags
+ *   -DLOG_COMPILE_LEVELS='{"ModbusRTU", ESP_LOG_WARN}, {"WiFi", ESP_LOG_VERBOSE}'
+ *
+ * LOG_COMPILE_LEVELS (C++ only) overrides the default per tag, in either
+ * direction. Tags are compared in full at compile time, so this needs a
+ * string literal tag (or a constexpr pointer to one) and optimization
+ * (-Os/-O2, the Arduino and IDF default). Calls whose tag the compiler
+ * cannot resolve are only stripped below the most verbose level of any
+ * entry, and left to the runtime filters otherwise.
+ */
+#ifndef CONFIG_LOG_COMPILE_LEVEL
+#define CONFIG_LOG_COMPILE_LEVEL ESP_LOG_VERBOSE
+#endif
+
+#ifdef __cplusplus
+    typedef struct {
+        const char* tag;
+        esp_log_level_t level;
+    } log_compile_level_t;
+
+    constexpr bool log_compile_tag_equal(const char* a, const char* b) {
+        return *a == *b && (*a == '\0' || log_compile_tag_equal(a + 1, b + 1));
+    }
+
+    #ifdef LOG_COMPILE_LEVELS
+        static constexpr log_compile_level_t log_compile_levels_[] = { LOG_COMPILE_LEVELS };
+
+        static constexpr esp_log_level_t log_compile_level_at(const char* tag, size_t i) {
+            return i == sizeof(log_compile_levels_) / sizeof(log_compile_levels_[0])
+                ? (esp_log_level_t)CONFIG_LOG_COMPILE_LEVEL
+                : log_compile_tag_equal(tag, log_compile_levels_[i].tag)
+                    ? log_compile_levels_[i].level
+                    : log_compile_level_at(tag, i + 1);
+        }
+
+        static constexpr esp_log_level_t log_compile_level(const char* tag) {
+            return tag ? log_compile_level_at(tag, 0) : (esp_log_level_t)CONFIG_LOG_COMPILE_LEVEL;
+        }
+
+        // Most verbose level any tag may need: the bound for unresolved tags
+        static constexpr esp_log_level_t log_compile_level_max(size_t i = 0) {
+            return i == sizeof(log_compile_levels_) / sizeof(log_compile_levels_[0])
+                ? (esp_log_level_t)CONFIG_LOG_COMPILE_LEVEL
+                : log_compile_levels_[i].level > log_compile_level_max(i + 1)
+                    ? log_compile_levels_[i].level
+                    : log_compile_level_max(i + 1);
+        }
+
+        #define LOG_COMPILE_LEVEL(tag) log_compile_level(tag)
+
+        // Tags the compiler cannot see through are never looked up at runtime
+        #define LOG_COMPILE_ENABLED(level, tag) \
+            (__builtin_constant_p(LOG_COMPILE_LEVEL(tag)) ? (level) <= LOG_COMPILE_LEVEL(tag) \
+                                                         : (level) <= log_compile_level_max())
+    #endif
+#endif
+
+#ifndef LOG_COMPILE_ENABLED
+    #define LOG_COMPILE_LEVEL(tag) ((esp_log_level_t)CONFIG_LOG_COMPILE_LEVEL)
+    #define LOG_COMPILE_ENABLED(level, tag) ((level) <= CONFIG_LOG_COMPILE_LEVEL)
+#endif
+
 #ifdef USE_CUSTOM_LOGGER
+    /**
+     * Per-call-site level cache.
+     *
+     * Every LOG_WRITE expansion owns one of these (function-local static, constant
+     * initialized, so no guard variable). It remembers the effective level resolved
+     * for the site's tag together with the configuration generation it was resolved
+     * under. Logger bumps the generation whenever a level changes, so a disabled call
+     * site costs two loads and a compare - no call across the extern "C" boundary.
+     *
+     * state = (generation << 8) | effective level; 0 means "not resolved yet".
+     * The site binds to the first tag it sees; calls with a different tag pointer
+     * (runtime-selected tags) always take the slow path.
+     */
+    typedef struct {
+        const char* tag;
+        uint32_t state;
+    } log_site_cache_t;
+
+    #define LOG_SITE_CACHE_INIT { nullptr, 0 }
+    #define LOG_SITE_GENERATION_MASK 0x00FFFFFFu
+
     // When custom logger is enabled, use external functions
     extern "C" {
         void custom_log_write(esp_log_level_t level, const char* tag, const char* format, va_list args);
+        void custom_log_write_from_isr(esp_log_level_t level, const char* tag, const char* format, va_list args);
+        void custom_log_write_hex(esp_log_level_t level, const char* tag, const char* label,
+                                  const void* data, size_t length);
         bool custom_log_is_enabled(esp_log_level_t level);
         bool custom_log_is_enabled_for_tag(esp_log_level_t level, const char* tag);
+        bool custom_log_site_resolve(log_site_cache_t* site, esp_log_level_t level, const char* tag);
+
+        // Bumped by Logger on every level/enable change (never 0 in the low 24 bits)
+        extern uint32_t custom_log_config_generation;
     }
-    
-    // Core logging function that routes to custom implementation with tag-level filtering
-    static inline void log_write_impl(esp_log_level_t level, const char* tag, const char* format, ...) {
-        // Use tag-aware level checking for better performance
-        if (custom_log_is_enabled_for_tag(level, tag)) {
-            va_list args;
-            va_start(args, format);
-            custom_log_write(level, tag, format, args);
-            va_end(args);
+
+    // Fast path: cached level check, falls back to custom_log_site_resolve() when stale
+    static inline bool log_site_is_enabled(log_site_cache_t* site, esp_log_level_t level, const char* tag) {
+        uint32_t state = __atomic_load_n(&site->state, __ATOMIC_ACQUIRE);
+        uint32_t generation = __atomic_load_n(&custom_log_config_generation, __ATOMIC_RELAXED);
+        if ((state >> 8) == (generation & LOG_SITE_GENERATION_MASK) &&
+            __atomic_load_n(&site->tag, __ATOMIC_RELAXED) == tag) {
+            return level <= (esp_log_level_t)(state & 0xFF);
         }
+        return custom_log_site_resolve(site, level, tag);
     }
-    
-    #define LOG_WRITE(level, tag, format, ...) log_write_impl(level, tag, format, ##__VA_ARGS__)
+
+    // Core logging function - level check already done by the call site cache
+    static inline void log_write_impl(esp_log_level_t level, const char* tag, const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        custom_log_write(level, tag, format, args);
+        va_end(args);
+    }
+
+    #define LOG_WRITE(level, tag, format, ...) do { \
+        static log_site_cache_t log_site_cache_ = LOG_SITE_CACHE_INIT; \
+        if ((level) != ESP_LOG_NONE && LOG_COMPILE_ENABLED(level, tag) && \
+            log_site_is_enabled(&log_site_cache_, (level), (tag))) { \
+            log_write_impl(level, tag, format, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+    static inline void log_write_from_isr_impl(esp_log_level_t level, const char* tag, const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        custom_log_write_from_isr(level, tag, format, args);
+        va_end(args);
+    }
+
+    // Interrupt handlers: only enqueues for the deferred task (Logger::logFromISR)
+    #define LOG_ISR(level, tag, format, ...) do { \
+        static log_site_cache_t log_site_cache_ = LOG_SITE_CACHE_INIT; \
+        if ((level) != ESP_LOG_NONE && LOG_COMPILE_ENABLED(level, tag) && \
+            log_site_is_enabled(&log_site_cache_, (level), (tag))) { \
+            log_write_from_isr_impl(level, tag, format, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+    // Binary payload as one hex line (Logger::logHex) instead of a call per byte
+    #define LOG_HEX(level, tag, label, data, length) do { \
+        static log_site_cache_t log_site_cache_ = LOG_SITE_CACHE_INIT; \
+        if ((level) != ESP_LOG_NONE && LOG_COMPILE_ENABLED(level, tag) && \
+            log_site_is_enabled(&log_site_cache_, (level), (tag))) { \
+            custom_log_write_hex(level, tag, label, data, length); \
+        } \
+    } while (0)
+
+    // "{}" messages (Logger::logMessage); C++ linkage, the argument is a C++ object
+    void custom_log_write_message(esp_log_level_t level, const char* tag, const LogFormat::Message& message);
+
+    #define LOGF_WRITE(level, tag, format, ...) do { \
+        LOGF_CHECK_ARGS(format, ##__VA_ARGS__); \
+        static log_site_cache_t log_site_cache_ = LOG_SITE_CACHE_INIT; \
+        if ((level) != ESP_LOG_NONE && LOG_COMPILE_ENABLED(level, tag) && \
+            log_site_is_enabled(&log_site_cache_, (level), (tag))) { \
+            custom_log_write_message(level, tag, LogFormat::bind(format, ##__VA_ARGS__)); \
+        } \
+    } while (0)
 #else
     // When custom logger is disabled, use ESP-IDF directly
-    #define LOG_WRITE(level, tag, format, ...) ESP_LOG_LEVEL(level, tag, format, ##__VA_ARGS__)
+    #define LOG_WRITE(level, tag, format, ...) do { \
+        if (LOG_COMPILE_ENABLED(level, tag)) ESP_LOG_LEVEL(level, tag, format, ##__VA_ARGS__); \
+    } while (0)
+
+    // ESP_LOG_LEVEL is not ISR-safe and has no queue to defer to: compiled out
+    #define LOG_ISR(level, tag, format, ...) do { } while (0)
+
+    // ESP-IDF prints the label, then 16 bytes per line
+    #define LOG_HEX(level, tag, label, data, length) do { \
+        if (LOG_COMPILE_ENABLED(level, tag)) { \
+            ESP_LOG_LEVEL(level, tag, "%s (%u bytes):", (label) ? (label) : "", (unsigned)(length)); \
+            ESP_LOG_BUFFER_HEX_LEVEL(tag, data, length, level); \
+        } \
+    } while (0)
+
+    #ifndef CONFIG_LOG_FORMAT_STACK_BUFFER
+    #define CONFIG_LOG_FORMAT_STACK_BUFFER 128  // "{}" messages rendered on the stack for ESP_LOG_LEVEL
+    #endif
+
+    // Rendered on the caller's stack, then printed as "%s" by ESP-IDF
+    #define LOGF_WRITE(level, tag, format, ...) do { \
+        LOGF_CHECK_ARGS(format, ##__VA_ARGS__); \
+        if (LOG_COMPILE_ENABLED(level, tag) && LOG_LOCAL_LEVEL >= (level) && esp_log_level_get(tag) >= (level)) { \
+            char logf_buffer_[CONFIG_LOG_FORMAT_STACK_BUFFER]; \
+            LogFormat::bind(format, ##__VA_ARGS__).render(logf_buffer_, sizeof(logf_buffer_)); \
+            ESP_LOG_LEVEL(level, tag, "%s", logf_buffer_); \
+        } \
+    } while (0)
     
     // ESP-IDF level checking
     #define custom_log_is_enabled(level) (level <= CONFIG_LOG_MAXIMUM_LEVEL)
@@ -79,6 +259,20 @@ typedef void (*custom_log_function_t)(esp_log_level_t level, const char* tag, co
 #define LOG_VERBOSE(tag, format, ...) LOG_WRITE(ESP_LOG_VERBOSE, tag, format, ##__VA_ARGS__)
 #endif
 
+// Type-safe "{}" macros (C++ only, see LogFormat.h). The format must be a
+// string literal: a placeholder/argument count mismatch fails to compile.
+#define LOGF_CHECK_ARGS(format, ...) \
+    static_assert(LogFormat::countPlaceholders(format) + 1 == sizeof(LogFormat::argCounter(__VA_ARGS__)), \
+                  "LOGF: number of arguments does not match the {} placeholders in the format")
+
+#ifndef LOGF_ERROR
+#define LOGF_ERROR(tag, format, ...)   LOGF_WRITE(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define LOGF_WARN(tag, format, ...)    LOGF_WRITE(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define LOGF_INFO(tag, format, ...)    LOGF_WRITE(ESP_LOG_INFO, tag, format, ##__VA_ARGS__)
+#define LOGF_DEBUG(tag, format, ...)   LOGF_WRITE(ESP_LOG_DEBUG, tag, format, ##__VA_ARGS__)
+#define LOGF_VERBOSE(tag, format, ...) LOGF_WRITE(ESP_LOG_VERBOSE, tag, format, ##__VA_ARGS__)
+#endif
+
 // Convenience macros with automatic tags (optional)
 // User must define LOG_TAG before including this header to use these
 #ifdef LOG_TAG
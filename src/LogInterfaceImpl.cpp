@@ -34,6 +34,14 @@ void custom_log_write(esp_log_level_t level, const char* tag, const char* format
     Logger::getInstance().logV(level, tag, format, args);
 }
 
+void custom_log_write_from_isr(esp_log_level_t level, const char* tag, const char* format, va_list args) {
+    Logger::getInstance().logFromISRV(level, tag, format, args);
+}
+
+void custom_log_write_hex(esp_log_level_t level, const char* tag, const char* label, const void* data, size_t length) {
+    Logger::getInstance().logHex(level, tag, data, length, label);
+}
+
 bool custom_log_is_enabled(esp_log_level_t level) {
     // Quick global check first
     Logger& logger = Logger::getInstance();
@@ -45,6 +53,29 @@ bool custom_log_is_enabled_for_tag(esp_log_level_t level, const char* tag) {
     return Logger::getInstance().isLevelEnabledForTag(tag, level);
 }
 
+// Slow path of the LOG_WRITE call site cache: resolve the tag's effective level
+// and store it with the generation it was resolved under
+bool custom_log_site_resolve(log_site_cache_t* site, esp_log_level_t level, const char* tag) {
+    // Load generation before reading levels: a concurrent change then leaves
+    // the site with an older generation and it re-resolves on the next call
+    uint32_t generation = __atomic_load_n(&custom_log_config_generation, __ATOMIC_ACQUIRE);
+    esp_log_level_t effective = Logger::getInstance().getEffectiveLevel(tag);
+
+    // Bind the site to the first tag it sees; sites with varying tags stay uncached
+    const char* expected = nullptr;
+    __atomic_compare_exchange_n(&site->tag, &expected, tag, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    if (__atomic_load_n(&site->tag, __ATOMIC_RELAXED) == tag) {
+        uint32_t state = ((generation & LOG_SITE_GENERATION_MASK) << 8) | (uint32_t)effective;
+        __atomic_store_n(&site->state, state, __ATOMIC_RELEASE);
+    }
+
+    return level <= effective;
+}
+
 } // extern "C"
 
+void custom_log_write_message(esp_log_level_t level, const char* tag, const LogFormat::Message& message) {
+    Logger::getInstance().logMessage(level, tag, message);
+}
+
 #endif // USE_CUSTOM_LOGGER
\ No newline at end of file
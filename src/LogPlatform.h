@@ -0,0 +1,256 @@
+/*
+ * LogPlatform.h - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// LogPlatform.h
+// Thin OS layer under the core: FreeRTOS/Arduino on the ESP32, std::thread on a host
+
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * Everything the core pipeline needs from the operating system: mutexes,
+ * task creation and notification, time, the current task's name, ISR
+ * detection, the console and capability-aware allocation. The ESP32 side is
+ * inline wrappers around FreeRTOS / ESP-IDF / Arduino, so it costs nothing.
+ *
+ * Build with -DLOG_PLATFORM_NATIVE (and -I src/platform/native for the
+ * esp_log.h shim) to use the host implementation in LogPlatformNative.cpp:
+ * tasks are std::threads, mutexes std::mutex based, the console is stdout.
+ * There is no ISR on a host - IsrScope makes a thread pretend to be one, so
+ * the ISR paths can be tested.
+ *
+ * Hardware backends (UART DMA, flash ring, RTC tail, UDP syslog) talk to
+ * ESP-IDF directly and are not part of the native build.
+ */
+
+#if defined(LOG_PLATFORM_NATIVE)
+
+namespace LogPlatform {
+
+struct NativeMutex;
+struct NativeTask;
+typedef NativeMutex* MutexHandle;
+typedef NativeTask* TaskHandle;
+typedef void (*TaskFunction)(void* param);
+
+// Pretend to be a dual-core ESP32 so the per-core paths are exercised
+static constexpr size_t CORE_COUNT = 2;
+
+bool schedulerRunning();
+size_t coreId();
+
+// Room for a NativeMutex (checked in LogPlatformNative.cpp)
+struct MutexStorage {
+    alignas(alignof(std::max_align_t)) unsigned char bytes[160];
+};
+
+MutexHandle createMutex();
+MutexHandle createMutex(MutexStorage& storage);  // No heap; never deleteMutex() it
+void deleteMutex(MutexHandle mutex);
+size_t mutexSize();
+bool takeMutex(MutexHandle mutex, uint32_t timeoutMs);
+void giveMutex(MutexHandle mutex);
+
+bool startTask(TaskFunction function, const char* name, uint32_t stackSize, void* param, uint32_t priority,
+               int coreId, TaskHandle* handle);
+void endTask();
+void killTask(TaskHandle task);
+TaskHandle currentTask();
+void notifyTask(TaskHandle task);
+void waitNotify(uint32_t timeoutMs);
+
+void delayMs(uint32_t ms);
+void yield();
+uint32_t millis();
+int64_t micros();
+uint32_t cycleCount();
+
+const char* taskName();
+bool inIsr();
+
+size_t consoleWrite(const char* data, size_t length);
+size_t consoleAvailableForWrite();
+void consoleFlush();
+
+void* allocate(size_t bytes, bool psram);
+void* allocateZeroed(size_t bytes, bool psram);
+void release(void* memory);
+
+/**
+ * @brief Marks the calling thread as "in an interrupt handler" while in scope
+ */
+class IsrScope {
+public:
+    IsrScope();
+    ~IsrScope();
+    IsrScope(const IsrScope&) = delete;
+    IsrScope& operator=(const IsrScope&) = delete;
+};
+
+/**
+ * @brief Redirect console output, e.g. to discard it in benchmarks
+ * @param sink Returns bytes accepted; nullptr restores stdout
+ * @param available What consoleAvailableForWrite() reports
+ */
+typedef size_t (*ConsoleSink)(const char* data, size_t length);
+void setConsoleSink(ConsoleSink sink, size_t available = 4096);
+
+}  // namespace LogPlatform
+
+#else  // FreeRTOS / ESP-IDF / Arduino
+
+#include <Arduino.h>
+#include <esp32-hal-log.h>
+#include <esp_heap_caps.h>
+#include <esp_idf_version.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+#include <esp_cpu.h>
+#else
+#include <hal/cpu_hal.h>
+#endif
+
+namespace LogPlatform {
+
+typedef SemaphoreHandle_t MutexHandle;
+typedef TaskHandle_t TaskHandle;
+typedef TaskFunction_t TaskFunction;
+typedef StaticSemaphore_t MutexStorage;
+
+static constexpr size_t CORE_COUNT = portNUM_PROCESSORS;
+
+// Shortest sleep that still yields: sub-tick waits round up to one tick
+inline TickType_t toTicks(uint32_t ms) {
+    TickType_t ticks = pdMS_TO_TICKS(ms);
+    return (ms && !ticks) ? 1 : ticks;
+}
+
+inline bool schedulerRunning() { return xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED; }
+inline size_t coreId() { return static_cast<size_t>(xPortGetCoreID()); }
+
+inline MutexHandle createMutex() { return xSemaphoreCreateMutex(); }
+inline MutexHandle createMutex(MutexStorage& storage) { return xSemaphoreCreateMutexStatic(&storage); }
+inline void deleteMutex(MutexHandle mutex) { vSemaphoreDelete(mutex); }
+inline size_t mutexSize() { return sizeof(StaticSemaphore_t); }  // Heap bytes of one mutex (without block header)
+inline bool takeMutex(MutexHandle mutex, uint32_t timeoutMs) {
+    return xSemaphoreTake(mutex, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+}
+inline void giveMutex(MutexHandle mutex) { xSemaphoreGive(mutex); }
+
+/**
+ * @brief Start a task, pinned when coreId is 0 or 1, unpinned otherwise
+ */
+inline bool startTask(TaskFunction function, const char* name, uint32_t stackSize, void* param, uint32_t priority,
+                      int coreId, TaskHandle* handle) {
+    BaseType_t result;
+    if (coreId >= 0 && coreId <= 1) {
+        result = xTaskCreatePinnedToCore(function, name, stackSize, param, priority, handle, coreId);
+    } else {
+        result = xTaskCreate(function, name, stackSize, param, priority, handle);
+    }
+    return result == pdPASS;
+}
+
+// Last statement of a task function (never returns on FreeRTOS)
+inline void endTask() { vTaskDelete(nullptr); }
+inline void killTask(TaskHandle task) { vTaskDelete(task); }
+inline TaskHandle currentTask() { return xTaskGetCurrentTaskHandle(); }
+
+/**
+ * @brief Wake a task blocked in waitNotify() (task or ISR context)
+ */
+inline void notifyTask(TaskHandle task) {
+    if (xPortInIsrContext()) {
+        BaseType_t higherPriorityTaskWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(task, &higherPriorityTaskWoken);
+        portYIELD_FROM_ISR(higherPriorityTaskWoken);
+    } else {
+        xTaskNotifyGive(task);
+    }
+}
+inline void waitNotify(uint32_t timeoutMs) { ulTaskNotifyTake(pdTRUE, toTicks(timeoutMs)); }
+
+inline void delayMs(uint32_t ms) { vTaskDelay(toTicks(ms)); }
+inline void yield() { taskYIELD(); }
+inline uint32_t millis() { return static_cast<uint32_t>(esp_timer_get_time() / 1000); }
+inline int64_t micros() { return esp_timer_get_time(); }
+
+inline uint32_t cycleCount() {
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+    return esp_cpu_get_cycle_count();
+#else
+    return cpu_hal_get_cycle_count();
+#endif
+}
+
+inline const char* taskName() { return pcTaskGetName(nullptr); }
+inline bool inIsr() { return xPortInIsrContext(); }
+
+inline size_t consoleWrite(const char* data, size_t length) {
+    return Serial.write(reinterpret_cast<const uint8_t*>(data), length);
+}
+inline size_t consoleAvailableForWrite() {
+    int available = Serial.availableForWrite();
+    return available > 0 ? static_cast<size_t>(available) : 0;
+}
+inline void consoleFlush() { Serial.flush(); }
+
+/**
+ * @brief heap_caps allocation in PSRAM or internal RAM (no fallback)
+ */
+inline void* allocate(size_t bytes, bool psram) {
+    return heap_caps_malloc(bytes, (psram ? MALLOC_CAP_SPIRAM : MALLOC_CAP_INTERNAL) | MALLOC_CAP_8BIT);
+}
+inline void* allocateZeroed(size_t bytes, bool psram) {
+    return heap_caps_calloc(1, bytes, (psram ? MALLOC_CAP_SPIRAM : MALLOC_CAP_INTERNAL) | MALLOC_CAP_8BIT);
+}
+inline void release(void* memory) { heap_caps_free(memory); }
+
+}  // namespace LogPlatform
+
+#endif  // LOG_PLATFORM_NATIVE
+
+namespace LogPlatform {
+
+/**
+ * @brief printf() straight to the console, bypassing the Logger
+ * @note For stats dumps; lines longer than 160 bytes are cut off
+ */
+inline void consolePrintf(const char* format, ...) __attribute__((format(printf, 1, 2)));
+inline void consolePrintf(const char* format, ...) {
+    char line[160];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (length <= 0) return;
+    consoleWrite(line, static_cast<size_t>(length) < sizeof(line) ? static_cast<size_t>(length) : sizeof(line) - 1);
+}
+
+}  // namespace LogPlatform
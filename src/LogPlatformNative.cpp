@@ -0,0 +1,234 @@
+/*
+ * LogPlatformNative.cpp - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// LogPlatformNative.cpp
+// Host implementation of LogPlatform (std::thread / std::chrono) and of the esp_log.h shim
+
+#include "LogPlatform.h"
+
+#if defined(LOG_PLATFORM_NATIVE)
+
+#include <esp_log.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <sched.h>
+#include <thread>
+
+namespace LogPlatform {
+
+// Built from std::mutex + condition_variable rather than std::timed_mutex:
+// ThreadSanitizer does not intercept the timed lock and reports false races
+struct NativeMutex {
+    std::mutex mutex;
+    std::condition_variable released;
+    bool locked = false;
+};
+
+// Never freed: a handle must stay valid for late notifyTask() calls after the
+// task has ended, as a FreeRTOS handle does until it is reused
+struct NativeTask {
+    char name[16];
+    std::mutex mutex;
+    std::condition_variable wake;
+    uint32_t notifications = 0;
+};
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+const Clock::time_point bootTime = Clock::now();
+
+thread_local NativeTask* thisTask = nullptr;
+thread_local int isrDepth = 0;
+
+std::atomic<ConsoleSink> consoleSink{nullptr};
+std::atomic<size_t> consoleSpace{4096};
+
+NativeTask* newTask(const char* name) {
+    NativeTask* task = new NativeTask();
+    strncpy(task->name, name ? name : "?", sizeof(task->name) - 1);
+    task->name[sizeof(task->name) - 1] = '\0';
+    return task;
+}
+
+}  // namespace
+
+bool schedulerRunning() { return true; }
+
+size_t coreId() {
+    int cpu = sched_getcpu();
+    return cpu >= 0 ? static_cast<size_t>(cpu) % CORE_COUNT : 0;
+}
+
+MutexHandle createMutex() { return new NativeMutex(); }
+
+MutexHandle createMutex(MutexStorage& storage) {
+    static_assert(sizeof(NativeMutex) <= sizeof(MutexStorage), "MutexStorage too small for NativeMutex");
+    return new (storage.bytes) NativeMutex();
+}
+void deleteMutex(MutexHandle mutex) { delete mutex; }
+size_t mutexSize() { return sizeof(NativeMutex); }
+
+bool takeMutex(MutexHandle mutex, uint32_t timeoutMs) {
+    std::unique_lock<std::mutex> lock(mutex->mutex);
+    if (!mutex->released.wait_for(lock, std::chrono::milliseconds(timeoutMs), [mutex] { return !mutex->locked; })) {
+        return false;
+    }
+    mutex->locked = true;
+    return true;
+}
+
+void giveMutex(MutexHandle mutex) {
+    {
+        std::lock_guard<std::mutex> lock(mutex->mutex);
+        mutex->locked = false;
+    }
+    mutex->released.notify_one();
+}
+
+bool startTask(TaskFunction function, const char* name, uint32_t stackSize, void* param, uint32_t priority,
+               int coreId, TaskHandle* handle) {
+    // Stack size, priority and core affinity have no host equivalent
+    (void)stackSize;
+    (void)priority;
+    (void)coreId;
+
+    NativeTask* task = newTask(name);
+    if (handle) *handle = task;
+    std::thread([function, param, task]() {
+        thisTask = task;
+        function(param);
+    }).detach();
+    return true;
+}
+
+// The thread ends when the task function returns right after this
+void endTask() {}
+
+// A std::thread cannot be killed: a task that ignores its stop flag keeps running
+void killTask(TaskHandle task) { (void)task; }
+
+TaskHandle currentTask() {
+    if (!thisTask) thisTask = newTask("main");
+    return thisTask;
+}
+
+void notifyTask(TaskHandle task) {
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        task->notifications++;
+    }
+    task->wake.notify_one();
+}
+
+void waitNotify(uint32_t timeoutMs) {
+    NativeTask* task = currentTask();
+    std::unique_lock<std::mutex> lock(task->mutex);
+    task->wake.wait_for(lock, std::chrono::milliseconds(timeoutMs), [task] { return task->notifications > 0; });
+    task->notifications = 0;
+}
+
+void delayMs(uint32_t ms) {
+    if (ms == 0) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+}
+
+void yield() { std::this_thread::yield(); }
+
+uint32_t millis() {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - bootTime).count());
+}
+
+int64_t micros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - bootTime).count();
+}
+
+uint32_t cycleCount() {
+#if defined(__x86_64__) || defined(__i386__)
+    return static_cast<uint32_t>(__builtin_ia32_rdtsc());
+#else
+    // Nanoseconds stand in for cycles
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - bootTime).count());
+#endif
+}
+
+const char* taskName() { return currentTask()->name; }
+bool inIsr() { return isrDepth > 0; }
+
+IsrScope::IsrScope() { isrDepth++; }
+IsrScope::~IsrScope() { isrDepth--; }
+
+size_t consoleWrite(const char* data, size_t length) {
+    ConsoleSink sink = consoleSink.load();
+    if (sink) return sink(data, length);
+    return fwrite(data, 1, length, stdout);
+}
+
+size_t consoleAvailableForWrite() { return consoleSpace.load(); }
+void consoleFlush() { fflush(stdout); }
+
+void setConsoleSink(ConsoleSink sink, size_t available) {
+    consoleSink.store(sink);
+    consoleSpace.store(available);
+}
+
+// No PSRAM on a host: callers fall back to internal RAM
+void* allocate(size_t bytes, bool psram) { return psram ? nullptr : malloc(bytes); }
+void* allocateZeroed(size_t bytes, bool psram) { return psram ? nullptr : calloc(1, bytes); }
+void release(void* memory) { free(memory); }
+
+}  // namespace LogPlatform
+
+// esp_log.h shim: esp_log_write() goes through the installed vprintf, as in ESP-IDF
+
+static std::atomic<vprintf_like_t> espVprintf{&vprintf};
+
+extern "C" {
+
+void esp_log_write(esp_log_level_t level, const char* tag, const char* format, ...) {
+    (void)level;
+    (void)tag;
+    va_list args;
+    va_start(args, format);
+    espVprintf.load()(format, args);
+    va_end(args);
+}
+
+void esp_log_level_set(const char* tag, esp_log_level_t level) {
+    (void)tag;
+    (void)level;
+}
+
+vprintf_like_t esp_log_set_vprintf(vprintf_like_t func) { return espVprintf.exchange(func); }
+
+uint32_t esp_log_timestamp(void) { return LogPlatform::millis(); }
+
+}  // extern "C"
+
+#endif  // LOG_PLATFORM_NATIVE
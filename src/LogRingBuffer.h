@@ -0,0 +1,342 @@
+/*
+ * LogRingBuffer.h - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// LogRingBuffer.h
+// Lock-free multi-producer / single-consumer ring of variable-length records
+
+#pragma once
+
+#include "LogPlatform.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Lock-free MPSC byte ring for variable-length log records
+ *
+ * Producers reserve space with a single CAS on `head_`, copy their payload
+ * straight into the ring and then publish the record by storing its header
+ * word with release semantics. The consumer walks records from `tail_`,
+ * stopping at the first record that is reserved but not yet committed.
+ *
+ * Layout: each record is a 4-byte header followed by the payload, padded to
+ * 4 bytes. The header holds the reserved span (so a producer may commit
+ * fewer bytes than it reserved), the committed length and the flags.
+ * A record never wraps; if it does not fit before the end of the
+ * buffer a padding record fills the remainder. The consumer zeroes every
+ * consumed byte, so a header without FLAG_COMMITTED always means "still
+ * being written" rather than stale data.
+ *
+ * Memory: the storage may live in PSRAM (only aligned 32-bit loads/stores
+ * touch it). The CAS'd indices live inside this object, which must be in
+ * internal RAM - S32C1I does not work on external memory.
+ *
+ * Producers never block or wait; a full ring drops the record and counts
+ * an overflow. Only one task may consume at a time.
+ */
+class LogRingBuffer {
+public:
+    static constexpr size_t HEADER_SIZE = 4;
+    static constexpr size_t MAX_RECORD_SIZE = 0xFFF0;
+
+    LogRingBuffer() = default;
+    ~LogRingBuffer() { release(); }
+
+    LogRingBuffer(const LogRingBuffer&) = delete;
+    LogRingBuffer& operator=(const LogRingBuffer&) = delete;
+
+    /**
+     * @brief Allocate storage from the heap
+     * @param capacity Requested size in bytes (rounded down to a power of two)
+     * @param usePsram Prefer external PSRAM, falling back to internal RAM
+     * @return true if storage was allocated
+     */
+    bool init(size_t capacity, bool usePsram = false) {
+        capacity = floorPow2(capacity);
+        if (capacity < 64) return false;
+
+        uint8_t* storage = nullptr;
+        if (usePsram) {
+            storage = static_cast<uint8_t*>(LogPlatform::allocateZeroed(capacity, true));
+        }
+        if (!storage) {
+            storage = static_cast<uint8_t*>(LogPlatform::allocateZeroed(capacity, false));
+        }
+        if (!storage) return false;
+
+        attach(storage, capacity, true);
+        return true;
+    }
+
+    /**
+     * @brief Use caller-provided storage (e.g. a static array)
+     * @param storage Buffer, 4-byte aligned; zeroed here
+     * @param capacity Size in bytes (rounded down to a power of two)
+     */
+    bool init(uint8_t* storage, size_t capacity) {
+        capacity = floorPow2(capacity);
+        if (!storage || capacity < 64 || (reinterpret_cast<uintptr_t>(storage) & 3) != 0) return false;
+        memset(storage, 0, capacity);
+        attach(storage, capacity, false);
+        return true;
+    }
+
+    bool isInitialized() const { return buffer_ != nullptr; }
+
+    // ---- Producer side (any task, lock-free) ----
+
+    /**
+     * @brief Reserve space for a record
+     * @param length Payload size in bytes
+     * @return Pointer to payload space, or nullptr if the ring is full
+     * @note Must be followed by commit() with the same pointer. Reserve the
+     *       worst case and commit the actual length to avoid a second pass.
+     */
+    uint8_t* reserve(size_t length) {
+        if (!buffer_ || length > MAX_RECORD_SIZE) {
+            overflows_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        const uint32_t need = align4(HEADER_SIZE + length);
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        uint32_t offset;
+        uint32_t total;
+
+        for (;;) {
+            uint32_t tail = tail_.load(std::memory_order_acquire);
+            offset = head & mask_;
+            uint32_t toEnd = capacity_ - offset;
+            total = (need <= toEnd) ? need : toEnd + need;  // Pad to the end, then wrap
+
+            if (head + total - tail > capacity_) {
+                overflows_.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            if (head_.compare_exchange_weak(head, head + total,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_relaxed)) {
+                updateHighWater(head + total - tail);
+                break;
+            }
+        }
+
+        if (total != need) {
+            // Publish the padding record immediately - it carries no data
+            storeHeader(offset, FLAG_COMMITTED | FLAG_PADDING | spanBits(capacity_ - offset));
+            offset = 0;
+        }
+
+        // Uncommitted header: consumer ignores it until FLAG_COMMITTED is set
+        storeHeader(offset, spanBits(need));
+        return buffer_ + offset + HEADER_SIZE;
+    }
+
+    /**
+     * @brief Publish a reserved record
+     * @param payload Pointer returned by reserve()
+     * @param length Payload size; may be smaller than reserved, never larger
+     */
+    void commit(uint8_t* payload, size_t length) {
+        uint32_t offset = static_cast<uint32_t>(payload - buffer_) - HEADER_SIZE;
+        uint32_t span = loadHeader(offset) & SPAN_MASK;
+        storeHeader(offset, FLAG_COMMITTED | span | static_cast<uint32_t>(length));
+    }
+
+    /**
+     * @brief Convenience: reserve + copy + commit
+     */
+    bool push(const void* data, size_t length) {
+        uint8_t* payload = reserve(length);
+        if (!payload) return false;
+        memcpy(payload, data, length);
+        commit(payload, length);
+        return true;
+    }
+
+    // ---- Consumer side (single task) ----
+
+    /**
+     * @brief Get the next committed record without removing it
+     * @return false if the ring is empty or the oldest record is still being written
+     */
+    bool peek(const uint8_t*& data, size_t& length) {
+        uint32_t offset;
+        uint32_t header;
+        if (!nextRecord(offset, header)) return false;
+        data = buffer_ + offset + HEADER_SIZE;
+        length = header & LENGTH_MASK;
+        return true;
+    }
+
+    /**
+     * @brief Remove the record returned by the last successful peek()
+     */
+    void pop() {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        uint32_t offset = tail & mask_;
+        consume(tail, offset, spanOf(loadHeader(offset)));
+    }
+
+    /**
+     * @brief Start position for peekNext(): the oldest record
+     */
+    uint32_t cursor() const { return tail_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Look at the committed record at `cursor` and advance past it
+     *
+     * Lets the consumer collect several records before removing them; they
+     * stay valid (producers cannot reuse the space) until popUntil().
+     *
+     * @return false at the end of the committed records
+     */
+    bool peekNext(uint32_t& cursor, const uint8_t*& data, size_t& length) const {
+        for (;;) {
+            if (cursor == head_.load(std::memory_order_acquire)) return false;
+
+            uint32_t offset = cursor & mask_;
+            uint32_t header = loadHeader(offset);
+            if ((header & FLAG_COMMITTED) == 0) return false;  // Producer still copying
+
+            cursor += spanOf(header);
+            if (header & FLAG_PADDING) continue;
+
+            data = buffer_ + offset + HEADER_SIZE;
+            length = header & LENGTH_MASK;
+            return true;
+        }
+    }
+
+    /**
+     * @brief Remove every record before `cursor` (from peekNext())
+     */
+    void popUntil(uint32_t cursor) {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        while (tail != cursor) {
+            uint32_t offset = tail & mask_;
+            uint32_t total = spanOf(loadHeader(offset));
+            consume(tail, offset, total);
+            tail += total;
+        }
+    }
+
+    /**
+     * @brief Check if any space is reserved (committed or not)
+     */
+    bool hasPending() const {
+        return head_.load(std::memory_order_acquire) != tail_.load(std::memory_order_acquire);
+    }
+
+    // ---- Statistics ----
+    size_t capacity() const { return capacity_; }
+    size_t used() const {
+        return head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed);
+    }
+    size_t getHighWaterMark() const { return highWater_.load(std::memory_order_relaxed); }
+    uint32_t getOverflowCount() const { return overflows_.load(std::memory_order_relaxed); }
+    void resetStats() {
+        highWater_.store(used(), std::memory_order_relaxed);
+        overflows_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr uint32_t FLAG_COMMITTED = 0x80000000u;
+    static constexpr uint32_t FLAG_PADDING = 0x40000000u;
+    static constexpr uint32_t SPAN_MASK = 0x3FFF0000u;    // Reserved bytes / 4
+    static constexpr uint32_t LENGTH_MASK = 0x0000FFFFu;  // Committed payload bytes
+
+    static uint32_t spanBits(uint32_t total) { return (total >> 2) << 16; }
+    static uint32_t spanOf(uint32_t header) { return ((header & SPAN_MASK) >> 16) << 2; }
+
+    static uint32_t align4(size_t n) { return static_cast<uint32_t>((n + 3) & ~static_cast<size_t>(3)); }
+    static size_t floorPow2(size_t n) {
+        size_t p = 1;
+        while (p <= n / 2) p <<= 1;
+        return n == 0 ? 0 : p;
+    }
+
+    void attach(uint8_t* storage, size_t capacity, bool owned) {
+        release();
+        buffer_ = storage;
+        capacity_ = static_cast<uint32_t>(capacity);
+        mask_ = capacity_ - 1;
+        ownsBuffer_ = owned;
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_release);
+    }
+
+    void release() {
+        if (buffer_ && ownsBuffer_) LogPlatform::release(buffer_);
+        buffer_ = nullptr;
+        capacity_ = 0;
+        mask_ = 0;
+    }
+
+    uint32_t loadHeader(uint32_t offset) const {
+        return __atomic_load_n(reinterpret_cast<uint32_t*>(buffer_ + offset), __ATOMIC_ACQUIRE);
+    }
+    void storeHeader(uint32_t offset, uint32_t value) {
+        __atomic_store_n(reinterpret_cast<uint32_t*>(buffer_ + offset), value, __ATOMIC_RELEASE);
+    }
+
+    // Find the next committed data record, skipping (and consuming) padding
+    bool nextRecord(uint32_t& offset, uint32_t& header) {
+        for (;;) {
+            uint32_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail == head_.load(std::memory_order_acquire)) return false;
+
+            offset = tail & mask_;
+            header = loadHeader(offset);
+            if ((header & FLAG_COMMITTED) == 0) return false;  // Producer still copying
+
+            if (header & FLAG_PADDING) {
+                consume(tail, offset, spanOf(header));
+                continue;
+            }
+            return true;
+        }
+    }
+
+    void consume(uint32_t tail, uint32_t offset, uint32_t total) {
+        // Zero before handing the space back so stale bytes never look like a header
+        memset(buffer_ + offset, 0, total);
+        tail_.store(tail + total, std::memory_order_release);
+    }
+
+    void updateHighWater(size_t usedBytes) {
+        size_t current = highWater_.load(std::memory_order_relaxed);
+        while (usedBytes > current &&
+               !highWater_.compare_exchange_weak(current, usedBytes, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint8_t* buffer_ = nullptr;
+    uint32_t capacity_ = 0;
+    uint32_t mask_ = 0;
+    bool ownsBuffer_ = false;
+
+    std::atomic<uint32_t> head_{0};   // Next byte to reserve (free-running)
+    std::atomic<uint32_t> tail_{0};   // Next byte to consume (free-running)
+    std::atomic<size_t> highWater_{0};
+    std::atomic<uint32_t> overflows_{0};
+};
@@ -0,0 +1,107 @@
+/*
+ * LogSampler.h - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+
+// LogSampler.h
+// Lock-free per-tag sampling of verbose levels (1 in N and/or a budget)
+
+#pragma once
+
+#include <esp_log.h>
+#include <atomic>
+#include <cstdint>
+#include "RateBucket.h"
+
+/**
+ * @brief Keeps a sample of a tag's messages at and below one severity
+ *
+ * Messages at `level` or more verbose are sampled, more severe ones always
+ * pass: with level DEBUG, DEBUG and VERBOSE lines are sampled while INFO,
+ * WARN and ERROR are untouched. Two rules, both optional:
+ * - ratio: keep `keep` of every `outOf` messages, counted by one atomic
+ *   fetch_add (deterministic, no random numbers)
+ * - budget: at most `perSecond` of them (a RateBucket), applied to what the
+ *   ratio kept
+ *
+ * Zero-initialised means off, so it can live in TagLevelTable's entries.
+ * sample() is safe from any number of tasks and ISRs at once; configure
+ * calls are serialized by the caller (Logger's tagMutex).
+ */
+class LogSampler {
+public:
+    LogSampler() = default;
+
+    // Non-copyable (shared between tasks by reference)
+    LogSampler(const LogSampler&) = delete;
+    LogSampler& operator=(const LogSampler&) = delete;
+
+    /**
+     * @brief Keep `keep` of every `outOf` messages at `level` and below
+     * @note outOf 0 (or keep >= outOf) turns the ratio off
+     */
+    void configureRatio(esp_log_level_t level, uint32_t keep, uint32_t outOf) {
+        if (outOf == 0 || keep >= outOf) keep = outOf = 0;
+        keep_.store(keep, std::memory_order_relaxed);
+        outOf_.store(outOf, std::memory_order_relaxed);
+        counter_.store(0, std::memory_order_relaxed);
+        updateLevel(level);
+    }
+
+    /**
+     * @brief Let at most `perSecond` messages at `level` and below through
+     * @param burst Back-to-back messages (0 = one second's worth)
+     * @note perSecond 0 turns the budget off
+     */
+    void configureBudget(esp_log_level_t level, uint32_t perSecond, uint32_t burst = 0) {
+        budget_.configure(perSecond, burst);
+        budget_.reset();
+        updateLevel(level);
+    }
+
+    bool isActive() const { return level_.load(std::memory_order_relaxed) != ESP_LOG_NONE; }
+
+    /**
+     * @return true if the message is kept
+     */
+    bool sample(esp_log_level_t level, uint32_t nowUs) {
+        uint8_t sampled = level_.load(std::memory_order_relaxed);
+        if (sampled == ESP_LOG_NONE || level < sampled) return true;
+
+        uint32_t outOf = outOf_.load(std::memory_order_relaxed);
+        if (outOf && counter_.fetch_add(1, std::memory_order_relaxed) % outOf >= keep_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        return budget_.tryAcquire(nowUs);
+    }
+
+private:
+    // Off once neither rule is left
+    void updateLevel(esp_log_level_t level) {
+        bool active = outOf_.load(std::memory_order_relaxed) != 0 || budget_.isLimited();
+        level_.store(static_cast<uint8_t>(active ? level : ESP_LOG_NONE), std::memory_order_relaxed);
+    }
+
+    std::atomic<uint8_t> level_{ESP_LOG_NONE};  // Most severe sampled level, NONE = off
+    std::atomic<uint32_t> keep_{0};
+    std::atomic<uint32_t> outOf_{0};             // 0 = no ratio
+    std::atomic<uint32_t> counter_{0};
+    RateBucket budget_;
+};
@@ -0,0 +1,155 @@
+/*
+ * LogStats.h - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// LogStats.h
+// Optional hot-path instrumentation: per-stage cycle histograms, per-tag counters
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "LogPlatform.h"
+
+#ifndef CONFIG_LOG_INSTRUMENTATION
+#define CONFIG_LOG_INSTRUMENTATION 0  // 1 = time every log stage with the CPU cycle counter
+#endif
+
+#ifndef CONFIG_LOG_STATS_BUCKETS
+#define CONFIG_LOG_STATS_BUCKETS 20  // log2 cycle buckets; the last one collects everything longer
+#endif
+
+#ifndef CONFIG_LOG_MAX_TAGS
+#define CONFIG_LOG_MAX_TAGS 32      // Maximum number of tag-specific levels
+#endif
+
+#if CONFIG_LOG_INSTRUMENTATION
+#define LOG_STATS_CYCLES() LogPlatform::cycleCount()
+#endif
+
+// Stages of one log call, in the order they run
+enum class LogStage : uint8_t {
+    FILTER,       // Level / tag filter
+    RATE_LIMIT,   // checkRateLimit(): throttle, tag, level and global budgets
+    ACQUIRE,      // BufferPool::acquire()
+    ENVELOPE,     // "[time][task][L] tag: "
+    FORMAT,       // vsnprintf() or the "{}" renderer
+    SUBSCRIBERS,  // notifySubscribers()
+    BACKENDS,     // writeToBackends()
+    COUNT
+};
+
+/**
+ * @brief Cycle histogram of one stage
+ *
+ * buckets[i] counts calls that took [2^i, 2^(i+1)) cycles (bucket 0 also
+ * takes 0 and 1); the last bucket collects everything longer. Cycles count
+ * on the core that ran the stage, and include any time the task was
+ * preempted in between.
+ */
+struct LogStageStats {
+    uint32_t count;
+    uint32_t maxCycles;
+    uint32_t buckets[CONFIG_LOG_STATS_BUCKETS];
+};
+
+struct LogTagStats {
+    const char* tag;    // Registry name, valid forever
+    uint32_t messages;  // Lines written to the backends
+    uint32_t bytes;     // Their length, envelope and line ending included
+};
+
+/**
+ * @brief Snapshot returned by Logger::getStats()
+ * @note About 1 KB with the default sizes - keep it off small task stacks
+ */
+struct LogStats {
+    static constexpr size_t STAGE_COUNT = static_cast<size_t>(LogStage::COUNT);
+    static constexpr size_t BUCKET_COUNT = CONFIG_LOG_STATS_BUCKETS;
+
+    LogStageStats stages[STAGE_COUNT];
+    LogTagStats tags[CONFIG_LOG_MAX_TAGS];
+    size_t tagCount;
+
+    const LogStageStats& stage(LogStage s) const { return stages[static_cast<size_t>(s)]; }
+
+    static const char* stageName(LogStage s) {
+        switch (s) {
+            case LogStage::FILTER:      return "filter";
+            case LogStage::RATE_LIMIT:  return "rate_limit";
+            case LogStage::ACQUIRE:     return "acquire";
+            case LogStage::ENVELOPE:    return "envelope";
+            case LogStage::FORMAT:      return "format";
+            case LogStage::SUBSCRIBERS: return "subscribers";
+            case LogStage::BACKENDS:    return "backends";
+            default:                    return "?";
+        }
+    }
+};
+
+#if CONFIG_LOG_INSTRUMENTATION
+/**
+ * @brief Lock-free recorder behind LogStats (relaxed atomics, ISR-safe)
+ */
+class LogStageRecorder {
+public:
+    void record(LogStage stage, uint32_t cycles) {
+        Stage& s = stages_[static_cast<size_t>(stage)];
+        s.count.fetch_add(1, std::memory_order_relaxed);
+        s.buckets[bucketOf(cycles)].fetch_add(1, std::memory_order_relaxed);
+
+        uint32_t max = s.maxCycles.load(std::memory_order_relaxed);
+        while (cycles > max && !s.maxCycles.compare_exchange_weak(max, cycles, std::memory_order_relaxed)) {
+        }
+    }
+
+    void snapshot(LogStats& out) const {
+        for (size_t i = 0; i < LogStats::STAGE_COUNT; i++) {
+            out.stages[i].count = stages_[i].count.load(std::memory_order_relaxed);
+            out.stages[i].maxCycles = stages_[i].maxCycles.load(std::memory_order_relaxed);
+            for (size_t b = 0; b < LogStats::BUCKET_COUNT; b++) {
+                out.stages[i].buckets[b] = stages_[i].buckets[b].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void reset() {
+        for (Stage& s : stages_) {
+            s.count.store(0, std::memory_order_relaxed);
+            s.maxCycles.store(0, std::memory_order_relaxed);
+            for (auto& bucket : s.buckets) bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    static size_t bucketOf(uint32_t cycles) {
+        size_t bucket = cycles > 1 ? 31 - __builtin_clz(cycles) : 0;
+        return bucket < LogStats::BUCKET_COUNT ? bucket : LogStats::BUCKET_COUNT - 1;
+    }
+
+    struct Stage {
+        std::atomic<uint32_t> count{0};
+        std::atomic<uint32_t> maxCycles{0};
+        std::atomic<uint32_t> buckets[CONFIG_LOG_STATS_BUCKETS] = {};
+    };
+    Stage stages_[LogStats::STAGE_COUNT];
+};
+#endif
@@ -0,0 +1,70 @@
+/*
+ * LogTag.h - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// LogTag.h
+// Compile-time interned tags: 32-bit FNV-1a IDs computed by the compiler
+// C++11 compatible (recursive constexpr), no dependency on Logger.h
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+#ifndef CONFIG_LOG_SUBSCRIBER_TAG_SIZE
+#define CONFIG_LOG_SUBSCRIBER_TAG_SIZE 32  // Max tag length in queued messages
+#endif
+
+/**
+ * @brief FNV-1a over the first CONFIG_LOG_SUBSCRIBER_TAG_SIZE - 1 characters
+ *
+ * Must stay bit-identical to TagLevelTable::hash(). 0 is reserved for
+ * "no tag ID" and is remapped to 1.
+ */
+constexpr uint32_t logTagHashStep(const char* s, size_t i, uint32_t h) {
+    return (i >= CONFIG_LOG_SUBSCRIBER_TAG_SIZE - 1 || s[i] == '\0')
+        ? (h == 0 ? 1u : h)
+        : logTagHashStep(s, i + 1, (h ^ static_cast<uint8_t>(s[i])) * 16777619u);
+}
+
+constexpr uint32_t logTagHash(const char* s) {
+    return logTagHashStep(s, 0, 2166136261u);
+}
+
+/**
+ * @brief Tag with a precomputed ID
+ *
+ * Filtering and the subscriber queue key on `id`; `name` is kept for
+ * display and for registering the tag in Logger's tag registry.
+ *
+ * Usage:
+ *   static constexpr LogTag TAG = LOG_TAG_ID("ModbusRTU");
+ *   logger.log(ESP_LOG_INFO, TAG, "Frame %u", n);
+ */
+struct LogTag {
+    uint32_t id;
+    const char* name;
+
+    constexpr LogTag(uint32_t tagId, const char* tagName) : id(tagId), name(tagName) {}
+};
+
+// integral_constant forces the hash to be evaluated at compile time
+#define LOG_TAG_ID(name) LogTag(std::integral_constant<uint32_t, logTagHash(name)>::value, name)
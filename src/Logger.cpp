@@ -28,8 +28,25 @@
 #include "NonBlockingConsoleBackend.h"
 #include <cstring>
 #include <algorithm>
+#include <new>
 #include <esp_log.h>
-#include <soc/soc.h>  // For SOC_DRAM_LOW, SOC_DRAM_HIGH
+
+// Bytes kept free after the body for the "\r\n" line ending
+static constexpr size_t LINE_END_RESERVE = 2;
+
+// configMAX_TASK_NAME_LEN on ESP32
+static constexpr size_t TASK_NAME_SIZE = 16;
+
+namespace {
+// Per-task envelope data, looked up on a task's first line instead of every line
+struct TaskStamp {
+    const char* name;  // Points into the task's TCB, valid for the task's lifetime
+    uint8_t length;
+    uint16_t id;
+};
+thread_local TaskStamp currentTask = {nullptr, 0, 0};
+std::atomic<uint16_t> nextTaskId{1};
+}  // namespace
 
 // Helper to check if pointer is in readable memory (DRAM or flash-mapped)
 // Supports ESP32, ESP32-S2, ESP32-S3, ESP32-C3, ESP32-C6
@@ -68,82 +85,314 @@ static inline bool isPointerReadable(const void* ptr) {
 #endif
 }
 
+// Envelope "[ts][task][L] tag: " plus the format's literal text and a guess per conversion
+static size_t estimateLineLength(const char* tag, size_t taskLength, const char* format) {
+    size_t length = 20 + (taskLength ? taskLength : 1) + (tag ? strlen(tag) : 1) + LINE_END_RESERVE + 1;
+    for (const char* p = format; *p; p++) {
+        if (*p != '%') {
+            length++;
+        } else if (p[1] == '%') {
+            length++;
+            p++;
+        } else {
+            length += 12;  // Typical printed width of one argument
+        }
+    }
+    return length;
+}
+
+// ESP-IDF line as built by LOG_FORMAT(): [color] L " (%lu) %s: " body [reset] "\n".
+// The timestamp may also be "%s" (CONFIG_LOG_TIMESTAMP_SOURCE_SYSTEM).
+struct Logger::IdfLine {
+    esp_log_level_t level;
+    const char* tag;
+    const char* body;     // Message format after the prefix (still in flash)
+    size_t prefixLength;  // Printed length of the prefix, color included
+};
+
+static esp_log_level_t levelFromLetter(char letter) {
+    switch (letter) {
+        case 'E': return ESP_LOG_ERROR;
+        case 'W': return ESP_LOG_WARN;
+        case 'I': return ESP_LOG_INFO;
+        case 'D': return ESP_LOG_DEBUG;
+        case 'V': return ESP_LOG_VERBOSE;
+        default:  return ESP_LOG_NONE;
+    }
+}
+
+static size_t decimalDigits(uint32_t value) {
+    size_t digits = 1;
+    while (value >= 10) {
+        value /= 10;
+        digits++;
+    }
+    return digits;
+}
+
+// Recognize the prefix without formatting; on success ap points at the message arguments
+bool Logger::parseIdfLine(const char* format, va_list& ap, IdfLine& line) {
+    const char* p = format;
+    if (*p == '\033') {  // LOG_COLOR_x, e.g. "\033[0;31m"
+        while (*p && *p != 'm') p++;
+        if (!*p) return false;
+        p++;
+    }
+
+    line.level = levelFromLetter(*p);
+    if (line.level == ESP_LOG_NONE || p[1] != ' ' || p[2] != '(' || p[3] != '%') return false;
+
+    const char* close = p + 4;
+    while (*close && *close != ')') close++;
+    if (strncmp(close, ") %s: ", 6) != 0) return false;
+
+    size_t timestampLength;
+    if (close[-1] == 's') {
+        const char* timestamp = va_arg(ap, const char*);
+        timestampLength = timestamp ? strlen(timestamp) : 6;  // "(null)"
+    } else {
+        timestampLength = decimalDigits(va_arg(ap, uint32_t));
+    }
+    line.tag = va_arg(ap, const char*);
+    if (!line.tag) return false;
+
+    line.body = close + 6;
+    line.prefixLength = (p - format) + 3 + timestampLength + 2 + strlen(line.tag) + 2;
+    return true;
+}
+
 // ESP-IDF log redirection function
-static int esp_log_redirect(const char* format, va_list args) {
+int Logger::espLogRedirect(const char* format, va_list args) {
     // Validate format pointer - ESP-IDF internal components may pass invalid pointers
     // (e.g., from IRAM/ROM) that cause LoadProhibited exceptions when accessed
     if (!format || !isPointerReadable(format)) {
         return 0;
     }
 
-    // Get the logger instance
     Logger& logger = Logger::getInstance();
 
-    // Use buffer pool instead of thread-local to reduce per-thread overhead
-    // Small fixed buffer for tag extraction (on stack, only 33 bytes)
-    char tag_buffer[CONFIG_LOG_SUBSCRIBER_TAG_SIZE + 1];
+    IdfLine line;
+    va_list bodyArgs;
+    va_copy(bodyArgs, args);
+    if (parseIdfLine(format, bodyArgs, line)) {
+        // Filter on the real level and tag before anything is formatted
+        if (logger.isLevelEnabledForTag(line.tag, line.level)) {
+            logger.logIdfLine(line, format, args, bodyArgs);
+        }
+    } else {
+        // Raw esp_log_write() text carries no level or tag of its own
+        logger.logV(ESP_LOG_INFO, "ESP", format, args);
+    }
+    va_end(bodyArgs);
+
+    return 0;  // Return value is ignored by ESP-IDF
+}
+
+// Length of a trailing newline and/or LOG_RESET_COLOR ("\033[0m")
+static size_t idfLineEndLength(const char* text, size_t length) {
+    size_t end = length;
+    while (end > 0 && (text[end - 1] == '\n' || text[end - 1] == '\r')) end--;
+    if (end >= 4 && memcmp(text + end - 4, "\033[0m", 4) == 0) end -= 4;
+    return length - end;
+}
+
+void Logger::logIdfLine(const IdfLine& line, const char* format, va_list args, va_list bodyArgs) {
+    if (!checkRateLimit(line.level, line.tag, 0)) return;
 
-    // Extract tag and format from ESP-IDF log format
-    // ESP-IDF format is typically: "TAG: message" or just "message"
-    const char* tag = "ESP";
-    const char* msg_start = format;
+    // Binary backends encode the message format alone - the prefix is rebuilt by the decoder
+    bool unformattedDone = false;
+    if (unformattedBackends_.load() != 0 && DeferredFormat::isInFlash(line.body)) {
+        va_list copy;
+        va_copy(copy, bodyArgs);
+        writeUnformattedToBackends(line.level, line.tag, line.body, copy);
+        va_end(copy);
+        unformattedDone = true;
 
-    // Look for colon to extract tag
-    const char* colon = strchr(format, ':');
-    if (colon && (colon - format) < CONFIG_LOG_SUBSCRIBER_TAG_SIZE) {
-        // Extract tag
-        size_t tag_len = colon - format;
-        memcpy(tag_buffer, format, tag_len);
-        tag_buffer[tag_len] = '\0';
-        tag = tag_buffer;
-        msg_start = colon + 1;
-        while (*msg_start == ' ') msg_start++;  // Skip spaces after colon
+        if (textBackends_.load() == 0 && subscriberCount.load() == 0) return;
     }
 
-    // Use logger to output the message
-    logger.logV(ESP_LOG_INFO, tag, msg_start, args);
+    // Deferred: only the message is captured; LogFmt adds our envelope instead of IDF's
+    if (deferredTaskHandle && logDeferred(line.level, line.tag, 0, line.body, bodyArgs, unformattedDone, true)) return;
 
-    return 0;  // Return value is ignored by ESP-IDF
+    // Otherwise format once, keeping IDF's own envelope
+    auto& pool = BufferPool::getInstance();
+    size_t capacity;
+    char* buffer = pool.acquire(estimateLineLength(line.tag, 0, format), capacity);
+    if (!buffer) return;
+
+    va_list copy;
+    va_copy(copy, args);
+    int needed = vsnprintf(buffer, capacity - LINE_END_RESERVE, format, copy);
+    va_end(copy);
+    if (needed < 0) needed = 0;
+
+    if (static_cast<size_t>(needed) >= capacity - LINE_END_RESERVE && capacity < BufferPool::LARGE_BUFFER_SIZE) {
+        size_t biggerCapacity;
+        char* bigger = pool.acquire(needed + LINE_END_RESERVE + 1, biggerCapacity);
+        if (bigger && biggerCapacity > capacity) {
+            pool.release(buffer);
+            buffer = bigger;
+            capacity = biggerCapacity;
+            va_copy(copy, args);
+            vsnprintf(buffer, capacity - LINE_END_RESERVE, format, copy);
+            va_end(copy);
+        } else if (bigger) {
+            pool.release(bigger);
+        }
+    }
+    size_t length = std::min<size_t>(needed, capacity - LINE_END_RESERVE - 1);
+
+    // Subscribers get the body alone; backends get IDF's line end back unchanged
+    char lineEnd[8] = "\r\n";
+    size_t endLength = idfLineEndLength(buffer, length);
+    if (endLength > 0 && endLength < sizeof(lineEnd)) {
+        memcpy(lineEnd, buffer + length - endLength, endLength);
+        lineEnd[endLength] = '\0';
+        length -= endLength;
+    }
+    size_t bodyOffset = std::min(line.prefixLength, length);
+    buffer[length] = '\0';
+
+    outputMessage(line.level, line.tag, 0, buffer, bodyOffset, length - bodyOffset, lineEnd, unformattedDone);
+
+    pool.release(buffer);
 }
 
 // BufferPool implementation
-BufferPool::BufferPool() : poolMutex(nullptr) {
-    // Only create mutex if FreeRTOS scheduler is running
-    // This prevents issues if Logger is used before scheduler starts
-    if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) {
-        poolMutex = xSemaphoreCreateMutex();
+constexpr size_t BufferPool::BUFFER_SIZE;  // Bound by reference (std::max) - needs a definition in C++11
+
+BufferPool::BufferPool() {
+    initClass(classes_[0], smallStorage_[0], SMALL_BUFFER_SIZE, CONFIG_LOG_BUFFER_SMALL_COUNT, false);
+    initClass(classes_[1], mediumStorage_[0], BUFFER_SIZE, POOL_SIZE, false);
+
+    // Large buffers: one allocation for the program's lifetime, PSRAM preferred
+    char* large = nullptr;
+    bool inPsram = false;
+#if CONFIG_LOG_STATIC_ALLOCATION
+    if (CONFIG_LOG_BUFFER_LARGE_COUNT > 0) large = largeStorage_[0];
+#else
+    if (CONFIG_LOG_BUFFER_LARGE_COUNT > 0) {
+        const size_t bytes = LARGE_BUFFER_SIZE * CONFIG_LOG_BUFFER_LARGE_COUNT;
+        if (CONFIG_LOG_BUFFER_LARGE_PSRAM) {
+            large = static_cast<char*>(LogPlatform::allocate(bytes, true));
+            inPsram = large != nullptr;
+        }
+        if (!large) {
+            large = static_cast<char*>(LogPlatform::allocate(bytes, false));
+        }
+    }
+#endif
+    initClass(classes_[2], large, LARGE_BUFFER_SIZE, large ? CONFIG_LOG_BUFFER_LARGE_COUNT : 0, inPsram);
+}
+
+void BufferPool::initClass(Class& cls, char* storage, size_t bufferSize, size_t count, bool inPsram) {
+    cls.storage = storage;
+    cls.bufferSize = bufferSize;
+    cls.count = count;
+    cls.inPsram = inPsram;
+
+    uint32_t masks[CORE_COUNT] = {};
+    for (size_t slot = 0; slot < count; slot++) {
+        masks[slot % CORE_COUNT] |= 1u << (slot / CORE_COUNT);
     }
-    // Pool array is zero-initialized by default
+    for (size_t core = 0; core < CORE_COUNT; core++) {
+        cls.freeMask[core].store(masks[core], std::memory_order_relaxed);
+    }
+    cls.inUse.store(0, std::memory_order_relaxed);
+    cls.peakInUse.store(0, std::memory_order_relaxed);
+    cls.acquires.store(0, std::memory_order_relaxed);
+    cls.exhausted.store(0, std::memory_order_relaxed);
 }
 
-char* BufferPool::acquire() {
-    if (!poolMutex) {
-        return (char*)malloc(BUFFER_SIZE);
+char* BufferPool::tryAcquire(Class& cls) {
+    // Own core's slots first, then steal from the others
+    size_t home = CORE_COUNT > 1 ? LogPlatform::coreId() % CORE_COUNT : 0;
+    for (size_t n = 0; n < CORE_COUNT; n++) {
+        size_t core = (home + n) % CORE_COUNT;
+        uint32_t mask = cls.freeMask[core].load(std::memory_order_relaxed);
+        while (mask) {
+            uint32_t bit = mask & (~mask + 1);  // Lowest free slot
+            if (cls.freeMask[core].compare_exchange_weak(mask, mask & ~bit,
+                                                         std::memory_order_acquire, std::memory_order_relaxed)) {
+                uint32_t inUse = cls.inUse.fetch_add(1, std::memory_order_relaxed) + 1;
+                uint32_t peak = cls.peakInUse.load(std::memory_order_relaxed);
+                while (inUse > peak && !cls.peakInUse.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) {
+                }
+                cls.acquires.fetch_add(1, std::memory_order_relaxed);
+                return cls.storage + (__builtin_ctz(bit) * CORE_COUNT + core) * cls.bufferSize;
+            }
+        }
+    }
+    return nullptr;
+}
+
+char* BufferPool::acquireFrom(size_t first, size_t& capacity) {
+    // Smallest fitting class first, then move up while classes are empty
+    for (size_t i = first; i < CLASS_COUNT; i++) {
+        char* buffer = tryAcquire(classes_[i]);
+        if (buffer) {
+            capacity = classes_[i].bufferSize;
+            return buffer;
+        }
+        if (i == first) classes_[i].exhausted.fetch_add(1, std::memory_order_relaxed);
     }
 
-    // Always use mutex to prevent race conditions
-    if (xSemaphoreTake(poolMutex, pdMS_TO_TICKS(LoggerConfig::MUTEX_STANDARD_TIMEOUT_MS)) == pdTRUE) {
-        for (auto& buffer : pool) {
-            bool expected = false;
-            if (buffer.inUse.compare_exchange_strong(expected, true)) {
-                xSemaphoreGive(poolMutex);
-                return buffer.data;
+    ExhaustionPolicy policy = policy_.load(std::memory_order_relaxed);
+    bool inIsr = LogPlatform::inIsr();
+
+    if (policy == ExhaustionPolicy::SPIN && !inIsr) {
+        // Give the holders a chance to finish (equal or higher priority only)
+        for (int retry = 0; retry < CONFIG_LOG_BUFFER_SPIN_RETRIES; retry++) {
+            LogPlatform::yield();
+            for (size_t i = first; i < CLASS_COUNT; i++) {
+                char* buffer = tryAcquire(classes_[i]);
+                if (buffer) {
+                    capacity = classes_[i].bufferSize;
+                    return buffer;
+                }
             }
         }
-        xSemaphoreGive(poolMutex);
+    } else if (policy == ExhaustionPolicy::HEAP_FALLBACK && !inIsr) {
+        size_t size = std::max(classes_[first].bufferSize, BUFFER_SIZE);
+        char* buffer = static_cast<char*>(malloc(size));
+        if (buffer) {
+            heapFallbacks_.fetch_add(1, std::memory_order_relaxed);
+            capacity = size;
+            return buffer;
+        }
     }
 
-    // No buffer available - fallback to heap allocation
-    return (char*)malloc(BUFFER_SIZE);
+    droppedAcquires_.fetch_add(1, std::memory_order_relaxed);
+    capacity = 0;
+    return nullptr;
+}
+
+char* BufferPool::acquire() {
+    size_t capacity;
+    return acquire(BUFFER_SIZE, capacity);
+}
+
+char* BufferPool::acquire(size_t minSize, size_t& capacity) {
+    size_t first = 0;
+    while (first < CLASS_COUNT - 1 && (classes_[first].count == 0 || classes_[first].bufferSize < minSize)) {
+        first++;
+    }
+    // Requests for more than LARGE get LARGE (or MEDIUM if LARGE is disabled)
+    if (classes_[first].count == 0) first = static_cast<size_t>(SizeClass::MEDIUM);
+    return acquireFrom(first, capacity);
 }
 
 void BufferPool::release(char* buffer) {
     if (!buffer) return;
 
-    // Check if it's from our pool
-    for (auto& poolBuffer : pool) {
-        if (buffer == poolBuffer.data) {
-            poolBuffer.inUse.store(false);
+    // Pool slot? Class and index follow from the address - no scan needed
+    uintptr_t addr = reinterpret_cast<uintptr_t>(buffer);
+    for (auto& cls : classes_) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(cls.storage);
+        if (cls.count && addr >= base && addr < base + cls.bufferSize * cls.count) {
+            size_t slot = (addr - base) / cls.bufferSize;
+            cls.inUse.fetch_sub(1, std::memory_order_relaxed);
+            cls.freeMask[slot % CORE_COUNT].fetch_or(1u << (slot / CORE_COUNT), std::memory_order_release);
             return;
         }
     }
@@ -152,54 +401,125 @@ void BufferPool::release(char* buffer) {
     free(buffer);
 }
 
-// Helper to safely create mutex (returns nullptr if scheduler not running)
-static SemaphoreHandle_t createMutexSafe() {
-    if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) {
-        return xSemaphoreCreateMutex();
+size_t BufferPool::getFreeCount(SizeClass sizeClass) const {
+    const Class& cls = classes_[static_cast<size_t>(sizeClass)];
+    size_t count = 0;
+    for (size_t core = 0; core < CORE_COUNT; core++) {
+        count += __builtin_popcount(cls.freeMask[core].load(std::memory_order_relaxed));
     }
-    return nullptr;
+    return count;
+}
+
+BufferPool::ClassStats BufferPool::getClassStats(SizeClass sizeClass) const {
+    const Class& cls = classes_[static_cast<size_t>(sizeClass)];
+    ClassStats stats;
+    stats.bufferSize = cls.bufferSize;
+    stats.count = cls.count;
+    stats.inUse = cls.count - getFreeCount(sizeClass);
+    stats.peakInUse = cls.peakInUse.load(std::memory_order_relaxed);
+    stats.acquires = cls.acquires.load(std::memory_order_relaxed);
+    stats.exhausted = cls.exhausted.load(std::memory_order_relaxed);
+    stats.inPsram = cls.inPsram;
+    return stats;
+}
+
+void BufferPool::resetStats() {
+    heapFallbacks_.store(0);
+    droppedAcquires_.store(0);
+    for (size_t i = 0; i < CLASS_COUNT; i++) {
+        classes_[i].peakInUse.store(classes_[i].inUse.load());  // Peak restarts from current use
+        classes_[i].acquires.store(0);
+        classes_[i].exhausted.store(0);
+    }
+}
+
+// Configuration generation read by the LOG_WRITE call site cache (LogInterface.h).
+// Plain uint32_t with __atomic builtins so it can be shared with C-compatible code.
+extern "C" {
+uint32_t custom_log_config_generation = 1;
+}
+
+void Logger::bumpConfigGeneration() {
+    uint32_t next = __atomic_add_fetch(&custom_log_config_generation, 1, __ATOMIC_RELEASE);
+    // Call sites store 24 bits of generation; 0 is reserved for "not resolved yet"
+    if ((next & 0x00FFFFFFu) == 0) {
+        __atomic_add_fetch(&custom_log_config_generation, 1, __ATOMIC_RELEASE);
+    }
+}
+
+// Writer mutexes are created by the first writer once the scheduler runs.
+// Before that there is a single task and nothing to serialize, so nullptr
+// means "no lock needed".
+static LogPlatform::MutexHandle writerMutex(std::atomic<LogPlatform::MutexHandle>& slot) {
+    if (!LogPlatform::schedulerRunning()) return nullptr;
+    LogPlatform::MutexHandle mutex = slot.load(std::memory_order_acquire);
+    if (mutex || CONFIG_LOG_STATIC_ALLOCATION || LogPlatform::inIsr()) return mutex;
+
+    LogPlatform::MutexHandle created = LogPlatform::createMutex();
+    if (!created) return nullptr;
+    if (!slot.compare_exchange_strong(mutex, created, std::memory_order_acq_rel)) {
+        LogPlatform::deleteMutex(created);  // Another writer won - use theirs
+        return mutex;
+    }
+    return created;
 }
 
 // Logger implementation
-Logger::Logger()
-    : backendMutex(createMutexSafe()),
-      subscriberMutex(createMutexSafe()),
-      tagMutex(createMutexSafe()),
-      rateLimitMutex(createMutexSafe()),
-      lastLogTime(0),
-      logCounter(0) {
+Logger::Logger() {
+    initStaticStorage();
+    globalRate_.configure(MAX_LOGS_PER_SECOND);
+#if CONFIG_LOG_DEFAULT_BACKEND
     // Add default non-blocking console backend to prevent freezes
-    backends.push_back(std::make_shared<NonBlockingConsoleBackend>());
-
-    // Initialize tag levels array
-    memset(tagLevels_, 0, sizeof(tagLevels_));
+    BackendList* list = idleBackendList(nullptr);
+    list->items.push_back(std::make_shared<NonBlockingConsoleBackend>());
+    publishBackends(list);
+#endif
 }
 
-Logger::Logger(std::shared_ptr<ILogBackend> backend)
-    : backendMutex(createMutexSafe()),
-      subscriberMutex(createMutexSafe()),
-      tagMutex(createMutexSafe()),
-      rateLimitMutex(createMutexSafe()),
-      lastLogTime(0),
-      logCounter(0) {
+Logger::Logger(std::shared_ptr<ILogBackend> backend) {
+    initStaticStorage();
+    globalRate_.configure(MAX_LOGS_PER_SECOND);
+    BackendList* list = idleBackendList(nullptr);
     if (backend) {
-        backends.push_back(std::move(backend));
+        list->items.push_back(std::move(backend));
     } else {
-        backends.push_back(std::make_shared<NonBlockingConsoleBackend>());
+        list->items.push_back(std::make_shared<NonBlockingConsoleBackend>());
     }
-
-    // Initialize tag levels array
-    memset(tagLevels_, 0, sizeof(tagLevels_));
+    publishBackends(list);
 }
 
 Logger::~Logger() {
-    // Stop subscriber task first (this also cleans up queue)
+    // Stop subscriber task first (it delivers what is queued)
     stopSubscriberTask();
+    stopDeferredTask();
+
+#if !CONFIG_LOG_STATIC_ALLOCATION
+    if (LogPlatform::MutexHandle mutex = backendMutex.load()) LogPlatform::deleteMutex(mutex);
+    if (LogPlatform::MutexHandle mutex = subscriberMutex.load()) LogPlatform::deleteMutex(mutex);
+    if (LogPlatform::MutexHandle mutex = tagMutex.load()) LogPlatform::deleteMutex(mutex);
+    delete tagLevels_.load();
+    delete[] repeats_.load();
+#else
+    backends_.exchange(nullptr);  // The lists are members too
+    subscribers_.exchange(nullptr);
+#endif
+
+    filter_.exchange(nullptr);  // Both filters are members, not RcuPointer's to delete
+}
 
-    if (backendMutex) vSemaphoreDelete(backendMutex);
-    if (subscriberMutex) vSemaphoreDelete(subscriberMutex);
-    if (tagMutex) vSemaphoreDelete(tagMutex);
-    if (rateLimitMutex) vSemaphoreDelete(rateLimitMutex);
+void Logger::initStaticStorage() {
+#if CONFIG_LOG_STATIC_ALLOCATION
+    // Static mutexes can be created before the scheduler; writers only take
+    // them once it runs (writerMutex())
+    backendMutex.store(LogPlatform::createMutex(mutexStorage_[0]));
+    subscriberMutex.store(LogPlatform::createMutex(mutexStorage_[1]));
+    tagMutex.store(LogPlatform::createMutex(mutexStorage_[2]));
+    tagLevels_.store(&tagTableStorage_);
+    if (CONFIG_LOG_DEDUP_SLOTS > 0) repeats_.store(repeatStorage_);
+#endif
+#if CONFIG_LOG_EARLY_BUFFER_SIZE
+    earlyRing_.init(earlyStorage_, sizeof(earlyStorage_));
+#endif
 }
 
 Logger& Logger::getInstance() {
@@ -218,11 +538,13 @@ void Logger::configure(const LoggerConfig& config) {
     initialized_.store(true);
 
     // Apply global settings
-    setLogLevel(config.defaultLevel);
-    enableLogging(config.enableLogging);
     setMaxLogsPerSecond(config.maxLogsPerSecond);
+    BufferPool::getInstance().setExhaustionPolicy(config.bufferExhaustion);
+    setEnvelope(config.envelope);
+    setThrottle(config.throttle);
+    setDedupWindow(config.dedupWindowMs);
     
-    // Configure backend
+    // Configure backend - one list swap, never an empty list in between
     switch (config.primaryBackend) {
         case LoggerConfig::BackendType::CONSOLE:
             setBackend(std::make_shared<ConsoleBackend>());
@@ -238,354 +560,1239 @@ void Logger::configure(const LoggerConfig& config) {
             break;
     }
     
-    // Apply tag configurations
-    for (size_t i = 0; i < config.tagConfigCount; ++i) {
+    // Levels last and in one filter, so the new ones reach the new backend
+    // only: the copy is built off the hot path and published with one swap
+    bool applied = updateFilter([&](LogFilter& filter) {
+        filter.setGlobalLevel(config.defaultLevel);
+        filter.setEnabled(config.enableLogging);
+        TagLevelTable* table = config.tagConfigCount ? ensureTagTable() : nullptr;
+        for (size_t i = 0; i < config.tagConfigCount && table; ++i) {
+            const auto& tagConfig = config.tagConfigs[i];
+            if (!tagConfig.tag || tagConfig.tag[0] == '\0') continue;
+            if (TagLevelTable::isPattern(tagConfig.tag)) {
+                filter.setPattern(*table, tagConfig.tag, tagConfig.level);
+            } else {
+                filter.setTag(*table, table->slotFor(tagConfig.tag), tagConfig.level);
+            }
+        }
+        return true;
+    });
+
+    // ESP-IDF's own filter, for the exact tags that made it into the table
+    const TagLevelTable* table = tagTable();
+    for (size_t i = 0; applied && table && i < config.tagConfigCount; ++i) {
         const auto& tagConfig = config.tagConfigs[i];
-        if (tagConfig.tag) {
-            setTagLevel(tagConfig.tag, tagConfig.level);
+        if (tagConfig.tag && !TagLevelTable::isPattern(tagConfig.tag) && table->slotOf(tagConfig.tag, 0) >= 0) {
+            esp_log_level_set(tagConfig.tag, tagConfig.level);
         }
     }
 }
 
+template <typename Edit>
+bool Logger::updateFilter(Edit edit) {
+    // Publishing waits for readers, which an ISR cannot do
+    if (LogPlatform::inIsr()) return false;
+
+    // Writers are serialized by tagMutex, which also guards the tag table the
+    // filter indexes (not needed before the scheduler)
+    LogPlatform::MutexHandle mutex = writerMutex(tagMutex);
+    if (mutex && !LogPlatform::takeMutex(mutex, LoggerConfig::MUTEX_SHORT_TIMEOUT_MS)) {
+        mutexTimeouts_.fetch_add(1);
+        return false;
+    }
+
+    // The idle copy has no readers: the swap that retired it waited them out
+    const LogFilter* current = filter_.writerView();
+    LogFilter* next = current == &filters_[0] ? &filters_[1] : &filters_[0];
+    *next = *current;
+    bool changed = edit(*next);
+    if (changed) {
+        next->restamp();
+        filter_.exchange(next);
+    }
+
+    if (mutex) LogPlatform::giveMutex(mutex);
+    if (changed) bumpConfigGeneration();
+    return changed;
+}
+
 void Logger::enableLogging(bool enable) {
-    isLoggingEnabled.store(enable);
+    updateFilter([&](LogFilter& filter) {
+        filter.setEnabled(enable);
+        return true;
+    });
 }
 
 void Logger::setLogLevel(esp_log_level_t level) {
-    globalLogLevel.store(level);
+    updateFilter([&](LogFilter& filter) {
+        filter.setGlobalLevel(level);
+        return true;
+    });
 }
 
 void Logger::setMaxLogsPerSecond(uint32_t maxLogs) {
     maxLogsPerSecond.store(maxLogs);
+    // Burst = one window's worth, matching the old fixed-window counter
+    uint64_t burst = static_cast<uint64_t>(maxLogs) * LoggerConfig::RATE_LIMIT_WINDOW_MS / 1000;
+    globalRate_.configure(maxLogs, burst > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(burst));
+    globalRate_.reset();
 }
 
-void Logger::setBackend(std::shared_ptr<ILogBackend> newBackend) {
-    // Allow operation without mutex if scheduler not started (single-threaded)
-    if (!backendMutex) {
-        backends.clear();
-        if (newBackend) {
-            backends.push_back(std::move(newBackend));
-        }
+void Logger::setEnvelope(const LoggerConfig::Envelope& envelope) {
+    envelopeTime_.store(static_cast<uint8_t>(envelope.time), std::memory_order_relaxed);
+    envelopeDelta_.store(envelope.delta, std::memory_order_relaxed);
+    envelopeTaskId_.store(envelope.taskId, std::memory_order_relaxed);
+}
+
+LoggerConfig::Envelope Logger::getEnvelope() const {
+    LoggerConfig::Envelope envelope;
+    envelope.time = static_cast<LoggerConfig::Envelope::Time>(envelopeTime_.load(std::memory_order_relaxed));
+    envelope.delta = envelopeDelta_.load(std::memory_order_relaxed);
+    envelope.taskId = envelopeTaskId_.load(std::memory_order_relaxed);
+    return envelope;
+}
+
+template <typename Edit>
+void Logger::updateBackends(Edit edit) {
+    // Writers are serialized by backendMutex (not needed before the scheduler)
+    LogPlatform::MutexHandle mutex = writerMutex(backendMutex);
+    if (mutex && !LogPlatform::takeMutex(mutex, LoggerConfig::MUTEX_STANDARD_TIMEOUT_MS)) {
+        mutexTimeouts_.fetch_add(1);
         return;
     }
 
-    if (xSemaphoreTake(backendMutex, pdMS_TO_TICKS(LoggerConfig::MUTEX_SHORT_TIMEOUT_MS)) == pdTRUE) {
-        backends.clear();
-        if (newBackend) {
-            backends.push_back(std::move(newBackend));
+    // Copy, edit, publish - readers keep using the old list until they finish
+    BackendList* next = idleBackendList(backends_.writerView());
+    edit(next->items);
+#if CONFIG_LOG_STATIC_ALLOCATION
+    bool rejected = next->items.takeRejected();
+#endif
+    publishBackends(next);
+
+#if CONFIG_LOG_EARLY_BUFFER_SIZE
+    bool replay = !next->items.empty() && !earlyReplayed_.exchange(true);
+    if (replay) replayEarlyLines(*next);
+#endif
+
+    if (mutex) LogPlatform::giveMutex(mutex);
+
+#if CONFIG_LOG_STATIC_ALLOCATION
+    if (rejected) {
+        logNotice(ESP_LOG_WARN, "Logger", "Backend not added: all %d CONFIG_LOG_MAX_BACKENDS slots in use",
+                  CONFIG_LOG_MAX_BACKENDS);
+    }
+#endif
+
+#if CONFIG_LOG_EARLY_BUFFER_SIZE
+    uint32_t overflowed = replay ? earlyRing_.getOverflowCount() : 0;
+    if (overflowed) {
+        lostWrites_.fetch_add(overflowed);
+        logNotice(ESP_LOG_WARN, "Logger", "%" PRIu32 " early boot lines did not fit CONFIG_LOG_EARLY_BUFFER_SIZE",
+                  overflowed);
+    }
+#endif
+}
+
+Logger::BackendList* Logger::idleBackendList(const BackendList* current) {
+#if CONFIG_LOG_STATIC_ALLOCATION
+    // The idle list has no readers: the swap that retired it waited them out
+    BackendList* next = current == &backendLists_[0] ? &backendLists_[1] : &backendLists_[0];
+    if (current) {
+        next->items = current->items;
+    } else {
+        next->items.clear();
+    }
+    return next;
+#else
+    return current ? new BackendList(*current) : new BackendList();
+#endif
+}
+
+void Logger::publishBackends(BackendList* next) {
+    updateBackendCounts(*next);
+#if CONFIG_LOG_STATIC_ALLOCATION
+    // Drop the retired list's references now, not at the next change
+    BackendList* retired = backends_.exchange(next);
+    if (retired) retired->items.clear();
+#else
+    backends_.replace(next);
+#endif
+}
+
+void Logger::replayEarlyLines(const BackendList& list) {
+#if CONFIG_LOG_EARLY_BUFFER_SIZE
+    // First backend(s) installed: hand them what was logged before, in order
+    const uint8_t* record;
+    size_t length;
+    while (earlyRing_.peek(record, length)) {
+        for (auto& backend : list.items) {
+            if (backend) backend->write(reinterpret_cast<const char*>(record), length);
         }
-        xSemaphoreGive(backendMutex);
+        earlyRing_.pop();
     }
+#else
+    (void)list;
+#endif
+}
+
+void Logger::setBackend(std::shared_ptr<ILogBackend> newBackend) {
+    updateBackends([&](BackendItems& items) {
+        items.clear();
+        if (newBackend) {
+            items.push_back(std::move(newBackend));
+        }
+    });
 }
 
 void Logger::addBackend(std::shared_ptr<ILogBackend> backend) {
     if (!backend) return;
 
-    // Allow operation without mutex if scheduler not started (single-threaded)
-    if (!backendMutex) {
-        backends.push_back(std::move(backend));
-        return;
-    }
-
-    if (xSemaphoreTake(backendMutex, pdMS_TO_TICKS(LoggerConfig::MUTEX_SHORT_TIMEOUT_MS)) == pdTRUE) {
-        backends.push_back(std::move(backend));
-        xSemaphoreGive(backendMutex);
-    }
+    updateBackends([&](BackendItems& items) {
+        items.push_back(std::move(backend));
+    });
 }
 
 void Logger::removeBackend(std::shared_ptr<ILogBackend> backend) {
     if (!backend) return;
 
-    // Allow operation without mutex if scheduler not started (single-threaded)
-    if (!backendMutex) {
-        backends.erase(
-            std::remove(backends.begin(), backends.end(), backend),
-            backends.end()
-        );
-        return;
-    }
-
-    if (xSemaphoreTake(backendMutex, pdMS_TO_TICKS(LoggerConfig::MUTEX_SHORT_TIMEOUT_MS)) == pdTRUE) {
-        backends.erase(
-            std::remove(backends.begin(), backends.end(), backend),
-            backends.end()
-        );
-        xSemaphoreGive(backendMutex);
-    }
+    updateBackends([&](BackendItems& items) {
+        items.erase(std::remove(items.begin(), items.end(), backend), items.end());
+    });
 }
 
 void Logger::clearBackends() {
-    // Allow operation without mutex if scheduler not started (single-threaded)
-    if (!backendMutex) {
-        backends.clear();
-        return;
-    }
+    updateBackends([](BackendItems& items) {
+        items.clear();
+    });
+}
 
-    if (xSemaphoreTake(backendMutex, pdMS_TO_TICKS(LoggerConfig::MUTEX_SHORT_TIMEOUT_MS)) == pdTRUE) {
-        backends.clear();
-        xSemaphoreGive(backendMutex);
-    }
+std::shared_ptr<AsyncRingBackend> Logger::addIsolatedBackend(std::shared_ptr<ILogBackend> backend,
+                                                             int coreId, uint32_t priority) {
+    AsyncRingBackend::Config config;
+    config.coreId = coreId;
+    config.priority = priority;
+    config.taskName = "LogSink";
+    return addIsolatedBackend(std::move(backend), config);
 }
 
-void Logger::setTagLevel(const char* tag, esp_log_level_t level) {
-    if (!tag || strlen(tag) == 0) return;
+std::shared_ptr<AsyncRingBackend> Logger::addIsolatedBackend(std::shared_ptr<ILogBackend> backend,
+                                                             const AsyncRingBackend::Config& config) {
+    if (!backend) return nullptr;
 
-    size_t tagLen = strlen(tag);
-    if (tagLen >= CONFIG_LOG_SUBSCRIBER_TAG_SIZE) {
-        tagLen = CONFIG_LOG_SUBSCRIBER_TAG_SIZE - 1;  // Truncate if too long
+    auto isolated = std::make_shared<AsyncRingBackend>(std::move(backend), config);
+    if (!isolated->start()) {
+        return nullptr;
     }
 
-    // Helper lambda to set tag level (no heap allocation)
-    auto doSetTagLevel = [this, tag, tagLen, level]() {
-        size_t count = tagLevelCount_.load();
+    addBackend(isolated);
+    return isolated;
+}
 
-        // First, check if tag already exists and update it
-        for (size_t i = 0; i < count; i++) {
-            if (strncmp(tagLevels_[i].tag, tag, CONFIG_LOG_SUBSCRIBER_TAG_SIZE) == 0) {
-                tagLevels_[i].level = level;
-                esp_log_level_set(tag, level);
-                return;
-            }
-        }
+size_t Logger::getBackendQueueStats(BackendQueueStats* stats, size_t maxCount) const {
+    if (!stats) return 0;
 
-        // Tag not found - add new entry if space available
-        if (count < CONFIG_LOG_MAX_TAGS) {
-            memcpy(tagLevels_[count].tag, tag, tagLen);
-            tagLevels_[count].tag[tagLen] = '\0';
-            tagLevels_[count].level = level;
-            tagLevelCount_.store(count + 1);
-            esp_log_level_set(tag, level);
-        }
-    };
+    BackendGuard list(backends_);
+    if (!list) return 0;
 
-    // Allow operation without mutex if scheduler not started (single-threaded)
-    if (!tagMutex) {
-        doSetTagLevel();
-        return;
+    size_t count = 0;
+    for (auto& backend : list->items) {
+        if (count >= maxCount) break;
+        if (backend && backend->getQueueStats(stats[count])) {
+            count++;
+        }
     }
+    return count;
+}
 
-    if (xSemaphoreTake(tagMutex, pdMS_TO_TICKS(LoggerConfig::MUTEX_SHORT_TIMEOUT_MS)) == pdTRUE) {
-        doSetTagLevel();
-        xSemaphoreGive(tagMutex);
-    } else {
-        mutexTimeouts_.fetch_add(1);
+void Logger::updateBackendCounts(const BackendList& list) {
+    uint8_t unformatted = 0;
+    uint8_t text = 0;
+    for (auto& backend : list.items) {
+        if (!backend) continue;
+        if (backend->acceptsUnformatted()) {
+            unformatted++;
+        } else {
+            text++;
+        }
     }
+    unformattedBackends_.store(unformatted);
+    textBackends_.store(text);
+}
+
+void Logger::setTagLevel(const char* tag, esp_log_level_t level) {
+    if (!tag || tag[0] == '\0') return;
+
+    // "Prefix*" rules only exist here - ESP-IDF matches exact tags
+    bool pattern = TagLevelTable::isPattern(tag);
+    bool applied = updateFilter([&](LogFilter& filter) {
+        TagLevelTable* table = ensureTagTable();
+        if (!table) return false;
+        return pattern ? filter.setPattern(*table, tag, level) : filter.setTag(*table, table->slotFor(tag), level);
+    });
+    if (applied && !pattern) esp_log_level_set(tag, level);
 }
 
 esp_log_level_t Logger::getTagLevel(const char* tag) const {
-    if (!tag) return globalLogLevel.load();
+    FilterGuard filter(filter_);
+    return levelFor(*filter.get(), tag, 0);
+}
 
-    esp_log_level_t level = globalLogLevel.load();
+esp_log_level_t Logger::levelFor(const LogFilter& filter, const char* tag, uint32_t tagId) const {
+    esp_log_level_t level = filter.globalLevel();
+    if (!tag) return level;
 
-    // Return global level if no mutex (pre-scheduler, can't safely access tagLevels_)
-    if (!tagMutex) {
+    if (!tagId && TagLevelTable::isPattern(tag)) {
+        filter.lookupPattern(tag, level);
         return level;
     }
 
-    if (xSemaphoreTake(tagMutex, pdMS_TO_TICKS(LoggerConfig::MUTEX_SHORT_TIMEOUT_MS)) == pdTRUE) {
-        size_t count = tagLevelCount_.load();
-        for (size_t i = 0; i < count; i++) {
-            if (strncmp(tagLevels_[i].tag, tag, CONFIG_LOG_SUBSCRIBER_TAG_SIZE) == 0) {
-                level = tagLevels_[i].level;
-                break;
-            }
-        }
-        xSemaphoreGive(tagMutex);
-    }
+    // Lock-free lookup - falls back to global level if tag not configured
+    TagLevelTable* table = tagTable();
+    bool unregistered;
+    filter.resolve(table, tag, tagId, level, unregistered);
 
+    // First sight of a tag while patterns exist: intern it so its pattern
+    // level is cached in the table. Never waits - a busy mutex or an ISR
+    // just means the patterns are scanned again next time.
+    if (!unregistered || !table || table->size() >= TagLevelTable::CAPACITY || LogPlatform::inIsr()) {
+        return level;
+    }
+    LogPlatform::MutexHandle mutex = writerMutex(tagMutex);
+    if (!mutex) {
+        table->intern(tag, tagId ? tagId : TagLevelTable::hash(tag));
+    } else if (LogPlatform::takeMutex(mutex, 0)) {
+        table->intern(tag, tagId ? tagId : TagLevelTable::hash(tag));
+        LogPlatform::giveMutex(mutex);
+    }
     return level;
 }
 
-bool Logger::isLevelEnabledForTag(const char* tag, esp_log_level_t level) const {
-    if (!isLoggingEnabled.load()) return false;
+esp_log_level_t Logger::getEffectiveLevel(const char* tag) const {
+    FilterGuard filter(filter_);
+    return filter->enabled() ? levelFor(*filter.get(), tag, 0) : ESP_LOG_NONE;
+}
 
-    // ESP_LOG_NONE should never be logged
+bool Logger::isLevelEnabledForTag(const LogTag& tag, esp_log_level_t level) const {
     if (level == ESP_LOG_NONE) return false;
 
-    // If no tag, use global level
-    if (!tag) {
-        return level <= globalLogLevel.load();
-    }
+    FilterGuard filter(filter_);
+    return filter->enabled() && level <= levelFor(*filter.get(), tag.name, tag.id);
+}
 
-    // Check tag-specific level first
-    esp_log_level_t effectiveLevel = globalLogLevel.load();
+uint32_t Logger::registerTag(const char* tag) {
+    if (!tag) return 0;
+    return internTag(tag, TagLevelTable::hash(tag));
+}
 
-    // Check if mutex exists before trying to take it (may be null if scheduler not started)
-    if (tagMutex) {
-        if (xSemaphoreTake(tagMutex, pdMS_TO_TICKS(LoggerConfig::MUTEX_SHORT_TIMEOUT_MS)) == pdTRUE) {
-            size_t count = tagLevelCount_.load();
-            for (size_t i = 0; i < count; i++) {
-                if (strncmp(tagLevels_[i].tag, tag, CONFIG_LOG_SUBSCRIBER_TAG_SIZE) == 0) {
-                    effectiveLevel = tagLevels_[i].level;
-                    break;
-                }
-            }
-            xSemaphoreGive(tagMutex);
-        }
+uint32_t Logger::internTag(const char* tag, uint32_t tagId) {
+    // Fast path - already registered (lock-free)
+    const TagLevelTable* current = tagTable();
+    if (current && current->contains(tagId)) return tagId;
+
+    bool registered = false;
+    LogPlatform::MutexHandle mutex = writerMutex(tagMutex);
+    if (!mutex) {
+        TagLevelTable* table = ensureTagTable();
+        registered = table && table->intern(tag, tagId);
+    } else if (LogPlatform::takeMutex(mutex, LoggerConfig::MUTEX_SHORT_TIMEOUT_MS)) {
+        TagLevelTable* table = ensureTagTable();
+        registered = table && table->intern(tag, tagId);
+        LogPlatform::giveMutex(mutex);
+    } else {
+        mutexTimeouts_.fetch_add(1);
     }
-    // If no mutex, just use global level (can't check tag-specific levels safely)
-
-    // Use tag-specific level if configured, otherwise use global level
-    return level <= effectiveLevel;
+    return registered ? tagId : 0;
 }
 
-bool Logger::checkRateLimit() {
-    uint32_t maxPerSec = maxLogsPerSecond.load();
-    if (maxPerSec == 0) return true;  // Unlimited
+TagLevelTable* Logger::ensureTagTable() {
+    // Writers are serialized (tagMutex, or no scheduler yet), so only one can get here first
+    TagLevelTable* table = tagTable();
+    if (table || LogPlatform::inIsr()) return table;
+    table = new (std::nothrow) TagLevelTable();
+    tagLevels_.store(table, std::memory_order_release);
+    return table;
+}
 
-    // Allow logging if no mutex (pre-scheduler)
-    if (!rateLimitMutex) {
-        return true;
-    }
+bool Logger::isLevelEnabledForTag(const char* tag, esp_log_level_t level) const {
+    // ESP_LOG_NONE should never be logged
+    if (level == ESP_LOG_NONE) return false;
 
-    bool allowed = false;
+    // Use tag-specific level if configured, otherwise use global level.
+    // Never blocks, and the enable flag, global and tag levels all come
+    // from the same published filter.
+    FilterGuard filter(filter_);
+    return filter->enabled() && level <= levelFor(*filter.get(), tag, 0);
+}
 
-    if (xSemaphoreTake(rateLimitMutex, pdMS_TO_TICKS(LoggerConfig::MUTEX_MEDIUM_TIMEOUT_MS)) == pdTRUE) {
-        uint32_t currentTime = millis();
-        // Handle millis() wrap-around gracefully (after ~49 days)
-        // Unsigned subtraction handles wrap correctly: if currentTime wrapped,
-        // elapsed will be a large value which correctly triggers reset
-        uint32_t elapsed = currentTime - lastLogTime;
+void Logger::setLevelRateLimit(esp_log_level_t level, uint32_t perSecond, uint32_t burst) {
+    if (level <= ESP_LOG_NONE || level > ESP_LOG_VERBOSE) return;
+    levelRates_[level].configure(perSecond, burst);
+    levelRates_[level].reset();
+}
 
-        if (elapsed >= LoggerConfig::RATE_LIMIT_WINDOW_MS) {
-            // New window - reset counter
-            lastLogTime = currentTime;
-            logCounter = 1;
-            allowed = true;
-        } else if (logCounter < maxPerSec) {
-            logCounter++;
-            allowed = true;
-        } else {
-            droppedLogs.fetch_add(1);
-            allowed = false;
-        }
+bool Logger::setTagRateLimit(const char* tag, uint32_t perSecond, uint32_t burst) {
+    if (!tag || tag[0] == '\0') return false;
 
-        xSemaphoreGive(rateLimitMutex);
-    } else {
-        // Mutex timeout - track for diagnostics
+    // Same writer serialization as setTagLevel() - lookups stay lock-free
+    LogPlatform::MutexHandle mutex = writerMutex(tagMutex);
+    if (mutex && !LogPlatform::takeMutex(mutex, LoggerConfig::MUTEX_SHORT_TIMEOUT_MS)) {
         mutexTimeouts_.fetch_add(1);
+        return false;
     }
 
-    return allowed;
-}
-
-void Logger::writeToBackends(const char* message, size_t length) {
-    // Fallback: write directly without mutex protection (pre-scheduler)
-    if (!backendMutex) {
-        for (auto& backend : backends) {
-            if (backend) {
-                backend->write(message, length);
-            }
-        }
-        return;
-    }
+    bool ok = false;
+    if (TagLevelTable* table = ensureTagTable()) {
+        bool wasLimited = false;
+        if (RateBucket* existing = table->rateOf(tag, 0)) wasLimited = existing->isLimited();
 
-    if (xSemaphoreTake(backendMutex, pdMS_TO_TICKS(LoggerConfig::MUTEX_STANDARD_TIMEOUT_MS)) == pdTRUE) {
-        for (auto& backend : backends) {
-            if (backend) {
-                backend->write(message, length);
-            }
-        }
-        xSemaphoreGive(backendMutex);
+        ok = table->setRate(tag, perSecond, burst);
+        if (ok && perSecond && !wasLimited) tagRateLimits_.fetch_add(1);
+        if (ok && !perSecond && wasLimited) tagRateLimits_.fetch_sub(1);
     }
-}
 
-void Logger::log(esp_log_level_t level, const char* tag, const char* format, ...) {
-    if (!isLevelEnabledForTag(tag, level)) return;
-    
-    va_list args;
-    va_start(args, format);
-    logV(level, tag, format, args);
-    va_end(args);
+    if (mutex) LogPlatform::giveMutex(mutex);
+    return ok;
 }
 
-void Logger::logV(esp_log_level_t level, const char* tag, const char* format, va_list args) {
-    if (!isLevelEnabledForTag(tag, level)) return;
-    if (!checkRateLimit()) return;
+template <typename Configure>
+bool Logger::configureSampler(const char* tag, Configure configure) {
+    if (!tag || tag[0] == '\0' || TagLevelTable::isPattern(tag)) return false;
 
-    auto& pool = BufferPool::getInstance();
+    // Same writer serialization as setTagRateLimit()
+    LogPlatform::MutexHandle mutex = writerMutex(tagMutex);
+    if (mutex && !LogPlatform::takeMutex(mutex, LoggerConfig::MUTEX_SHORT_TIMEOUT_MS)) {
+        mutexTimeouts_.fetch_add(1);
+        return false;
+    }
 
-    // Get buffer from pool
-    char* formatBuffer = pool.acquire();
-    if (!formatBuffer) return;
+    bool ok = false;
+    TagLevelTable* table = ensureTagTable();
+    if (LogSampler* sampler = table ? table->samplerFor(tag) : nullptr) {
+        bool wasActive = sampler->isActive();
+        configure(*sampler);
+        if (sampler->isActive() && !wasActive) tagSamplers_.fetch_add(1);
+        if (!sampler->isActive() && wasActive) tagSamplers_.fetch_sub(1);
+        ok = true;
+    }
 
-    // Format the message
-    vsnprintf(formatBuffer, CONFIG_LOG_BUFFER_SIZE, format, args);
+    if (mutex) LogPlatform::giveMutex(mutex);
+    return ok;
+}
 
-    // Notify subscribers with formatted message (before adding timestamp/task info)
-    notifySubscribers(level, tag, formatBuffer);
+bool Logger::setTagSampling(const char* tag, esp_log_level_t level, uint32_t keep, uint32_t outOf) {
+    return configureSampler(tag, [=](LogSampler& sampler) { sampler.configureRatio(level, keep, outOf); });
+}
 
-    // Get another buffer for full message
-    char* fullMessage = pool.acquire();
-    if (fullMessage) {
-        // Format complete message
-        int len = snprintf(fullMessage, CONFIG_LOG_BUFFER_SIZE,
-                          "[%lu][%s][%s] %s: %s\r\n",
-                          millis(),
-                          pcTaskGetName(NULL) ?: "?",
-                          levelToString(level),
-                          tag ?: "?",
-                          formatBuffer);
+bool Logger::setTagSamplingBudget(const char* tag, esp_log_level_t level, uint32_t perSecond, uint32_t burst) {
+    return configureSampler(tag, [=](LogSampler& sampler) { sampler.configureBudget(level, perSecond, burst); });
+}
 
-        // Ensure message wasn't truncated
-        if (len >= CONFIG_LOG_BUFFER_SIZE) {
-            len = CONFIG_LOG_BUFFER_SIZE - 1;
-            fullMessage[len] = '\0';  // Ensure null termination
+void Logger::setDedupWindow(uint32_t windowMs) {
+    if (windowMs != 0 && CONFIG_LOG_DEDUP_SLOTS > 0 && !repeats_.load(std::memory_order_acquire)) {
+        // Slots are only allocated once coalescing is turned on, and kept
+        while (repeatsBusy_.exchange(true, std::memory_order_acquire)) LogPlatform::delayMs(1);
+        if (!repeats_.load(std::memory_order_relaxed)) {
+            repeats_.store(new (std::nothrow) RepeatSlot[CONFIG_LOG_DEDUP_SLOTS], std::memory_order_release);
         }
+        repeatsBusy_.store(false, std::memory_order_release);
+    }
+    dedupWindowMs_.store(windowMs, std::memory_order_relaxed);
+    if (windowMs == 0) flushRepeats();
+}
 
-        // Write to all backends
-        writeToBackends(fullMessage, len);
+bool Logger::coalesceRepeat(esp_log_level_t level, const char* tag, const char* format) {
+    uint32_t windowMs = dedupWindowMs_.load(std::memory_order_relaxed);
+    if (windowMs == 0 || !tag || !DeferredFormat::isInFlash(format) || LogPlatform::inIsr()) return false;
+
+    RepeatSlot* slots = repeats_.load(std::memory_order_acquire);
+    if (!slots) return false;
+
+    // Another task is in the cache: log normally rather than wait
+    if (repeatsBusy_.exchange(true, std::memory_order_acquire)) return false;
+
+    uint32_t now = LogPlatform::millis();
+    RepeatSlot* match = nullptr;
+    RepeatSlot* freeSlot = nullptr;
+    RepeatSlot* oldest = nullptr;
+    for (size_t i = 0; i < CONFIG_LOG_DEDUP_SLOTS; i++) {
+        RepeatSlot& slot = slots[i];
+        // Run over: report it, then the next occurrence is logged in full again
+        if (slot.format && now - slot.startMs >= windowMs) {
+            reportRepeats(slot);
+            slot.format = nullptr;
+        }
+        if (!slot.format) {
+            if (!freeSlot) freeSlot = &slot;
+            continue;
+        }
+        if (slot.format == format && slot.level == level &&
+            strncmp(slot.tag, tag, sizeof(slot.tag) - 1) == 0) {
+            match = &slot;
+        }
+        if (!oldest || static_cast<int32_t>(slot.lastMs - oldest->lastMs) < 0) oldest = &slot;
+    }
 
-        pool.release(fullMessage);
+    if (match) {
+        match->count++;
+        match->lastMs = now;
+        coalescedLogs_.fetch_add(1, std::memory_order_relaxed);
     } else {
-        // Fallback to ESP-IDF logging
-        esp_log_write(level, tag, "%s", formatBuffer);
+        RepeatSlot* slot = freeSlot ? freeSlot : oldest;
+        if (!freeSlot) reportRepeats(*slot);  // Evicted
+        slot->format = format;
+        strncpy(slot->tag, tag, sizeof(slot->tag) - 1);
+        slot->tag[sizeof(slot->tag) - 1] = '\0';
+        slot->level = level;
+        slot->startMs = now;
+        slot->lastMs = now;
+        slot->count = 0;
     }
 
-    pool.release(formatBuffer);
+    repeatsBusy_.store(false, std::memory_order_release);
+    return match != nullptr;
 }
 
-void Logger::logNnL(esp_log_level_t level, const char* tag, const char* format, ...) {
-    if (!isLevelEnabledForTag(tag, level)) return;
-    if (!checkRateLimit()) return;
+void Logger::reportRepeats(const RepeatSlot& slot) {
+    if (slot.count == 0) return;
+    logNotice(slot.level, slot.tag, "last message repeated %" PRIu32 " times over %" PRIu32 " ms",
+              slot.count, slot.lastMs - slot.startMs);
+}
 
-    auto& pool = BufferPool::getInstance();
+void Logger::flushRepeats() {
+    RepeatSlot* slots = repeats_.load(std::memory_order_acquire);
+    if (!slots) return;
 
-    va_list args;
-    va_start(args, format);
+    while (repeatsBusy_.exchange(true, std::memory_order_acquire)) LogPlatform::delayMs(1);
 
-    char* formatBuffer = pool.acquire();
-    if (!formatBuffer) {
-        va_end(args);
-        return;
+    for (size_t i = 0; i < CONFIG_LOG_DEDUP_SLOTS; i++) {
+        if (slots[i].format) reportRepeats(slots[i]);
+        slots[i].format = nullptr;
     }
 
-    vsnprintf(formatBuffer, CONFIG_LOG_BUFFER_SIZE, format, args);
+    repeatsBusy_.store(false, std::memory_order_release);
+}
+
+void Logger::setThrottle(const LoggerConfig::Throttle& throttle) {
+    // Wait out a sample in progress - it reads throttle_
+    while (throttleBusy_.exchange(true, std::memory_order_acquire)) LogPlatform::delayMs(1);
+
+    throttle_ = throttle;
+    if (throttle_.minLevel < ESP_LOG_ERROR) throttle_.minLevel = ESP_LOG_ERROR;
+    if (throttle_.pressureWindows == 0) throttle_.pressureWindows = 1;
+    if (throttle_.calmWindows == 0) throttle_.calmWindows = 1;
+
+    // Drops from before now do not count as pressure
+    uint8_t fill;
+    samplePressure(throttleDrops_, fill);
+    throttlePressured_ = 0;
+    throttleCalm_ = 0;
+    throttleSeen_.store(0, std::memory_order_relaxed);
+
+    // Reconfiguring (or disabling) lifts any mask right away
+    throttleLevel_.store(ESP_LOG_VERBOSE, std::memory_order_relaxed);
+    throttleWindowUs_.store(throttle_.windowMs * 1000, std::memory_order_relaxed);
+    throttleWindowStart_.store(static_cast<uint32_t>(LogPlatform::micros()), std::memory_order_relaxed);
+    throttleEnabled_.store(throttle_.enabled, std::memory_order_relaxed);
+
+    throttleBusy_.store(false, std::memory_order_release);
+}
+
+LoggerConfig::Throttle Logger::getThrottle() const {
+    while (throttleBusy_.exchange(true, std::memory_order_acquire)) LogPlatform::delayMs(1);
+    LoggerConfig::Throttle throttle = throttle_;
+    throttleBusy_.store(false, std::memory_order_release);
+    return throttle;
+}
+
+bool Logger::checkRateLimit(esp_log_level_t level, const char* tag, uint32_t tagId) {
+    uint32_t now = static_cast<uint32_t>(LogPlatform::micros());
+
+    // Masked by the adaptive throttle: counted separately, never a "drop"
+    if (throttleEnabled_.load(std::memory_order_relaxed)) {
+        updateThrottle(now);
+        if (level > throttleLevel_.load(std::memory_order_relaxed)) {
+            throttledLogs_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        throttleSeen_.fetch_or(static_cast<uint8_t>(1u << level), std::memory_order_relaxed);
+    }
+
+    // Sampled-out verbose lines: left out on purpose, not a "drop"
+    if (tagSamplers_.load(std::memory_order_relaxed) != 0 && tag) {
+        LogSampler* sampler = tagTable()->samplerOf(tag, tagId);  // Samplers exist, so the table does
+        if (sampler && !sampler->sample(level, now)) {
+            sampledLogs_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    // A tag over its own cap is dropped before it touches the shared budgets
+    if (tagRateLimits_.load(std::memory_order_relaxed) != 0 && tag) {
+        RateBucket* tagRate = tagTable()->rateOf(tag, tagId);  // Limits exist, so the table does
+        if (tagRate && !tagRate->tryAcquire(now)) {
+            droppedLogs.fetch_add(1);
+            return false;
+        }
+    }
+
+    // Levels with their own budget do not compete with the global one
+    RateBucket& levelRate = levelRates_[level <= ESP_LOG_VERBOSE ? level : ESP_LOG_VERBOSE];
+    bool allowed = levelRate.isLimited() ? levelRate.tryAcquire(now) : globalRate_.tryAcquire(now);
+    if (!allowed) droppedLogs.fetch_add(1);
+    return allowed;
+}
+
+void Logger::updateThrottle(uint32_t nowUs) {
+    uint32_t start = throttleWindowStart_.load(std::memory_order_relaxed);
+    if (nowUs - start < throttleWindowUs_.load(std::memory_order_relaxed)) return;
+
+    // Backends cannot be walked from an ISR; leave the window to the next task
+    if (LogPlatform::inIsr()) return;
+
+    // One task samples per window, the others log on without waiting
+    if (!throttleWindowStart_.compare_exchange_strong(start, nowUs, std::memory_order_relaxed)) return;
+    if (throttleBusy_.exchange(true, std::memory_order_acquire)) return;
+
+    uint32_t drops;
+    uint8_t fill;
+    samplePressure(drops, fill);
+    uint32_t newDrops = drops >= throttleDrops_ ? drops - throttleDrops_ : drops;  // A counter was reset
+    throttleDrops_ = drops;
+
+    const LoggerConfig::Throttle& config = throttle_;
+    bool pressured = (config.dropsPerWindow && newDrops >= config.dropsPerWindow) ||
+                     fill >= config.highWaterPercent;
+    bool calm = newDrops == 0 && fill < config.lowWaterPercent;
+    uint8_t seen = throttleSeen_.exchange(0, std::memory_order_relaxed);
+    esp_log_level_t level = throttleLevel_.load(std::memory_order_relaxed);
+
+    uint32_t suppressed = 0;
+    uint32_t elapsedMs = 0;
+    bool lifted = false;
+
+    if (pressured) {
+        throttleCalm_ = 0;
+        if (++throttlePressured_ >= config.pressureWindows) {
+            throttlePressured_ = 0;
+
+            // Mask the most verbose level that still got through
+            int verbose = ESP_LOG_VERBOSE;
+            while (verbose > ESP_LOG_NONE && !(seen & (1u << verbose))) verbose--;
+            int next = verbose - 1;
+            if (next >= config.minLevel && next < level) {
+                if (level == ESP_LOG_VERBOSE) {
+                    throttleSuppressedBase_ = throttledLogs_.load(std::memory_order_relaxed);
+                    throttleSinceMs_ = LogPlatform::millis();
+                }
+                throttleLevel_.store(static_cast<esp_log_level_t>(next), std::memory_order_relaxed);
+            }
+        }
+    } else {
+        throttlePressured_ = 0;
+        throttleCalm_ = calm ? throttleCalm_ + 1 : 0;
+        if (level != ESP_LOG_VERBOSE && throttleCalm_ >= config.calmWindows) {
+            throttleCalm_ = 0;
+            throttleLevel_.store(ESP_LOG_VERBOSE, std::memory_order_relaxed);
+            suppressed = throttledLogs_.load(std::memory_order_relaxed) - throttleSuppressedBase_;
+            elapsedMs = LogPlatform::millis() - throttleSinceMs_;
+            lifted = true;
+        }
+    }
+
+    throttleBusy_.store(false, std::memory_order_release);
+
+    if (lifted) {
+        logNotice(ESP_LOG_WARN, "Logger", "Log throttling lifted: %" PRIu32 " messages suppressed over %" PRIu32 " ms",
+                  suppressed, elapsedMs);
+    }
+}
+
+// Drops so far on every stage that can overflow, and the fullest queue in percent
+void Logger::samplePressure(uint32_t& drops, uint8_t& fillPercent) const {
+    auto percent = [](size_t used, size_t capacity) -> uint8_t {
+        if (capacity == 0) return 0;
+        uint64_t p = static_cast<uint64_t>(used) * 100 / capacity;
+        return p > 100 ? 100 : static_cast<uint8_t>(p);
+    };
+
+    drops = droppedLogs.load() + subscriberDrops_.load() + deferredRing_.getOverflowCount() +
+            BufferPool::getInstance().getDroppedAcquires();
+    fillPercent = std::max(percent(subscriberRing_.used(), subscriberRing_.capacity()),
+                           percent(deferredRing_.used(), deferredRing_.capacity()));
+
+    BackendGuard list(backends_);
+    if (!list) return;
+    for (auto& backend : list->items) {
+        if (!backend) continue;
+        drops += backend->getDroppedMessages();
+        BackendQueueStats stats;
+        if (backend->getQueueStats(stats)) {
+            fillPercent = std::max(fillPercent, percent(stats.queuedBytes, stats.capacity));
+        }
+    }
+}
+
+// Logger's own lines: not rate limited, not throttled, not deferred
+void Logger::logNotice(esp_log_level_t level, const char* tag, const char* format, ...) {
+    if (!loggingEnabled()) return;
+
+    va_list args;
+    va_start(args, format);
+    size_t bodyOffset, bodyLength;
+    char* buffer = formatLine(level, tag, format, args, bodyOffset, bodyLength);
     va_end(args);
+    if (!buffer) return;
 
-    // Notify subscribers with formatted message (before adding timestamp/task info)
-    notifySubscribers(level, tag, formatBuffer);
+    outputMessage(level, tag, 0, buffer, bodyOffset, bodyLength, "\r\n");
 
-    char* fullMessage = pool.acquire();
-    if (fullMessage) {
-        int len = snprintf(fullMessage, CONFIG_LOG_BUFFER_SIZE,
-                          "[%lu][%s][%s] %s: %s",  // No newline
-                          millis(),
-                          pcTaskGetName(NULL) ?: "?",
-                          levelToString(level),
-                          tag ?: "?",
-                          formatBuffer);
+    BufferPool::getInstance().release(buffer);
+}
 
-        writeToBackends(fullMessage, len);
-        pool.release(fullMessage);
+void Logger::writeToBackends(const char* message, size_t length, bool skipUnformatted) {
+    // Lock-free: iterate the current snapshot; backends handle their own locking
+    BackendGuard list(backends_);
+    bool delivered = false;
+    if (list) {
+        for (auto& backend : list->items) {
+            if (backend && !(skipUnformatted && backend->acceptsUnformatted())) {
+                backend->write(message, length);
+                delivered = true;
+            }
+        }
     }
 
-    pool.release(formatBuffer);
+    // Nobody took it (and no binary backend already had it): count the loss
+    if (!delivered && !skipUnformatted) {
+#if CONFIG_LOG_EARLY_BUFFER_SIZE
+        // No backend installed yet: keep the line for the first one
+        if (!earlyReplayed_.load(std::memory_order_acquire) && earlyRing_.push(message, length)) return;
+#endif
+        lostWrites_.fetch_add(1);
+    }
+}
+
+void Logger::writeUnformattedToBackends(esp_log_level_t level, const char* tag, const char* format, va_list args) {
+    BackendGuard list(backends_);
+    if (!list) return;
+
+    for (auto& backend : list->items) {
+        if (backend && backend->acceptsUnformatted()) {
+            va_list copy;
+            va_copy(copy, args);
+            backend->writeUnformatted(level, tag, format, copy);
+            va_end(copy);
+        }
+    }
+}
+
+bool Logger::writeBytesToBackends(esp_log_level_t level, const char* tag, const char* label,
+                                  const uint8_t* data, size_t length) {
+    BackendGuard list(backends_);
+    if (!list) return false;
+
+    // Text is only skipped for binary backends if all of them took the bytes
+    bool allTook = true;
+    for (auto& backend : list->items) {
+        if (backend && backend->acceptsUnformatted()) {
+            allTook = backend->writeBytes(level, tag, label, data, length) && allTook;
+        }
+    }
+    return allTook;
+}
+
+void Logger::log(esp_log_level_t level, const char* tag, const char* format, ...) {
+    if (!isLevelEnabledForTag(tag, level)) return;
+    
+    va_list args;
+    va_start(args, format);
+    logV(level, tag, format, args);
+    va_end(args);
+}
+
+void Logger::log(esp_log_level_t level, const LogTag& tag, const char* format, ...) {
+    uint32_t start = stageStart();
+    bool enabled = isLevelEnabledForTag(tag, level);
+    stageEnd(LogStage::FILTER, start);
+    if (!enabled) return;
+
+    va_list args;
+    va_start(args, format);
+    logImpl(level, tag.name, tag.id, format, args);
+    va_end(args);
+}
+
+void Logger::logV(esp_log_level_t level, const char* tag, const char* format, va_list args) {
+    uint32_t start = stageStart();
+    bool enabled = isLevelEnabledForTag(tag, level);
+    stageEnd(LogStage::FILTER, start);
+    if (!enabled) return;
+    logImpl(level, tag, 0, format, args);
+}
+
+void Logger::logImpl(esp_log_level_t level, const char* tag, uint32_t tagId, const char* format, va_list args) {
+    if (coalesceRepeat(level, tag, format)) return;
+
+    uint32_t start = stageStart();
+    bool allowed = checkRateLimit(level, tag, tagId);
+    stageEnd(LogStage::RATE_LIMIT, start);
+    if (!allowed) return;
+
+    // Binary backends take the call before formatting (format ID + raw args)
+    bool unformattedDone = false;
+    if (unformattedBackends_.load() != 0 && DeferredFormat::isInFlash(format)) {
+        writeUnformattedToBackends(level, tag, format, args);
+        unformattedDone = true;
+
+        // Nothing else wants text - skip formatting entirely
+        if (textBackends_.load() == 0 && subscriberCount.load() == 0) return;
+    }
+
+    // Deferred mode: capture arguments only, format on the LogFmt task
+    if (deferredTaskHandle && logDeferred(level, tag, tagId, format, args, unformattedDone)) return;
+
+    size_t bodyOffset, bodyLength;
+    char* buffer = formatLine(level, tag, format, args, bodyOffset, bodyLength);
+    if (!buffer) return;
+
+    outputMessage(level, tag, tagId, buffer, bodyOffset, bodyLength, "\r\n", unformattedDone);
+
+    BufferPool::getInstance().release(buffer);
+}
+
+// Envelope, then the body from render(dst, size) -> full body length
+template <typename Render>
+char* Logger::formatLineWith(esp_log_level_t level, const char* tag, const char* format, Render render,
+                             size_t& bodyOffset, size_t& bodyLength) {
+    auto& pool = BufferPool::getInstance();
+    LineStamp stamp = stampLine();
+
+    // One buffer per message, from the smallest size class the line should fit
+    size_t capacity;
+    uint32_t start = stageStart();
+    char* buffer = pool.acquire(estimateLineLength(tag, stamp.taskLength, format), capacity);
+    stageEnd(LogStage::ACQUIRE, start);
+    if (!buffer) return nullptr;
+
+    start = stageStart();
+    stampDelta(stamp);
+    bodyOffset = formatEnvelope(buffer, capacity, level, tag, stamp);
+    stageEnd(LogStage::ENVELOPE, start);
+
+    start = stageStart();
+    size_t bodySize = capacity - bodyOffset - LINE_END_RESERVE;
+    size_t needed = render(buffer + bodyOffset, bodySize);
+
+    // Estimate was short: format again in a class that holds the whole line
+    if (needed >= bodySize && capacity < BufferPool::LARGE_BUFFER_SIZE) {
+        size_t biggerCapacity;
+        char* bigger = pool.acquire(bodyOffset + needed + LINE_END_RESERVE + 1, biggerCapacity);
+        if (bigger && biggerCapacity > capacity) {
+            pool.release(buffer);
+            buffer = bigger;
+            capacity = biggerCapacity;
+
+            bodyOffset = formatEnvelope(buffer, capacity, level, tag, stamp);
+            bodySize = capacity - bodyOffset - LINE_END_RESERVE;
+            render(buffer + bodyOffset, bodySize);
+        } else if (bigger) {
+            pool.release(bigger);
+        }
+    }
+    stageEnd(LogStage::FORMAT, start);  // Includes a retry in a bigger buffer
+
+    bodyLength = std::min<size_t>(needed, bodySize - 1);
+    return buffer;
+}
+
+char* Logger::formatLine(esp_log_level_t level, const char* tag, const char* format, va_list args,
+                         size_t& bodyOffset, size_t& bodyLength) {
+    return formatLineWith(level, tag, format, [format, args](char* body, size_t size) -> size_t {
+        va_list copy;
+        va_copy(copy, args);
+        int needed = vsnprintf(body, size, format, copy);
+        va_end(copy);
+        return needed < 0 ? 0 : needed;
+    }, bodyOffset, bodyLength);
+}
+
+void Logger::logMessageImpl(esp_log_level_t level, const char* tag, uint32_t tagId,
+                            const LogFormat::Message& message) {
+    if (coalesceRepeat(level, tag, message.format())) return;
+
+    uint32_t start = stageStart();
+    bool allowed = checkRateLimit(level, tag, tagId);
+    stageEnd(LogStage::RATE_LIMIT, start);
+    if (!allowed) return;
+
+    size_t bodyOffset, bodyLength;
+    char* buffer = formatLineWith(level, tag, message.format(), [&message](char* body, size_t size) {
+        return message.render(body, size);
+    }, bodyOffset, bodyLength);
+    if (!buffer) return;
+
+    outputMessage(level, tag, tagId, buffer, bodyOffset, bodyLength, "\r\n");
+
+    BufferPool::getInstance().release(buffer);
+}
+
+Logger::LineStamp Logger::stampLine() {
+    LineStamp stamp;
+    stamp.timeUs = static_cast<uint64_t>(LogPlatform::micros());
+    stamp.deltaUs = 0;
+
+    // Before the scheduler there is no task-local storage to cache in
+    if (!LogPlatform::schedulerRunning()) {
+        const char* name = LogPlatform::taskName();
+        stamp.task = name ? name : "?";
+        stamp.taskLength = static_cast<uint8_t>(strnlen(stamp.task, TASK_NAME_SIZE - 1));
+        stamp.taskId = 0;
+        return stamp;
+    }
+
+    TaskStamp& task = currentTask;
+    if (!task.name) {
+        const char* name = LogPlatform::taskName();
+        task.name = name ? name : "?";
+        task.length = static_cast<uint8_t>(strnlen(task.name, TASK_NAME_SIZE - 1));
+        task.id = nextTaskId.fetch_add(1, std::memory_order_relaxed);
+    }
+    stamp.task = task.name;
+    stamp.taskLength = task.length;
+    stamp.taskId = task.id;
+    return stamp;
+}
+
+void Logger::stampDelta(LineStamp& stamp) {
+    if (!envelopeDelta_.load(std::memory_order_relaxed)) return;
+
+    // Lines from other tasks may be stamped slightly out of order: clamp at 0
+    uint32_t now = static_cast<uint32_t>(stamp.timeUs);
+    int32_t delta = static_cast<int32_t>(now - lastLineUs_.exchange(now, std::memory_order_relaxed));
+    stamp.deltaUs = delta > 0 ? static_cast<uint32_t>(delta) : 0;
+}
+
+size_t Logger::formatEnvelope(char* buffer, size_t capacity, esp_log_level_t level, const char* tag,
+                              const LineStamp& stamp) const {
+    // Always leave room for at least an empty body and the line ending
+    LogFormat::Writer out(buffer, capacity - LINE_END_RESERVE);
+
+    auto time = static_cast<LoggerConfig::Envelope::Time>(envelopeTime_.load(std::memory_order_relaxed));
+    if (time != LoggerConfig::Envelope::Time::NONE) {
+        bool micros = time == LoggerConfig::Envelope::Time::MICROS;
+        out.put('[');
+        out.putUnsigned(micros ? stamp.timeUs : stamp.timeUs / 1000);
+        if (envelopeDelta_.load(std::memory_order_relaxed)) {
+            out.put('+');
+            out.putUnsigned(micros ? stamp.deltaUs : stamp.deltaUs / 1000);
+        }
+        out.put(']');
+    }
+
+    out.put('[');
+    if (stamp.taskId && envelopeTaskId_.load(std::memory_order_relaxed)) {
+        out.put('#');
+        out.putUnsigned(stamp.taskId);
+    } else {
+        out.put(stamp.task, stamp.taskLength);
+    }
+    out.put("][", 2);
+    out.put(levelToString(level), 1);
+    out.put("] ", 2);
+    const char* name = tag ? tag : "?";
+    out.put(name, strlen(name));
+    out.put(": ", 2);
+
+    out.finish();
+    return out.written();
+}
+
+void Logger::outputMessage(esp_log_level_t level, const char* tag, uint32_t tagId, char* buffer,
+                           size_t bodyOffset, size_t bodyLength, const char* lineEnd, bool skipUnformatted) {
+    // Subscribers see only the body (NUL-terminated in place)
+    uint32_t start = stageStart();
+    notifySubscribers(level, tag, tagId, buffer + bodyOffset);
+    stageEnd(LogStage::SUBSCRIBERS, start);
+
+    // Append the line ending over the body's terminator - space was reserved
+    size_t len = bodyOffset + bodyLength;
+    while (*lineEnd) buffer[len++] = *lineEnd++;
+    buffer[len] = '\0';
+
+    start = stageStart();
+    writeToBackends(buffer, len, skipUnformatted);
+    stageEnd(LogStage::BACKENDS, start);
+
+#if CONFIG_LOG_INSTRUMENTATION
+    // Tags are counted in the registry; a new tag is interned on its first line
+    TagLevelTable* table = tagTable();
+    if (tag && !(table && table->countLine(tag, tagId, len)) &&
+        (!table || table->size() < TagLevelTable::CAPACITY) &&
+        internTag(tag, tagId ? tagId : TagLevelTable::hash(tag))) {
+        tagTable()->countLine(tag, tagId, len);
+    }
+#endif
+}
+
+// Deferred record layout: header, optional inline tag, packed arguments
+namespace {
+constexpr size_t DEFERRED_TASK_NAME_SIZE = TASK_NAME_SIZE;
+
+struct DeferredRecord {
+    uint64_t timeUs;
+    const char* format;     // Flash-resident
+    const char* tag;        // Flash-resident, or nullptr if stored inline
+    uint32_t tagId;
+    uint8_t level;
+    uint8_t tagLength;      // Inline tag bytes following the header
+    bool unformattedDone;   // Binary backends already received this call
+    bool trimLineEnd;       // Redirected IDF message: drop its own "\n" / color reset
+    uint16_t taskId;
+    char taskName[DEFERRED_TASK_NAME_SIZE];
+};
+
+static_assert(CONFIG_LOG_DEFERRED_RECORD_SIZE > sizeof(DeferredRecord) + CONFIG_LOG_SUBSCRIBER_TAG_SIZE,
+              "CONFIG_LOG_DEFERRED_RECORD_SIZE too small for record header and tag");
+}  // namespace
+
+bool Logger::logDeferred(esp_log_level_t level, const char* tag, uint32_t tagId, const char* format, va_list args,
+                         bool unformattedDone, bool trimLineEnd) {
+    // The format is kept by pointer - only safe if it outlives the record
+    if (!DeferredFormat::isInFlash(format)) return false;
+
+    // Ring full: dropped and counted, never blocks - and never formatted here instead
+    enqueueDeferred(level, tag, tagId, format, args, unformattedDone, trimLineEnd);
+    return true;
+}
+
+bool Logger::enqueueDeferred(esp_log_level_t level, const char* tag, uint32_t tagId, const char* format,
+                             va_list args, bool unformattedDone, bool trimLineEnd) {
+    // Measure first so the ring only holds the bytes actually needed
+    bool truncated;
+    size_t tagLength = (!tag || DeferredFormat::isInFlash(tag)) ? 0 : strnlen(tag, CONFIG_LOG_SUBSCRIBER_TAG_SIZE - 1);
+    size_t size = sizeof(DeferredRecord) + tagLength + DeferredFormat::pack(format, args, nullptr, 0, truncated);
+    if (size > CONFIG_LOG_DEFERRED_RECORD_SIZE) size = CONFIG_LOG_DEFERRED_RECORD_SIZE;
+
+    uint8_t* payload = deferredRing_.reserve(size);
+    if (!payload) {
+        droppedLogs.fetch_add(1);
+        return false;
+    }
+
+    DeferredRecord header;
+    header.format = format;
+    header.tagId = tagId;
+    header.level = static_cast<uint8_t>(level);
+    header.unformattedDone = unformattedDone;
+    header.trimLineEnd = trimLineEnd;
+
+    // No current task to name inside an interrupt handler
+    const bool fromIsr = LogPlatform::inIsr();
+    LineStamp stamp;
+    if (fromIsr) {
+        stamp.timeUs = static_cast<uint64_t>(LogPlatform::micros());
+        stamp.task = "ISR";
+        stamp.taskLength = 3;
+        stamp.taskId = 0;
+    } else {
+        stamp = stampLine();
+    }
+    header.timeUs = stamp.timeUs;
+    header.taskId = stamp.taskId;
+    memcpy(header.taskName, stamp.task, stamp.taskLength);
+    header.taskName[stamp.taskLength] = '\0';
+
+    // RAM tag (e.g. built at runtime): copy it into the record
+    size_t offset = sizeof(header);
+    header.tag = tagLength ? nullptr : tag;
+    header.tagLength = static_cast<uint8_t>(tagLength);
+    if (tagLength) {
+        memcpy(payload + offset, tag, tagLength);
+        offset += tagLength;
+    }
+    memcpy(payload, &header, sizeof(header));
+
+    // Pack straight into the ring
+    offset += DeferredFormat::pack(format, args, payload + offset, size - offset, truncated);
+    deferredRing_.commit(payload, offset);
+
+    // Only pay for a notification when the task is actually asleep
+    if (deferredTaskWaiting.load() && deferredTaskWaiting.exchange(false)) {
+        LogPlatform::TaskHandle task = deferredTaskHandle;
+        if (task) LogPlatform::notifyTask(task);
+    }
+    return true;
+}
+
+bool Logger::logFromISR(esp_log_level_t level, const char* tag, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    bool queued = logFromISRV(level, tag, format, args);
+    va_end(args);
+    return queued;
+}
+
+bool Logger::logFromISRV(esp_log_level_t level, const char* tag, const char* format, va_list args) {
+    if (!isLevelEnabledForTag(tag, level)) return false;
+
+    // Formatting, backends and subscribers all need a task: only the ring is
+    // safe here. Rejected before the rate check so it spends no tokens
+    if (!deferredTaskHandle || !DeferredFormat::isInFlash(format)) {
+        droppedLogs.fetch_add(1);
+        return false;
+    }
+    if (!checkRateLimit(level, tag, 0)) return false;
+
+    // Binary backends are not called here, so the text path must render it
+    return enqueueDeferred(level, tag, 0, format, args, false, false);
+}
+
+void Logger::renderDeferred(const uint8_t* record, size_t length) {
+    if (length < sizeof(DeferredRecord)) return;
+
+    DeferredRecord header;
+    memcpy(&header, record, sizeof(header));
+
+    size_t offset = sizeof(header);
+    char inlineTag[CONFIG_LOG_SUBSCRIBER_TAG_SIZE];
+    const char* tag = header.tag;
+    if (header.tagLength) {
+        memcpy(inlineTag, record + offset, header.tagLength);
+        inlineTag[header.tagLength] = '\0';
+        tag = inlineTag;
+        offset += header.tagLength;
+    }
+
+    auto& pool = BufferPool::getInstance();
+    char* buffer = pool.acquire();
+    if (!buffer) return;
+
+    // Delta follows render order, which is the order lines are written in
+    LineStamp stamp;
+    stamp.timeUs = header.timeUs;
+    stamp.task = header.taskName;
+    stamp.taskLength = static_cast<uint8_t>(strnlen(header.taskName, DEFERRED_TASK_NAME_SIZE - 1));
+    stamp.taskId = header.taskId;
+    stamp.deltaUs = 0;
+    stampDelta(stamp);
+
+    esp_log_level_t level = static_cast<esp_log_level_t>(header.level);
+    size_t bodyOffset = formatEnvelope(buffer, BufferPool::BUFFER_SIZE, level, tag, stamp);
+    size_t bodyLength = DeferredFormat::render(header.format, record + offset, length - offset, buffer + bodyOffset,
+                                               CONFIG_LOG_BUFFER_SIZE - bodyOffset - LINE_END_RESERVE);
+    if (header.trimLineEnd) {
+        bodyLength -= idfLineEndLength(buffer + bodyOffset, bodyLength);
+        buffer[bodyOffset + bodyLength] = '\0';
+    }
+
+    outputMessage(level, tag, header.tagId, buffer, bodyOffset, bodyLength, "\r\n", header.unformattedDone);
+
+    pool.release(buffer);
+}
+
+bool Logger::startDeferredTask(int coreId) {
+    // Already running?
+    if (deferredTaskHandle != nullptr) {
+        return true;
+    }
+
+    // Allocate ring if not exists
+    if (!deferredRing_.isInitialized() && !deferredRing_.init(CONFIG_LOG_DEFERRED_RING_SIZE)) {
+        return false;
+    }
+
+    deferredTaskRunning.store(true);
+
+    // Create task with optional core affinity
+    // The task cannot exit before stopDeferredTask(), so storing the handle
+    // after creation does not race with its own clear
+    LogPlatform::TaskHandle task = nullptr;
+    if (!LogPlatform::startTask(deferredTaskFunc, "LogFmt", CONFIG_LOG_DEFERRED_TASK_STACK, this,
+                                CONFIG_LOG_DEFERRED_TASK_PRIORITY, coreId, &task)) {
+        deferredTaskRunning.store(false);
+        return false;
+    }
+    deferredTaskHandle.store(task);
+
+    return true;
+}
+
+void Logger::stopDeferredTask() {
+    if (deferredTaskHandle == nullptr) {
+        return;
+    }
+
+    // Signal task to stop; it renders what is queued before exiting
+    deferredTaskRunning.store(false);
+    LogPlatform::notifyTask(deferredTaskHandle);
+
+    // Wait for task to finish (with timeout)
+    for (int i = 0; i < 50 && deferredTaskHandle != nullptr; i++) {
+        LogPlatform::delayMs(10);
+    }
+
+    // Force delete if still running
+    if (deferredTaskHandle != nullptr) {
+        LogPlatform::killTask(deferredTaskHandle);
+        deferredTaskHandle = nullptr;
+    }
+}
+
+void Logger::deferredTaskFunc(void* param) {
+    Logger* logger = static_cast<Logger*>(param);
+    LogRingBuffer& ring = logger->deferredRing_;
+    const uint8_t* record;
+    size_t length;
+
+    while (logger->deferredTaskRunning.load()) {
+        while (ring.peek(record, length)) {
+            logger->renderDeferred(record, length);
+            ring.pop();
+        }
+
+        // Announce sleep before re-checking so a concurrent producer either
+        // sees the flag and notifies, or its record is seen here
+        logger->deferredTaskWaiting.store(true);
+        if (ring.hasPending()) {
+            // Record reserved but not yet committed - poll the producer
+            LogPlatform::waitNotify(1);
+        } else {
+            LogPlatform::waitNotify(100);
+        }
+        logger->deferredTaskWaiting.store(false);
+    }
+
+    // Render what is left so stopping does not lose messages
+    while (ring.peek(record, length)) {
+        logger->renderDeferred(record, length);
+        ring.pop();
+    }
+
+    // Clean exit
+    logger->deferredTaskHandle = nullptr;
+    LogPlatform::endTask();
+}
+
+void Logger::logNnL(esp_log_level_t level, const char* tag, const char* format, ...) {
+    if (!isLevelEnabledForTag(tag, level)) return;
+    if (!checkRateLimit(level, tag, 0)) return;
+
+    auto& pool = BufferPool::getInstance();
+
+    va_list args;
+    va_start(args, format);
+    size_t bodyOffset, bodyLength;
+    char* buffer = formatLine(level, tag, format, args, bodyOffset, bodyLength);
+    va_end(args);
+    if (!buffer) return;
+
+    outputMessage(level, tag, 0, buffer, bodyOffset, bodyLength, "");  // No newline
+
+    pool.release(buffer);
 }
 
 void Logger::logInL(const char* format, ...) {
-    if (!isLoggingEnabled.load()) return;
-    if (!checkRateLimit()) return;
+    if (!loggingEnabled()) return;
+    if (!checkRateLimit(ESP_LOG_INFO, "INL", 0)) return;
 
     auto& pool = BufferPool::getInstance();
 
@@ -602,7 +1809,7 @@ void Logger::logInL(const char* format, ...) {
     va_end(args);
 
     // Notify subscribers (using INFO level and "INL" tag for inline logs)
-    notifySubscribers(ESP_LOG_INFO, "INL", formatBuffer);
+    notifySubscribers(ESP_LOG_INFO, "INL", 0, formatBuffer);
 
     writeToBackends(formatBuffer, strlen(formatBuffer));
     pool.release(formatBuffer);
@@ -613,46 +1820,178 @@ void Logger::logDirect(esp_log_level_t level, const char* tag, const char* messa
     if (!isLevelEnabledForTag(tag, level)) return;
     // Note: logDirect intentionally bypasses rate limiting but still notifies subscribers
 
-    // Notify subscribers with the raw message
-    notifySubscribers(level, tag, message);
-
     auto& pool = BufferPool::getInstance();
-
-    char* fullMessage = pool.acquire();
-    if (fullMessage) {
-        int len = snprintf(fullMessage, CONFIG_LOG_BUFFER_SIZE,
-                          "[%lu][%s][%s] %s: %s\r\n",
-                          millis(),
-                          pcTaskGetName(NULL) ?: "?",
-                          levelToString(level),
-                          tag ?: "?",
-                          message);
-
-        writeToBackends(fullMessage, len);
-        pool.release(fullMessage);
+    LineStamp stamp = stampLine();
+
+    // The length is known up front - pick the size class directly
+    size_t capacity;
+    size_t estimate = estimateLineLength(tag, stamp.taskLength, "") + strnlen(message, BufferPool::LARGE_BUFFER_SIZE);
+    char* buffer = pool.acquire(estimate, capacity);
+    if (buffer) {
+        stampDelta(stamp);
+        size_t bodyOffset = formatEnvelope(buffer, capacity, level, tag, stamp);
+        size_t bodyLength = strnlen(message, capacity - bodyOffset - LINE_END_RESERVE - 1);
+        memcpy(buffer + bodyOffset, message, bodyLength);
+        buffer[bodyOffset + bodyLength] = '\0';
+
+        // Subscribers get the raw message via the body pointer
+        outputMessage(level, tag, 0, buffer, bodyOffset, bodyLength, "\r\n");
+        pool.release(buffer);
     } else {
+        notifySubscribers(level, tag, 0, message);
         esp_log_write(level, tag, "%s", message);
     }
 }
 
+void Logger::logHex(esp_log_level_t level, const char* tag, const void* data, size_t length, const char* label) {
+    if (!data && length) return;
+    if (!isLevelEnabledForTag(tag, level)) return;
+    if (!checkRateLimit(level, tag, 0)) return;  // One message, however long
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    bool binaryDone = false;
+    if (unformattedBackends_.load() != 0) {
+        binaryDone = writeBytesToBackends(level, tag, label, bytes, length);
+        if (binaryDone && textBackends_.load() == 0 && subscriberCount.load() == 0) return;
+    }
+
+    auto& pool = BufferPool::getInstance();
+    LineStamp stamp = stampLine();
+    size_t labelLength = label ? strlen(label) : 0;
+
+    // Envelope, "label (N bytes):" and three characters per byte
+    size_t capacity;
+    char* buffer = pool.acquire(estimateLineLength(tag, stamp.taskLength, "") + labelLength + 20 + length * 3, capacity);
+    if (!buffer) return;
+
+    stampDelta(stamp);
+    size_t bodyOffset = formatEnvelope(buffer, capacity, level, tag, stamp);
+    size_t bodySize = capacity - bodyOffset - LINE_END_RESERVE;
+
+    LogFormat::Writer out(buffer + bodyOffset, bodySize);
+    if (label) {
+        out.put(label, labelLength);
+        out.put(' ');
+    }
+    out.put('(');
+    out.putUnsigned(length);
+    out.put(" bytes):", 8);
+
+    // Whole bytes only; keep room for the " ..." marker if some are cut off
+    size_t room = bodySize - 1 - out.written();
+    bool cut = length * 3 > room;
+    size_t shown = !cut ? length : (room >= 4 ? (room - 4) / 3 : 0);
+
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
+    char* p = buffer + bodyOffset + out.written();
+    for (size_t i = 0; i < shown; i++) {
+        *p++ = ' ';
+        *p++ = HEX_DIGITS[bytes[i] >> 4];
+        *p++ = HEX_DIGITS[bytes[i] & 0x0F];
+    }
+    if (cut && room >= 4) {
+        memcpy(p, " ...", 4);
+        p += 4;
+    }
+    *p = '\0';
+
+    outputMessage(level, tag, 0, buffer, bodyOffset, p - (buffer + bodyOffset), "\r\n", binaryDone);
+    pool.release(buffer);
+}
+
+LogEvent Logger::event(esp_log_level_t level, const char* tag, const char* message) {
+    // Backends and subscribers run on emit(): never from an ISR
+    bool enabled = !LogPlatform::inIsr() && isLevelEnabledForTag(tag, level) && checkRateLimit(level, tag, 0);
+    return LogEvent(enabled ? this : nullptr, level, tag, 0, message);
+}
+
+LogEvent Logger::event(esp_log_level_t level, const LogTag& tag, const char* message) {
+    bool enabled = !LogPlatform::inIsr() && isLevelEnabledForTag(tag, level) &&
+                   checkRateLimit(level, tag.name, tag.id);
+    return LogEvent(enabled ? this : nullptr, level, tag.name, tag.id, message);
+}
+
+bool LogEvent::emit() {
+    if (!buffer_) return false;
+    bool delivered = logger_->emitEvent(level_, tag_, tagId_, message_, fields_.data(), fields_.length());
+    buffer_.reset();
+    return delivered;
+}
+
+bool Logger::emitEvent(esp_log_level_t level, const char* tag, uint32_t tagId, const char* message,
+                       const uint8_t* fields, size_t fieldsLength) {
+    if (!loggingEnabled()) return false;
+
+    BackendGuard list(backends_);
+    size_t count = list ? list->items.size() : 0;
+
+    // Typed first; a bit per backend that took the fields (past 32 get text)
+    uint32_t took = 0;
+    size_t offered = 0;
+    for (size_t i = 0; i < count && i < 32; i++) {
+        auto& backend = list->items[i];
+        if (!backend) continue;
+        offered++;
+        if (backend->writeFields(level, tag, message, fields, fieldsLength)) took |= 1u << i;
+    }
+    size_t taken = static_cast<size_t>(__builtin_popcount(took));
+    if (taken && taken == offered && count <= 32 && subscriberCount.load() == 0) return true;
+
+    size_t bodyOffset, bodyLength;
+    char* buffer = formatLineWith(level, tag, message ? message : "", [message, fields, fieldsLength](char* body,
+                                                                                                    size_t size) {
+        LogFormat::Writer out(body, size);
+        if (message) {
+            out.put(message, strlen(message));
+            if (fieldsLength) out.put(' ');
+        }
+        LogFields::renderText(out, fields, fieldsLength);
+        return out.finish();
+    }, bodyOffset, bodyLength);
+    if (!buffer) return taken != 0;
+
+    notifySubscribers(level, tag, tagId, buffer + bodyOffset, fields, fieldsLength);
+
+    // Line ending over the body's terminator - space was reserved
+    size_t len = bodyOffset + bodyLength;
+    buffer[len++] = '\r';
+    buffer[len++] = '\n';
+    buffer[len] = '\0';
+
+    bool delivered = taken != 0;
+    for (size_t i = 0; i < count; i++) {
+        auto& backend = list->items[i];
+        if (backend && !(i < 32 && (took & (1u << i)))) {
+            backend->write(buffer, len);
+            delivered = true;
+        }
+    }
+    // No backend: kept for the first one, or counted as a lost write
+    if (!delivered) writeToBackends(buffer, len);
+
+    BufferPool::getInstance().release(buffer);
+    return delivered;
+}
+
 void Logger::flush() {
-    // Flush directly without mutex if scheduler not started (single-threaded)
-    if (!backendMutex) {
-        for (auto& backend : backends) {
-            if (backend) {
-                backend->flush();
-            }
+    // Pending repeat counts go out with everything else
+    if (dedupWindowMs_.load(std::memory_order_relaxed) != 0) flushRepeats();
+
+    // Give the deferred task a bounded chance to render queued records
+    if (deferredTaskHandle && LogPlatform::currentTask() != deferredTaskHandle) {
+        uint32_t start = LogPlatform::millis();
+        while (deferredRing_.hasPending() &&
+               (LogPlatform::millis() - start) < LoggerConfig::MUTEX_STANDARD_TIMEOUT_MS) {
+            LogPlatform::delayMs(1);
         }
-        return;
     }
 
-    if (xSemaphoreTake(backendMutex, pdMS_TO_TICKS(LoggerConfig::MUTEX_SHORT_TIMEOUT_MS)) == pdTRUE) {
-        for (auto& backend : backends) {
-            if (backend) {
-                backend->flush();
-            }
+    BackendGuard list(backends_);
+    if (!list) return;
+    for (auto& backend : list->items) {
+        if (backend) {
+            backend->flush();
         }
-        xSemaphoreGive(backendMutex);
     }
 }
 
@@ -660,80 +1999,207 @@ void Logger::resetDroppedLogs() {
     droppedLogs.store(0);
 }
 
+bool Logger::getStats(LogStats& stats) const {
+#if CONFIG_LOG_INSTRUMENTATION
+    stageStats_.snapshot(stats);
+    const TagLevelTable* table = tagTable();
+    stats.tagCount = table ? table->snapshotCounts(stats.tags, CONFIG_LOG_MAX_TAGS) : 0;
+    return true;
+#else
+    (void)stats;
+    return false;
+#endif
+}
+
+LogFootprint Logger::getFootprint() const {
+    LogFootprint footprint = {};
+    footprint.logger = sizeof(Logger);
+    footprint.bufferPool = sizeof(BufferPool);
+
+    BufferPool::ClassStats large = BufferPool::getInstance().getClassStats(BufferPool::SizeClass::LARGE);
+    footprint.largeInPsram = large.inPsram;
+
+#if !CONFIG_LOG_STATIC_ALLOCATION
+    // With static allocation these live inside the Logger / BufferPool objects
+    footprint.largeBuffers = large.bufferSize * large.count;
+    if (tagTable()) footprint.tagTable = sizeof(TagLevelTable);
+    if (repeats_.load()) footprint.repeatSlots = sizeof(RepeatSlot) * CONFIG_LOG_DEDUP_SLOTS;
+    size_t mutexes = (backendMutex.load() ? 1 : 0) + (subscriberMutex.load() ? 1 : 0) + (tagMutex.load() ? 1 : 0);
+    footprint.mutexes = mutexes * LogPlatform::mutexSize();
+    if (subscribers_.writerView()) footprint.subscriberRing = sizeof(SubscriberList);
+    if (const BackendList* list = backends_.writerView()) {
+        footprint.backendList = sizeof(BackendList) + list->items.capacity() * sizeof(list->items[0]);
+    }
+#endif
+
+    footprint.subscriberRing += subscriberRing_.capacity();
+    footprint.deferredRing = deferredRing_.capacity();
+    if (subscriberTaskHandle) footprint.taskStacks += CONFIG_LOG_SUBSCRIBER_TASK_STACK;
+    if (deferredTaskHandle.load()) footprint.taskStacks += CONFIG_LOG_DEFERRED_TASK_STACK;
+    return footprint;
+}
+
+void Logger::resetStats() {
+#if CONFIG_LOG_INSTRUMENTATION
+    stageStats_.reset();
+    if (TagLevelTable* table = tagTable()) table->resetCounts();
+#endif
+}
+
 void Logger::enableESPLogRedirection() {
     // Redirect ESP-IDF logs through our logger
-    esp_log_set_vprintf(&esp_log_redirect);
+    esp_log_set_vprintf(&Logger::espLogRedirect);
 }
 
 // Log subscriber implementation
-bool Logger::addLogSubscriber(LogSubscriberCallback callback) {
-    if (callback == nullptr) {
-        return false;
+
+// Queued subscriber record; followed by the tag (only when inlineTag is
+// set) and the message text, each NUL-terminated, then event fields
+struct SubscriberRecord {
+    uint32_t tagId;     // Tag hash - filters match on it even when not registered
+    uint8_t level;
+    uint8_t inlineTag;  // Tag name follows (registry full)
+    uint8_t tagLength;
+    uint8_t fieldsLength;  // Logger::event() fields after the text (CONFIG_LOG_EVENT_FIELDS_SIZE <= 255)
+};
+
+bool LogSubscriberFilter::addTag(const char* tag) {
+    if (!tag) return false;
+    return addTag(LogTag(TagLevelTable::hash(tag), tag));
+}
+
+bool LogSubscriberFilter::addTag(LogTag tag) {
+    for (size_t i = 0; i < CONFIG_LOG_SUBSCRIBER_FILTER_TAGS; i++) {
+        if (tagIds[i] == tag.id) return true;
+        if (tagIds[i] == 0) {
+            tagIds[i] = tag.id;
+            return true;
+        }
     }
+    return false;
+}
+
+bool LogSubscriberFilter::accepts(esp_log_level_t level, uint32_t tagId) const {
+    if ((levelMask & (1u << level)) == 0) return false;
+    if (tagIds[0] == 0) return true;  // No tag filter
+    for (size_t i = 0; i < CONFIG_LOG_SUBSCRIBER_FILTER_TAGS && tagIds[i] != 0; i++) {
+        if (tagIds[i] == tagId) return true;
+    }
+    return false;
+}
 
-    // Thread safety - only if mutex available
-    if (subscriberMutex && xSemaphoreTake(subscriberMutex, pdMS_TO_TICKS(LoggerConfig::MUTEX_SHORT_TIMEOUT_MS)) != pdTRUE) {
+template <typename Edit>
+bool Logger::updateSubscribers(Edit edit) {
+    // Writers are serialized by subscriberMutex (not needed before the scheduler)
+    LogPlatform::MutexHandle mutex = writerMutex(subscriberMutex);
+    if (mutex && !LogPlatform::takeMutex(mutex, LoggerConfig::MUTEX_SHORT_TIMEOUT_MS)) {
         return false;
     }
 
-    bool result = false;
-    uint8_t count = subscriberCount.load();
+    // Copy, edit, publish - the dispatch path never waits for this
+    const SubscriberList* current = subscribers_.writerView();
+#if CONFIG_LOG_STATIC_ALLOCATION
+    // The idle list has no readers: the swap that retired it waited them out
+    SubscriberList* next = current == &subscriberLists_[0] ? &subscriberLists_[1] : &subscriberLists_[0];
+    *next = current ? *current : SubscriberList();
+#else
+    SubscriberList* next = current ? new SubscriberList(*current) : new SubscriberList();
+#endif
+    bool result = edit(*next);
+    if (result) {
+        subscriberCount.store(next->count);
+#if CONFIG_LOG_STATIC_ALLOCATION
+        subscribers_.exchange(next);
+#else
+        subscribers_.replace(next);
+    } else {
+        delete next;
+#endif
+    }
 
-    // Check for duplicates and available slots
-    if (count < MAX_SUBSCRIBERS) {
-        bool isDuplicate = false;
-        for (uint8_t i = 0; i < count; i++) {
-            if (subscribers[i] == callback) {
-                isDuplicate = true;
-                break;
+    if (mutex) {
+        LogPlatform::giveMutex(mutex);
+    }
+    return result;
+}
+
+bool Logger::addSubscriberEntry(const SubscriberEntry& entry) {
+    return updateSubscribers([&](SubscriberList& list) {
+        // Check for duplicates and available slots
+        if (list.count >= MAX_SUBSCRIBERS) return false;
+        for (uint8_t i = 0; i < list.count; i++) {
+            if (list.items[i].callback == entry.callback && list.items[i].batchCallback == entry.batchCallback) {
+                return false;
             }
         }
+        list.items[list.count++] = entry;
+        return true;
+    });
+}
 
-        if (!isDuplicate) {
-            subscribers[count] = callback;
-            subscriberCount.store(count + 1);
-            result = true;
+bool Logger::removeSubscriberEntry(LogSubscriberCallback callback, LogBatchCallback batchCallback) {
+    return updateSubscribers([&](SubscriberList& list) {
+        for (uint8_t i = 0; i < list.count; i++) {
+            if (list.items[i].callback == callback && list.items[i].batchCallback == batchCallback) {
+                // Shift remaining subscribers down
+                for (uint8_t j = i; j + 1 < list.count; j++) {
+                    list.items[j] = list.items[j + 1];
+                }
+                list.items[--list.count] = SubscriberEntry();
+                return true;
+            }
         }
-    }
+        return false;
+    });
+}
 
-    if (subscriberMutex) {
-        xSemaphoreGive(subscriberMutex);
+bool Logger::addLogSubscriber(LogSubscriberCallback callback, const LogSubscriberFilter& filter) {
+    if (callback == nullptr) {
+        return false;
     }
 
-    return result;
+    SubscriberEntry entry;
+    entry.callback = callback;
+    entry.filter = filter;
+    return addSubscriberEntry(entry);
 }
 
-bool Logger::removeLogSubscriber(LogSubscriberCallback callback) {
+bool Logger::addLogBatchSubscriber(LogBatchCallback callback, const LogSubscriberFilter& filter) {
     if (callback == nullptr) {
         return false;
     }
 
-    if (subscriberMutex && xSemaphoreTake(subscriberMutex, pdMS_TO_TICKS(LoggerConfig::MUTEX_SHORT_TIMEOUT_MS)) != pdTRUE) {
-        return false;
-    }
+    SubscriberEntry entry;
+    entry.batchCallback = callback;
+    entry.filter = filter;
+    return addSubscriberEntry(entry);
+}
 
-    bool result = false;
-    uint8_t count = subscriberCount.load();
+bool Logger::removeLogSubscriber(LogSubscriberCallback callback) {
+    return callback != nullptr && removeSubscriberEntry(callback, nullptr);
+}
 
-    for (uint8_t i = 0; i < count; i++) {
-        if (subscribers[i] == callback) {
-            // Shift remaining subscribers down
-            for (uint8_t j = i; j < count - 1; j++) {
-                subscribers[j] = subscribers[j + 1];
-            }
-            count--;
-            subscribers[count] = nullptr;
-            subscriberCount.store(count);
-            result = true;
-            break;
-        }
-    }
+bool Logger::removeLogSubscriber(LogBatchCallback callback) {
+    return callback != nullptr && removeSubscriberEntry(nullptr, callback);
+}
 
-    if (subscriberMutex) {
-        xSemaphoreGive(subscriberMutex);
+uint8_t Logger::snapshotSubscribers(SubscriberEntry* out) const {
+    // Copy out so callbacks run without a read guard (they may re-register)
+    SubscriberGuard list(subscribers_);
+    if (!list) return 0;
+    for (uint8_t i = 0; i < list->count; i++) {
+        out[i] = list->items[i];
     }
+    return list->count;
+}
 
-    return result;
+bool Logger::anySubscriberAccepts(esp_log_level_t level, uint32_t tagId) const {
+    SubscriberGuard list(subscribers_);
+    if (!list) return false;
+    for (uint8_t i = 0; i < list->count; i++) {
+        if (list->items[i].filter.accepts(level, tagId)) return true;
+    }
+    return false;
 }
 
 bool Logger::startSubscriberTask(int coreId) {
@@ -742,176 +2208,242 @@ bool Logger::startSubscriberTask(int coreId) {
         return true;
     }
 
-    // Create queue if not exists
-    if (subscriberQueue == nullptr) {
-        subscriberQueue = xQueueCreate(CONFIG_LOG_SUBSCRIBER_QUEUE_SIZE, sizeof(LogSubscriberMessage));
-        if (subscriberQueue == nullptr) {
-            return false;
-        }
+    // Allocate ring if not exists
+    if (!subscriberRing_.isInitialized() && !subscriberRing_.init(CONFIG_LOG_SUBSCRIBER_RING_SIZE)) {
+        return false;
     }
 
     subscriberTaskRunning.store(true);
 
-    // Create task with optional core affinity
-    BaseType_t result;
-    if (coreId >= 0 && coreId <= 1) {
-        result = xTaskCreatePinnedToCore(
-            subscriberTaskFunc,
-            "LogSub",
-            CONFIG_LOG_SUBSCRIBER_TASK_STACK,
-            this,
-            CONFIG_LOG_SUBSCRIBER_TASK_PRIORITY,
-            &subscriberTaskHandle,
-            coreId
-        );
-    } else {
-        result = xTaskCreate(
-            subscriberTaskFunc,
-            "LogSub",
-            CONFIG_LOG_SUBSCRIBER_TASK_STACK,
-            this,
-            CONFIG_LOG_SUBSCRIBER_TASK_PRIORITY,
-            &subscriberTaskHandle
-        );
-    }
-
-    if (result != pdPASS) {
+    // Create task with optional core affinity (handle stored as in startDeferredTask())
+    LogPlatform::TaskHandle task = nullptr;
+    if (!LogPlatform::startTask(subscriberTaskFunc, "LogSub", CONFIG_LOG_SUBSCRIBER_TASK_STACK, this,
+                                CONFIG_LOG_SUBSCRIBER_TASK_PRIORITY, coreId, &task)) {
         subscriberTaskRunning.store(false);
-        subscriberTaskHandle = nullptr;
         return false;
     }
+    subscriberTaskHandle.store(task);
 
     return true;
 }
 
 void Logger::stopSubscriberTask() {
-    if (subscriberTaskHandle == nullptr) {
+    LogPlatform::TaskHandle running = subscriberTaskHandle.load();
+    if (running == nullptr) {
         return;
     }
 
-    // Signal task to stop
+    // Signal task to stop; it delivers what is queued before exiting
     subscriberTaskRunning.store(false);
-
-    // Send a dummy message to wake up the task if it's blocked on queue
-    if (subscriberQueue) {
-        LogSubscriberMessage dummy = {};
-        xQueueSend(subscriberQueue, &dummy, 0);
-    }
+    LogPlatform::notifyTask(running);
 
     // Wait for task to finish (with timeout)
     for (int i = 0; i < 50 && subscriberTaskHandle != nullptr; i++) {
-        vTaskDelay(pdMS_TO_TICKS(10));
+        LogPlatform::delayMs(10);
     }
 
     // Force delete if still running
-    if (subscriberTaskHandle != nullptr) {
-        vTaskDelete(subscriberTaskHandle);
-        subscriberTaskHandle = nullptr;
+    LogPlatform::TaskHandle task = subscriberTaskHandle.exchange(nullptr);
+    if (task != nullptr) {
+        LogPlatform::killTask(task);
     }
+}
+
+bool Logger::decodeSubscriberRecord(const uint8_t* record, size_t length, LogSubscriberEntryView& view,
+                                    uint32_t& tagId) const {
+    if (length < sizeof(SubscriberRecord)) return false;
+
+    SubscriberRecord header;
+    memcpy(&header, record, sizeof(header));
+    const char* text = reinterpret_cast<const char*>(record + sizeof(header));
 
-    // Clean up queue
-    if (subscriberQueue) {
-        vQueueDelete(subscriberQueue);
-        subscriberQueue = nullptr;
+    // Resolve the tag: registry lookup, or the inline copy
+    if (header.inlineTag) {
+        view.tag = text;
+        text += header.tagLength + 1;
+    } else {
+        view.tag = getTagName(header.tagId);
+        if (!view.tag) view.tag = "?";
     }
+    view.level = static_cast<esp_log_level_t>(header.level);
+    view.message = text;  // Read in place in the ring
+    view.fieldsLength = header.fieldsLength;
+    view.fields = header.fieldsLength ? record + length - header.fieldsLength : nullptr;
+    tagId = header.tagId;
+    return true;
 }
 
-void Logger::subscriberTaskFunc(void* param) {
-    Logger* logger = static_cast<Logger*>(param);
-    LogSubscriberMessage msg;
+void Logger::dispatchSubscriberBatch(const uint8_t* const* records, const size_t* lengths, size_t count,
+                                     const SubscriberEntry* subscribers, uint8_t entryCount) {
+    LogSubscriberEntryView views[CONFIG_LOG_SUBSCRIBER_BATCH_SIZE];
+    uint32_t tagIds[CONFIG_LOG_SUBSCRIBER_BATCH_SIZE];
+    size_t viewCount = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (decodeSubscriberRecord(records[i], lengths[i], views[viewCount], tagIds[viewCount])) viewCount++;
+    }
 
-    while (logger->subscriberTaskRunning.load()) {
-        // Wait for message (with timeout to check running flag)
-        if (xQueueReceive(logger->subscriberQueue, &msg, pdMS_TO_TICKS(100)) == pdTRUE) {
-            // Check if we should stop
-            if (!logger->subscriberTaskRunning.load()) {
-                break;
+    LogSubscriberEntryView selected[CONFIG_LOG_SUBSCRIBER_BATCH_SIZE];
+    for (uint8_t s = 0; s < entryCount; s++) {
+        const SubscriberEntry& sub = subscribers[s];
+        size_t selectedCount = 0;
+        for (size_t i = 0; i < viewCount; i++) {
+            if (!sub.filter.accepts(views[i].level, tagIds[i])) continue;
+            if (sub.callback) {
+                sub.callback(views[i].level, views[i].tag, views[i].message);
+            } else {
+                selected[selectedCount++] = views[i];
             }
+        }
+        if (sub.batchCallback && selectedCount) {
+            sub.batchCallback(selected, selectedCount);
+        }
+    }
+}
 
-            // Get a snapshot of callbacks
-            Logger::LogSubscriberCallback localCallbacks[MAX_SUBSCRIBERS];
-            uint8_t localCount = 0;
-
-            if (logger->subscriberMutex &&
-                xSemaphoreTake(logger->subscriberMutex, pdMS_TO_TICKS(LoggerConfig::MUTEX_SHORT_TIMEOUT_MS)) == pdTRUE) {
-                localCount = logger->subscriberCount.load();
-                for (uint8_t i = 0; i < localCount; i++) {
-                    localCallbacks[i] = logger->subscribers[i];
-                }
-                xSemaphoreGive(logger->subscriberMutex);
+void Logger::subscriberTaskFunc(void* param) {
+    Logger* logger = static_cast<Logger*>(param);
+    LogRingBuffer& ring = logger->subscriberRing_;
+    SubscriberEntry subscribers[MAX_SUBSCRIBERS];
+    const uint8_t* records[CONFIG_LOG_SUBSCRIBER_BATCH_SIZE];
+    size_t lengths[CONFIG_LOG_SUBSCRIBER_BATCH_SIZE];
+
+    // Deliver everything committed, CONFIG_LOG_SUBSCRIBER_BATCH_SIZE at a time
+    auto drain = [&]() {
+        uint8_t entryCount = 0;
+        bool haveSnapshot = false;
+        for (;;) {
+            uint32_t cursor = ring.cursor();
+            size_t count = 0;
+            while (count < CONFIG_LOG_SUBSCRIBER_BATCH_SIZE && ring.peekNext(cursor, records[count], lengths[count])) {
+                count++;
             }
+            if (count == 0) return;
 
-            // Invoke callbacks (without mutex held)
-            for (uint8_t i = 0; i < localCount; i++) {
-                if (localCallbacks[i] != nullptr) {
-                    localCallbacks[i](msg.level, msg.tag, msg.message);
-                }
+            // One snapshot per wake-up, not per message
+            if (!haveSnapshot) {
+                entryCount = logger->snapshotSubscribers(subscribers);
+                haveSnapshot = true;
             }
+            logger->dispatchSubscriberBatch(records, lengths, count, subscribers, entryCount);
+            ring.popUntil(cursor);
+        }
+    };
+
+    while (logger->subscriberTaskRunning.load()) {
+        drain();
+
+        // Announce sleep before re-checking so a concurrent producer either
+        // sees the flag and notifies, or its record is seen here
+        logger->subscriberTaskWaiting.store(true);
+        if (ring.hasPending()) {
+            // Record reserved but not yet committed - poll the producer
+            LogPlatform::waitNotify(1);
+        } else {
+            LogPlatform::waitNotify(100);
         }
+        logger->subscriberTaskWaiting.store(false);
     }
 
+    // Deliver what is left so stopping does not lose messages
+    drain();
+
     // Clean exit
     logger->subscriberTaskHandle = nullptr;
-    vTaskDelete(nullptr);
+    LogPlatform::endTask();
 }
 
-void Logger::notifySubscribers(esp_log_level_t level, const char* tag, const char* message) {
+void Logger::notifySubscribers(esp_log_level_t level, const char* tag, uint32_t tagId, const char* message,
+                               const uint8_t* fields, size_t fieldsLength) {
     // Fast path - no subscribers registered (atomic load is cheap)
     if (subscriberCount.load() == 0) {
         return;
     }
 
     // Safety check - don't queue from ISR context
-    if (xPortInIsrContext()) {
+    if (LogPlatform::inIsr()) {
         return;
     }
 
-    // If queue exists, use async notification (preferred)
-    if (subscriberQueue) {
-        LogSubscriberMessage msg;
-        msg.level = level;
+    // Filter before queueing: nobody wants it, nothing is copied
+    if (tag && !tagId) tagId = TagLevelTable::hash(tag);
+    if (!anySubscriberAccepts(level, tagId)) {
+        return;
+    }
 
-        // Safe string copy with null termination
-        if (tag) {
-            strncpy(msg.tag, tag, CONFIG_LOG_SUBSCRIBER_TAG_SIZE - 1);
-            msg.tag[CONFIG_LOG_SUBSCRIBER_TAG_SIZE - 1] = '\0';
-        } else {
-            msg.tag[0] = '\0';
+    // If the task runs, queue a variable-length record (preferred)
+    if (subscriberTaskHandle != nullptr) {
+        SubscriberRecord header;
+        header.level = static_cast<uint8_t>(level);
+        header.tagId = tagId;
+
+        // Queue the tag as its registry ID instead of copying the string.
+        // Never waits on tagMutex - a full table or a busy mutex just means
+        // the tag is copied inline this time.
+        header.inlineTag = tag != nullptr;
+        TagLevelTable* table = tagTable();
+        if (tag && table) {
+            if (table->contains(tagId)) {
+                header.inlineTag = false;
+            } else if (table->size() < TagLevelTable::CAPACITY) {
+                LogPlatform::MutexHandle mutex = writerMutex(tagMutex);
+                if (!mutex) {
+                    header.inlineTag = !table->intern(tag, tagId);
+                } else if (LogPlatform::takeMutex(mutex, 0)) {
+                    header.inlineTag = !table->intern(tag, tagId);
+                    LogPlatform::giveMutex(mutex);
+                }
+            }
         }
-
-        if (message) {
-            strncpy(msg.message, message, CONFIG_LOG_SUBSCRIBER_MSG_SIZE - 1);
-            msg.message[CONFIG_LOG_SUBSCRIBER_MSG_SIZE - 1] = '\0';
-        } else {
-            msg.message[0] = '\0';
+        size_t tagLength = header.inlineTag ? strnlen(tag, CONFIG_LOG_SUBSCRIBER_TAG_SIZE - 1) : 0;
+        header.tagLength = static_cast<uint8_t>(tagLength);
+
+        size_t textLength = message ? strnlen(message, CONFIG_LOG_SUBSCRIBER_MSG_SIZE - 1) : 0;
+        size_t tagSpace = header.inlineTag ? tagLength + 1 : 0;
+        header.fieldsLength = static_cast<uint8_t>(fields ? fieldsLength : 0);
+        size_t size = sizeof(header) + tagSpace + textLength + 1 + header.fieldsLength;
+
+        // Non-blocking - drop (and count) if the ring is full
+        uint8_t* payload = subscriberRing_.reserve(size);
+        if (!payload) {
+            subscriberDrops_.fetch_add(1);
+            return;
         }
 
-        // Non-blocking send - drop message if queue is full
-        xQueueSend(subscriberQueue, &msg, 0);
+        memcpy(payload, &header, sizeof(header));
+        char* out = reinterpret_cast<char*>(payload + sizeof(header));
+        if (tagSpace) {
+            // Unregistered tag: store "tag\0" in front of the message text
+            if (tagLength) memcpy(out, tag, tagLength);
+            out[tagLength] = '\0';
+            out += tagSpace;
+        }
+        if (textLength) memcpy(out, message, textLength);
+        out[textLength] = '\0';
+        if (header.fieldsLength) memcpy(out + textLength + 1, fields, header.fieldsLength);
+        subscriberRing_.commit(payload, size);
+
+        // Only pay for a notification when the task is actually asleep
+        if (subscriberTaskWaiting.load() && subscriberTaskWaiting.exchange(false)) {
+            LogPlatform::TaskHandle task = subscriberTaskHandle;
+            if (task) LogPlatform::notifyTask(task);
+        }
         return;
     }
 
     // Fallback: synchronous notification (legacy behavior, not recommended)
     // Only used if startSubscriberTask() was never called
 
-    // Copy callbacks while holding mutex to avoid calling with mutex held
-    LogSubscriberCallback localCallbacks[MAX_SUBSCRIBERS];
-    uint8_t localCount = 0;
-
-    if (subscriberMutex && xSemaphoreTake(subscriberMutex, pdMS_TO_TICKS(LoggerConfig::MUTEX_SHORT_TIMEOUT_MS)) == pdTRUE) {
-        localCount = subscriberCount.load();
-        for (uint8_t i = 0; i < localCount; i++) {
-            localCallbacks[i] = subscribers[i];
-        }
-        xSemaphoreGive(subscriberMutex);
-    } else {
-        return;  // Can't get mutex - skip notification
-    }
-
-    // Invoke callbacks WITHOUT holding mutex (prevents deadlock on reentrant logging)
+    // Invoke callbacks from a copy (prevents deadlock on reentrant logging)
+    SubscriberEntry localSubscribers[MAX_SUBSCRIBERS];
+    uint8_t localCount = snapshotSubscribers(localSubscribers);
+    LogSubscriberEntryView view = {level, tag ? tag : "", message ? message : "", fields, fields ? fieldsLength : 0};
     for (uint8_t i = 0; i < localCount; i++) {
-        if (localCallbacks[i] != nullptr) {
-            localCallbacks[i](level, tag, message);
+        const SubscriberEntry& sub = localSubscribers[i];
+        if (!sub.filter.accepts(level, tagId)) continue;
+        if (sub.callback) {
+            sub.callback(level, tag, message);
+        } else if (sub.batchCallback) {
+            sub.batchCallback(&view, 1);
         }
     }
 }
@@ -25,22 +25,28 @@
 
 #pragma once
 
-#include <Arduino.h>
+#include "LogPlatform.h"
 #include "ILogger.h"
 #include "ILogBackend.h"
 #include <memory>
-#include <esp32-hal-log.h>
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
-#include <freertos/queue.h>
-#include <freertos/task.h>
 #include <string>
 #include <inttypes.h>
 #include <cstring>
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <utility>
 #include <vector>
 #include "LoggerConfig.h"
+#include "TagLevelTable.h"
+#include "LogFilter.h"
+#include "RcuPointer.h"
+#include "LogRingBuffer.h"
+#include "DeferredFormat.h"
+#include "LogFormat.h"
+#include "LogFields.h"
+#include "LogStats.h"
+#include "AsyncRingBackend.h"
 
 #ifndef CONFIG_LOG_BUFFER_SIZE
 #define CONFIG_LOG_BUFFER_SIZE 256  // Reduced for memory efficiency
@@ -54,8 +60,44 @@
 #define CONFIG_LOG_BUFFER_POOL_SIZE 8  // Buffer pool size for thread safety
 #endif
 
-#ifndef CONFIG_LOG_SUBSCRIBER_QUEUE_SIZE
-#define CONFIG_LOG_SUBSCRIBER_QUEUE_SIZE 16  // Queue depth for async subscriber notifications
+#ifndef CONFIG_LOG_BUFFER_SMALL_SIZE
+#define CONFIG_LOG_BUFFER_SMALL_SIZE 64  // Small buffer class (short lines)
+#endif
+
+#ifndef CONFIG_LOG_BUFFER_SMALL_COUNT
+#define CONFIG_LOG_BUFFER_SMALL_COUNT 8  // Small buffers (0 = disabled)
+#endif
+
+#ifndef CONFIG_LOG_BUFFER_LARGE_SIZE
+#define CONFIG_LOG_BUFFER_LARGE_SIZE 1024  // Large buffer class (hex dumps, long lines)
+#endif
+
+#ifndef CONFIG_LOG_BUFFER_LARGE_COUNT
+#define CONFIG_LOG_BUFFER_LARGE_COUNT 2  // Large buffers (0 = disabled)
+#endif
+
+#ifndef CONFIG_LOG_BUFFER_LARGE_PSRAM
+#define CONFIG_LOG_BUFFER_LARGE_PSRAM 1  // Put large buffers in PSRAM when present
+#endif
+
+#ifndef CONFIG_LOG_BUFFER_SPIN_RETRIES
+#define CONFIG_LOG_BUFFER_SPIN_RETRIES 16  // Yield-and-retry attempts for BufferExhaustion::SPIN
+#endif
+
+#ifndef CONFIG_LOG_SUBSCRIBER_RING_SIZE
+#define CONFIG_LOG_SUBSCRIBER_RING_SIZE 4096  // Ring for async subscriber records (bytes, power of two)
+#endif
+
+#ifndef CONFIG_LOG_MAX_SUBSCRIBERS
+#define CONFIG_LOG_MAX_SUBSCRIBERS 8  // Registered subscriber callbacks (single + batch)
+#endif
+
+#ifndef CONFIG_LOG_SUBSCRIBER_FILTER_TAGS
+#define CONFIG_LOG_SUBSCRIBER_FILTER_TAGS 4  // Tags per subscriber filter
+#endif
+
+#ifndef CONFIG_LOG_SUBSCRIBER_BATCH_SIZE
+#define CONFIG_LOG_SUBSCRIBER_BATCH_SIZE 16  // Max messages per batch callback
 #endif
 
 #ifndef CONFIG_LOG_SUBSCRIBER_TASK_STACK
@@ -71,7 +113,49 @@
 #endif
 
 #ifndef CONFIG_LOG_SUBSCRIBER_MSG_SIZE
-#define CONFIG_LOG_SUBSCRIBER_MSG_SIZE 200  // Max message length in queued messages
+#define CONFIG_LOG_SUBSCRIBER_MSG_SIZE 200  // Max message length delivered to subscribers
+#endif
+
+#ifndef CONFIG_LOG_DEFERRED_RING_SIZE
+#define CONFIG_LOG_DEFERRED_RING_SIZE 4096  // Ring for deferred records (bytes, power of two)
+#endif
+
+#ifndef CONFIG_LOG_DEFERRED_RECORD_SIZE
+#define CONFIG_LOG_DEFERRED_RECORD_SIZE 160  // Max bytes per deferred record (header + args)
+#endif
+
+#ifndef CONFIG_LOG_DEFERRED_TASK_STACK
+#define CONFIG_LOG_DEFERRED_TASK_STACK 3072  // Stack size for deferred formatting task
+#endif
+
+#ifndef CONFIG_LOG_DEFERRED_TASK_PRIORITY
+#define CONFIG_LOG_DEFERRED_TASK_PRIORITY 1  // Priority for deferred formatting task
+#endif
+
+#ifndef CONFIG_LOG_DEDUP_SLOTS
+#define CONFIG_LOG_DEDUP_SLOTS 8  // Call sites tracked by the repeat coalescer
+#endif
+
+#ifndef CONFIG_LOG_EVENT_FIELDS_SIZE
+#define CONFIG_LOG_EVENT_FIELDS_SIZE 160  // Max encoded key/value bytes per Logger::event() (<= 255)
+#endif
+
+// CONFIG_LOG_STATIC_ALLOCATION=1 (LoggerConfig.h): the singleton carries
+// its mutexes, tag table, repeat slots, LARGE buffers and backend and
+// subscriber lists, the pool drops instead of falling back to the heap, and
+// lines logged before the first backend is installed are kept in the
+// early-boot buffer
+
+#ifndef CONFIG_LOG_DEFAULT_BACKEND
+#define CONFIG_LOG_DEFAULT_BACKEND (!CONFIG_LOG_STATIC_ALLOCATION)  // 0 = start without a backend
+#endif
+
+#ifndef CONFIG_LOG_EARLY_BUFFER_SIZE
+#define CONFIG_LOG_EARLY_BUFFER_SIZE (CONFIG_LOG_STATIC_ALLOCATION ? 2048 : 0)  // Lines kept until the first backend (bytes, power of two, 0 = off)
+#endif
+
+#ifndef CONFIG_LOG_MAX_BACKENDS
+#define CONFIG_LOG_MAX_BACKENDS 4  // Backend slots with CONFIG_LOG_STATIC_ALLOCATION (heap list otherwise)
 #endif
 
 #define MAX_LOGS_PER_SECOND 100
@@ -79,15 +163,55 @@
 /**
  * @brief Buffer pool for memory-efficient logging
  *
+ * Three size classes:
+ * - SMALL  (CONFIG_LOG_BUFFER_SMALL_SIZE) - most lines are short
+ * - MEDIUM (CONFIG_LOG_BUFFER_SIZE) - what acquire() without a size returns
+ * - LARGE  (CONFIG_LOG_BUFFER_LARGE_SIZE) - hex dumps and other long lines;
+ *   allocated once from PSRAM when CONFIG_LOG_BUFFER_LARGE_PSRAM is set and
+ *   PSRAM exists, otherwise internal RAM. Count 0 disables the class.
+ * acquire(minSize, capacity) picks the smallest class that fits and moves
+ * up when that class is empty.
+ *
+ * Lock-free: free slots are bits in one atomic word per core, taken with a
+ * CAS on the lowest set bit and returned with fetch_or. Slots are split
+ * between the cores, and acquire() looks in the calling core's word first
+ * so the two cores rarely contend for the same word. It steals from the
+ * other core's word only when its own is empty. release() finds the class
+ * and slot from the address.
+ *
+ * No mutex, so it works before the scheduler starts. acquire() and release()
+ * also work from an ISR, except for the heap fallback.
+ *
  * Uses Meyer's singleton pattern to avoid static initialization order issues.
  */
 class BufferPool {
 public:
     static constexpr size_t BUFFER_SIZE = CONFIG_LOG_BUFFER_SIZE;
+    static constexpr size_t POOL_SIZE = CONFIG_LOG_BUFFER_POOL_SIZE;
+    static constexpr size_t SMALL_BUFFER_SIZE = CONFIG_LOG_BUFFER_SMALL_SIZE;
+    static constexpr size_t LARGE_BUFFER_SIZE = CONFIG_LOG_BUFFER_LARGE_SIZE;
+    static constexpr size_t CORE_COUNT = LogPlatform::CORE_COUNT;
 
-    struct Buffer {
-        char data[BUFFER_SIZE];
-        std::atomic<bool> inUse{false};
+    using ExhaustionPolicy = LoggerConfig::BufferExhaustion;
+
+    enum class SizeClass : uint8_t { SMALL, MEDIUM, LARGE };
+    static constexpr size_t CLASS_COUNT = 3;
+
+    static_assert(POOL_SIZE > 0 && POOL_SIZE <= 32 * CORE_COUNT,
+                  "CONFIG_LOG_BUFFER_POOL_SIZE must be 1..32 per core");
+    static_assert(CONFIG_LOG_BUFFER_SMALL_COUNT <= 32 * CORE_COUNT && CONFIG_LOG_BUFFER_LARGE_COUNT <= 32 * CORE_COUNT,
+                  "Buffer class counts must be 0..32 per core");
+    static_assert(SMALL_BUFFER_SIZE < BUFFER_SIZE && BUFFER_SIZE < LARGE_BUFFER_SIZE,
+                  "Buffer classes must be SMALL < MEDIUM < LARGE");
+
+    struct ClassStats {
+        size_t bufferSize;
+        size_t count;          // Buffers in the class (0 = disabled)
+        size_t inUse;
+        size_t peakInUse;
+        uint32_t acquires;     // Successful acquires from this class
+        uint32_t exhausted;    // Times the class was empty when asked first
+        bool inPsram;
     };
 
     /**
@@ -104,21 +228,62 @@ public:
     BufferPool(const BufferPool&) = delete;
     BufferPool& operator=(const BufferPool&) = delete;
 
+    /**
+     * @brief Get a BUFFER_SIZE buffer
+     * @return Buffer, or nullptr if the pool is exhausted and the policy drops
+     */
     char* acquire();
+
+    /**
+     * @brief Get a buffer of at least `minSize` bytes (best effort)
+     * @param minSize Bytes wanted; larger than LARGE_BUFFER_SIZE gets a LARGE buffer
+     * @param capacity Set to the size of the returned buffer
+     * @return Buffer, or nullptr if the pool is exhausted and the policy drops
+     */
+    char* acquire(size_t minSize, size_t& capacity);
     void release(char* buffer);
 
+    void setExhaustionPolicy(ExhaustionPolicy policy) { policy_.store(policy, std::memory_order_relaxed); }
+    ExhaustionPolicy getExhaustionPolicy() const { return policy_.load(std::memory_order_relaxed); }
+
+    // Statistics
+    size_t getFreeCount(SizeClass sizeClass = SizeClass::MEDIUM) const;
+    ClassStats getClassStats(SizeClass sizeClass) const;
+    uint32_t getHeapFallbacks() const { return heapFallbacks_.load(std::memory_order_relaxed); }
+    uint32_t getDroppedAcquires() const { return droppedAcquires_.load(std::memory_order_relaxed); }
+    void resetStats();
+
 private:
+    struct Class {
+        char* storage;
+        size_t bufferSize;
+        size_t count;
+        bool inPsram;
+        std::atomic<uint32_t> freeMask[CORE_COUNT];
+        std::atomic<uint32_t> inUse;
+        std::atomic<uint32_t> peakInUse;
+        std::atomic<uint32_t> acquires;
+        std::atomic<uint32_t> exhausted;
+    };
+
     BufferPool();
-    ~BufferPool() {
-        // Clean up mutex if it was created
-        if (poolMutex) {
-            vSemaphoreDelete(poolMutex);
-            poolMutex = nullptr;
-        }
-    }
+    ~BufferPool() = default;  // Singleton - LARGE storage lives for the program
 
-    std::array<Buffer, CONFIG_LOG_BUFFER_POOL_SIZE> pool;
-    SemaphoreHandle_t poolMutex;
+    static void initClass(Class& cls, char* storage, size_t bufferSize, size_t count, bool inPsram);
+    static char* tryAcquire(Class& cls);
+    char* acquireFrom(size_t first, size_t& capacity);
+
+    // Slot i lives in freeMask[i % CORE_COUNT], bit i / CORE_COUNT
+    alignas(4) char smallStorage_[CONFIG_LOG_BUFFER_SMALL_COUNT ? CONFIG_LOG_BUFFER_SMALL_COUNT : 1][SMALL_BUFFER_SIZE];
+    alignas(4) char mediumStorage_[POOL_SIZE][BUFFER_SIZE];
+#if CONFIG_LOG_STATIC_ALLOCATION
+    alignas(4) char largeStorage_[CONFIG_LOG_BUFFER_LARGE_COUNT ? CONFIG_LOG_BUFFER_LARGE_COUNT : 1][LARGE_BUFFER_SIZE];
+#endif
+    Class classes_[CLASS_COUNT];
+    std::atomic<ExhaustionPolicy> policy_{CONFIG_LOG_STATIC_ALLOCATION ? ExhaustionPolicy::DROP
+                                                                      : ExhaustionPolicy::HEAP_FALLBACK};
+    std::atomic<uint32_t> heapFallbacks_{0};
+    std::atomic<uint32_t> droppedAcquires_{0};
 };
 
 /**
@@ -127,12 +292,19 @@ private:
  * Usage:
  *   BufferGuard guard;
  *   if (guard.get()) {
- *       snprintf(guard.get(), BufferPool::BUFFER_SIZE, "...");
+ *       snprintf(guard.get(), guard.size(), "...");
  *   }
+ *
+ *   BufferGuard dump(512);  // Smallest size class with at least 512 bytes
  */
 class BufferGuard {
 public:
-    BufferGuard() : buffer_(BufferPool::getInstance().acquire()) {}
+    BufferGuard() : buffer_(BufferPool::getInstance().acquire()), size_(BufferPool::BUFFER_SIZE) {}
+    explicit BufferGuard(size_t minSize) : buffer_(nullptr) {
+        // In the body: a member initializer would run size_'s default after acquire() set it
+        buffer_ = BufferPool::getInstance().acquire(minSize, size_);
+    }
+    explicit BufferGuard(std::nullptr_t) : buffer_(nullptr) {}  // Holds nothing
     ~BufferGuard() {
         if (buffer_) {
             BufferPool::getInstance().release(buffer_);
@@ -144,13 +316,14 @@ public:
     BufferGuard& operator=(const BufferGuard&) = delete;
 
     // Movable
-    BufferGuard(BufferGuard&& other) noexcept : buffer_(other.buffer_) {
+    BufferGuard(BufferGuard&& other) noexcept : buffer_(other.buffer_), size_(other.size_) {
         other.buffer_ = nullptr;
     }
     BufferGuard& operator=(BufferGuard&& other) noexcept {
         if (this != &other) {
             if (buffer_) BufferPool::getInstance().release(buffer_);
             buffer_ = other.buffer_;
+            size_ = other.size_;
             other.buffer_ = nullptr;
         }
         return *this;
@@ -158,22 +331,188 @@ public:
 
     char* get() noexcept { return buffer_; }
     const char* get() const noexcept { return buffer_; }
+    size_t size() const noexcept { return buffer_ ? size_ : 0; }
     explicit operator bool() const noexcept { return buffer_ != nullptr; }
 
+    // Give the buffer back early
+    void reset() noexcept {
+        if (buffer_) BufferPool::getInstance().release(buffer_);
+        buffer_ = nullptr;
+    }
+
 private:
     char* buffer_;
+    size_t size_ = 0;
 };
 
 /**
- * @brief Message structure for async subscriber notifications
+ * @brief Which messages a subscriber receives
  *
- * Fixed-size struct for queue-based callback invocation.
- * Callbacks execute on dedicated task, ensuring thread/core safety.
+ * Checked in notifySubscribers() before anything is queued, so filtered-out
+ * messages cost neither ring space nor time on the subscriber task.
+ * Default: every level, every tag.
+ *
+ *   LogSubscriberFilter f;
+ *   f.levelMask = LogSubscriberFilter::upTo(ESP_LOG_WARN);  // ERROR + WARN
+ *   f.addTag("MQTT");
+ */
+struct LogSubscriberFilter {
+    uint8_t levelMask = 0xFF;                              // Bit (1 << level) per accepted level
+    uint32_t tagIds[CONFIG_LOG_SUBSCRIBER_FILTER_TAGS] = {};  // Tag hashes; all 0 = any tag
+
+    // Mask for `level` and everything more severe
+    static constexpr uint8_t upTo(esp_log_level_t level) {
+        return static_cast<uint8_t>((1u << (level + 1)) - 2);
+    }
+
+    /**
+     * @brief Accept this tag (the first tag turns the tag filter on)
+     * @return false if CONFIG_LOG_SUBSCRIBER_FILTER_TAGS tags are already set
+     */
+    bool addTag(const char* tag);
+    bool addTag(LogTag tag);
+
+    bool accepts(esp_log_level_t level, uint32_t tagId) const;
+};
+
+/**
+ * @brief One message handed to a batch subscriber
+ * @note Pointers are only valid during the callback
  */
-struct LogSubscriberMessage {
+struct LogSubscriberEntryView {
     esp_log_level_t level;
-    char tag[CONFIG_LOG_SUBSCRIBER_TAG_SIZE];
-    char message[CONFIG_LOG_SUBSCRIBER_MSG_SIZE];
+    const char* tag;
+    const char* message;
+    const uint8_t* fields;  // Logger::event() fields (LogFields::Reader), nullptr for other lines
+    size_t fieldsLength;
+};
+
+/**
+ * @brief RAM the logger holds right now, by subsystem (Logger::getFootprint())
+ *
+ * Lazily allocated parts read 0 until first used: the tag table on the first
+ * setTagLevel() / setTagRateLimit() / registerTag() (or first subscriber
+ * record), the subscriber ring and task with the first subscriber, the
+ * deferred ring and task with startDeferredTask(), the repeat slots with the
+ * first setDedupWindow(), each writer mutex with its first writer after the
+ * scheduler started. Heap block headers are not included.
+ */
+struct LogFootprint {
+    size_t logger;          // The singleton object itself
+    size_t bufferPool;      // SMALL + MEDIUM storage (static) and pool state
+    size_t largeBuffers;    // LARGE class storage (heap, see largeInPsram)
+    bool largeInPsram;
+    size_t tagTable;
+    size_t repeatSlots;
+    size_t subscriberRing;  // Ring + subscriber list
+    size_t deferredRing;
+    size_t mutexes;
+    size_t taskStacks;      // Subscriber and deferred task stacks
+    size_t backendList;     // The list only - backends are owned by the caller
+
+    // Internal RAM (everything except PSRAM-resident LARGE buffers)
+    size_t internal() const {
+        return logger + bufferPool + (largeInPsram ? 0 : largeBuffers) + tagTable + repeatSlots +
+               subscriberRing + deferredRing + mutexes + taskStacks + backendList;
+    }
+};
+
+class Logger;
+
+/**
+ * @brief A structured event being built (Logger::event())
+ *
+ *   logger.event(ESP_LOG_INFO, "WIFI", "connected").kv("rssi", rssi).kv("ms", dt).emit();
+ *
+ * kv() appends a typed field (LogFields.h) to a pool buffer the event holds
+ * until emit() or destruction - no printf, no heap. Level, tag and rate
+ * checks run once, when the event is created; a filtered-out event holds no
+ * buffer and its kv() calls do nothing. A field that does not fit in
+ * CONFIG_LOG_EVENT_FIELDS_SIZE bytes is left out and sets truncated().
+ * Destroying an event without emit() discards it.
+ *
+ * Keys and string values are copied by kv(); the message is kept by pointer
+ * and must stay valid until emit(). Formatted on the calling task, also
+ * while the deferred task runs. Not for ISRs (the event is filtered out).
+ */
+class LogEvent {
+public:
+    LogEvent(LogEvent&&) = default;
+    LogEvent& operator=(LogEvent&&) = default;
+
+    // Integers: 4 bytes up to 32 bits, 8 above
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, LogEvent&>::type
+    kv(const char* key, T value) {
+        if (std::is_signed<T>::value) {
+            if (sizeof(T) <= 4) return put(key, LogFields::Type::INT32, static_cast<int32_t>(value));
+            return put(key, LogFields::Type::INT64, static_cast<int64_t>(value));
+        }
+        if (sizeof(T) <= 4) return put(key, LogFields::Type::UINT32, static_cast<uint32_t>(value));
+        return put(key, LogFields::Type::UINT64, static_cast<uint64_t>(value));
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value, LogEvent&>::type kv(const char* key, T value) {
+        return kv(key, static_cast<typename std::underlying_type<T>::type>(value));
+    }
+
+    LogEvent& kv(const char* key, bool value) {
+        return put(key, LogFields::Type::BOOL, static_cast<uint8_t>(value ? 1 : 0));
+    }
+    LogEvent& kv(const char* key, float value) { return put(key, LogFields::Type::FLOAT32, value); }
+    LogEvent& kv(const char* key, double value) { return put(key, LogFields::Type::FLOAT64, value); }
+
+    LogEvent& kv(const char* key, const char* value) {
+        if (buffer_) fields_.putString(key, value, value ? strlen(value) : 0);
+        return *this;
+    }
+
+    // std::string, Arduino String, ...
+    template <typename S>
+    auto kv(const char* key, const S& value) -> decltype(value.c_str(), value.length(), std::declval<LogEvent&>()) {
+        if (buffer_) fields_.putString(key, value.c_str(), value.length());
+        return *this;
+    }
+
+    /**
+     * @brief Hand the event to the backends and subscribers, release the buffer
+     * @return false if it was filtered out or no backend took it
+     */
+    bool emit();
+
+    bool enabled() const { return static_cast<bool>(buffer_); }
+    bool truncated() const { return fields_.truncated(); }
+
+    // Encoded fields so far
+    const uint8_t* fields() const { return fields_.data(); }
+    size_t fieldsLength() const { return fields_.length(); }
+
+private:
+    friend class Logger;
+
+    // logger nullptr = filtered out, hold no buffer
+    LogEvent(Logger* logger, esp_log_level_t level, const char* tag, uint32_t tagId, const char* message)
+        : logger_(logger), level_(level), tag_(tag), tagId_(tagId), message_(message),
+          buffer_(logger ? BufferGuard(CONFIG_LOG_EVENT_FIELDS_SIZE) : BufferGuard(nullptr)),
+          fields_(reinterpret_cast<uint8_t*>(buffer_.get()),
+                  std::min<size_t>(buffer_.size(), CONFIG_LOG_EVENT_FIELDS_SIZE)) {}
+
+    template <typename V>
+    LogEvent& put(const char* key, LogFields::Type type, V value) {
+        if (buffer_) fields_.put(key, type, &value);
+        return *this;
+    }
+
+    static_assert(CONFIG_LOG_EVENT_FIELDS_SIZE <= 255, "CONFIG_LOG_EVENT_FIELDS_SIZE must fit a length byte");
+
+    Logger* logger_;
+    esp_log_level_t level_;
+    const char* tag_;
+    uint32_t tagId_;
+    const char* message_;
+    BufferGuard buffer_;
+    LogFields::Writer fields_;
 };
 
 // Professional Logger with tag-level filtering
@@ -187,9 +526,27 @@ public:
 
     // Configuration (thread-safe)
     void init(size_t bufferSize = CONFIG_LOG_BUFFER_SIZE);
+    /**
+     * @brief Apply a complete configuration
+     * @note Safe to call again at runtime (e.g. a config pushed over MQTT):
+     *       the global level, enable flag and tag levels are published as one
+     *       filter, so concurrent log calls see either the old settings or
+     *       the new ones, never a mix. The backend is replaced in one step
+     *       before that. Tags configured earlier and not listed keep their
+     *       levels.
+     */
     void configure(const LoggerConfig& config);
     void enableLogging(bool enable);
-    bool getIsLoggingEnabled() const { return isLoggingEnabled.load(); }
+    bool getIsLoggingEnabled() const { return loggingEnabled(); }
+
+    /**
+     * @brief Choose the envelope fields printed before every line
+     * @note Time comes from esp_timer_get_time() in both units. Task names and
+     *       IDs are cached per task in thread-local storage, and the envelope
+     *       is written without snprintf.
+     */
+    void setEnvelope(const LoggerConfig::Envelope& envelope);
+    LoggerConfig::Envelope getEnvelope() const;
 
     /**
      * @brief Check if the logger has been explicitly initialized
@@ -198,15 +555,138 @@ public:
      */
     bool isInitialized() const noexcept { return initialized_.load(); }
     void setLogLevel(esp_log_level_t level);
-    esp_log_level_t getLogLevel() const { return globalLogLevel.load(); }
+    esp_log_level_t getLogLevel() const {
+        FilterGuard filter(filter_);
+        return filter->globalLevel();
+    }
     void setMaxLogsPerSecond(uint32_t maxLogs);
+
+    /**
+     * @brief Give a level its own rate budget, separate from the global one
+     *
+     * A level with a budget is checked against that budget instead of the
+     * global setMaxLogsPerSecond() bucket, so floods at other levels cannot
+     * starve it (e.g. keep ERROR flowing while a tag spams INFO).
+     *
+     * @param perSecond Sustained messages per second (0 = back to the global budget)
+     * @param burst Messages allowed back-to-back (0 = one second's worth)
+     */
+    void setLevelRateLimit(esp_log_level_t level, uint32_t perSecond, uint32_t burst = 0);
+
+    /**
+     * @brief Cap a single tag, in addition to its level / global budget
+     *
+     * A chatty tag exhausts its own budget and is dropped before it can use
+     * up the budget shared with other tags.
+     *
+     * @param perSecond Sustained messages per second (0 = no tag cap)
+     * @param burst Messages allowed back-to-back (0 = one second's worth)
+     * @return false if the tag table is full
+     */
+    bool setTagRateLimit(const char* tag, uint32_t perSecond, uint32_t burst = 0);
+
+    /**
+     * @brief Keep a sample of a tag's verbose messages instead of all or none
+     *
+     *   logger.setTagLevel("Sensor", ESP_LOG_DEBUG);
+     *   logger.setTagSampling("Sensor", ESP_LOG_DEBUG, 1, 100);  // 1 in 100 DEBUG/VERBOSE
+     *
+     * Messages at `level` or more verbose are sampled; more severe ones
+     * always pass. Checked with one atomic counter per message, after the
+     * level filter and before the tag / level rate limits, formatting or
+     * any buffer.
+     * Sampled-out messages are counted in getSampledLogs(), not as drops.
+     * The tag's level still decides what reaches the sampler.
+     *
+     * @param keep Messages kept of every `outOf`
+     * @param outOf 0 turns the ratio off
+     * @return false if the tag table is full or a pattern was given (exact tags only)
+     */
+    bool setTagSampling(const char* tag, esp_log_level_t level, uint32_t keep, uint32_t outOf);
+
+    /**
+     * @brief Let at most `perSecond` of a tag's messages at `level` and below through
+     * @param perSecond 0 turns the budget off
+     * @param burst Back-to-back messages (0 = one second's worth)
+     * @note Combines with setTagSampling(): the budget caps what the ratio kept.
+     *       The level given last applies to both.
+     */
+    bool setTagSamplingBudget(const char* tag, esp_log_level_t level, uint32_t perSecond, uint32_t burst = 0);
+
+    /**
+     * @brief Coalesce repeats of the same message into one summary line
+     *
+     * A message is identified by level, tag and format pointer (its call
+     * site; arguments are not compared). The first one is logged; repeats
+     * within windowMs of it only increment a counter, before the rate limit,
+     * so they use no budget. When the window ends a line "last message
+     * repeated N times over T ms" is written under the same tag and level.
+     * The window end is noticed on the next coalesced call or flush().
+     *
+     * @param windowMs Run length (0 = off, the default)
+     * @note CONFIG_LOG_DEDUP_SLOTS call sites are tracked, least recently
+     *       used evicted first. Only flash-resident formats are coalesced,
+     *       never from an ISR.
+     */
+    void setDedupWindow(uint32_t windowMs);
+    uint32_t getDedupWindow() const { return dedupWindowMs_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Lower the effective level while the log pipeline is overloaded
+     *
+     * Once per window the logger samples getDroppedLogs(), subscriber and
+     * deferred ring drops and fill, and every backend's getDroppedMessages()
+     * and queue fill. After `pressureWindows` pressured windows in a row the
+     * most verbose level still passing is masked (DEBUG, then INFO, ... down
+     * to minLevel); after `calmWindows` calm ones everything is restored and
+     * one WARN line reports how many messages were suppressed.
+     *
+     * @note Masked messages are counted in getThrottledLogs(), not in
+     *       getDroppedLogs(). Sampling runs on a logging task, never in an ISR.
+     */
+    void setThrottle(const LoggerConfig::Throttle& throttle);
+    LoggerConfig::Throttle getThrottle() const;
+
+    /**
+     * @brief Most verbose level the throttle currently lets through
+     * @return ESP_LOG_VERBOSE while not throttling
+     */
+    esp_log_level_t getThrottleLevel() const { return throttleLevel_.load(std::memory_order_relaxed); }
+
     void setBackend(std::shared_ptr<ILogBackend> newBackend);
     
-    // Multiple backend support
+    // Multiple backend support. With CONFIG_LOG_STATIC_ALLOCATION the list
+    // has CONFIG_LOG_MAX_BACKENDS slots; backends beyond that are not added
+    // (a warning is logged to the installed ones)
     void addBackend(std::shared_ptr<ILogBackend> backend);
     void removeBackend(std::shared_ptr<ILogBackend> backend);
     void clearBackends();
 
+    /**
+     * @brief Add a backend behind its own queue and drain task
+     *
+     * The backend is wrapped in an AsyncRingBackend, so a stalled sink (e.g.
+     * a TCP connection) only overflows its own queue; callers and the other
+     * backends are not delayed. Binary backends lose the unformatted path
+     * when wrapped (they receive text).
+     *
+     * @param backend Backend to isolate
+     * @param coreId -1 = no affinity, 0 or 1 = pin the drain task (like startSubscriberTask)
+     * @param priority Drain task priority
+     * @return The wrapper (pass it to removeBackend()), nullptr if the task did not start
+     */
+    std::shared_ptr<AsyncRingBackend> addIsolatedBackend(std::shared_ptr<ILogBackend> backend,
+                                                         int coreId = -1,
+                                                         uint32_t priority = CONFIG_LOG_ASYNC_TASK_PRIORITY);
+    std::shared_ptr<AsyncRingBackend> addIsolatedBackend(std::shared_ptr<ILogBackend> backend,
+                                                         const AsyncRingBackend::Config& config);
+
+    /**
+     * @brief Queue statistics of every queueing backend, in backend order
+     * @return Number of entries written to `stats` (at most maxCount)
+     */
+    size_t getBackendQueueStats(BackendQueueStats* stats, size_t maxCount) const;
+
     // Log subscriber callbacks (lightweight forwarding to external systems)
     typedef void (*LogSubscriberCallback)(
         esp_log_level_t level,
@@ -214,13 +694,35 @@ public:
         const char* message
     );
 
+    // Batch variant: up to CONFIG_LOG_SUBSCRIBER_BATCH_SIZE messages per call
+    typedef void (*LogBatchCallback)(
+        const LogSubscriberEntryView* messages,
+        size_t count
+    );
+
     /**
-     * @brief Register a callback to receive all log messages
+     * @brief Register a callback to receive log messages
      * @param callback Function to call for each log message
+     * @param filter Levels and tags to deliver (default: all)
      * @return true if registered successfully, false if max subscribers reached
      * @note Callbacks execute on dedicated task - safe for network operations
      */
-    bool addLogSubscriber(LogSubscriberCallback callback);
+    bool addLogSubscriber(LogSubscriberCallback callback,
+                          const LogSubscriberFilter& filter = LogSubscriberFilter());
+
+    /**
+     * @brief Register a callback that receives queued messages in batches
+     *
+     * Each wake-up of the subscriber task delivers what is queued in one
+     * call (split at CONFIG_LOG_SUBSCRIBER_BATCH_SIZE), so a network
+     * subscriber can send one payload per batch.
+     *
+     * @param callback Function to call with each batch
+     * @param filter Levels and tags to deliver (default: all)
+     * @return true if registered successfully, false if max subscribers reached
+     */
+    bool addLogBatchSubscriber(LogBatchCallback callback,
+                               const LogSubscriberFilter& filter = LogSubscriberFilter());
 
     /**
      * @brief Unregister a previously registered callback
@@ -228,6 +730,7 @@ public:
      * @return true if found and removed, false otherwise
      */
     bool removeLogSubscriber(LogSubscriberCallback callback);
+    bool removeLogSubscriber(LogBatchCallback callback);
 
     /**
      * @brief Get number of active subscribers
@@ -236,8 +739,19 @@ public:
      */
     uint8_t getSubscriberCount() const noexcept { return subscriberCount.load(); }
 
+    /**
+     * @brief Messages not queued for subscribers because the ring was full
+     */
+    uint32_t getSubscriberDrops() const noexcept { return subscriberDrops_.load(); }
+    void resetSubscriberDrops() { subscriberDrops_.store(0); }
+
     /**
      * @brief Start the subscriber notification task
+     *
+     * Messages are queued as variable-length records in a lock-free ring
+     * (CONFIG_LOG_SUBSCRIBER_RING_SIZE bytes) and delivered on this task;
+     * the callback list is read without locking.
+     *
      * @param coreId Core to pin task to (-1 for no affinity, 0 or 1 for specific core)
      * @return true if task started successfully
      * @note Call this after registering subscribers that need core affinity (e.g., network)
@@ -255,8 +769,34 @@ public:
      */
     bool isSubscriberTaskRunning() const { return subscriberTaskHandle != nullptr; }
 
+    /**
+     * @brief Start deferred formatting (log(), logV() and ESP-IDF redirect)
+     * @param coreId Core to pin task to (-1 for no affinity, 0 or 1 for specific core)
+     * @return true if task started successfully
+     * @note While running, the calling task only stores the format pointer,
+     *       timestamp, task name and a packed copy of the arguments in a
+     *       lock-free ring; vsnprintf and the envelope run on the "LogFmt" task.
+     *       Formats that are not in flash are formatted immediately as before.
+     */
+    bool startDeferredTask(int coreId = -1);
+
+    /**
+     * @brief Stop deferred formatting after rendering queued records
+     */
+    void stopDeferredTask();
+
+    /**
+     * @brief Check if deferred formatting is active
+     */
+    bool isDeferredTaskRunning() const { return deferredTaskHandle != nullptr; }
+
+    // Deferred ring statistics
+    uint32_t getDeferredOverflows() const noexcept { return deferredRing_.getOverflowCount(); }
+    size_t getDeferredHighWaterMark() const noexcept { return deferredRing_.getHighWaterMark(); }
+
     // Core logging methods
     void log(esp_log_level_t level, const char* tag, const char* format, ...) override;
+    void log(esp_log_level_t level, const LogTag& tag, const char* format, ...);
     void logNnL(esp_log_level_t level, const char* tag, const char* format, ...) override;
     void logV(esp_log_level_t level, const char* tag, const char* format, va_list args) override;
     void logInL(const char* format, ...) override;
@@ -264,17 +804,165 @@ public:
     // Direct mode for bypassing rate limiting
     void logDirect(esp_log_level_t level, const char* tag, const char* message);
 
+    /**
+     * @brief Log a binary payload as one hex line: "label (N bytes): 01 03 ..."
+     * @param label Optional prefix, may be nullptr
+     * @note One message for the level, tag and rate checks however long the
+     *       payload is. Bytes that do not fit the largest pool buffer are cut
+     *       off and marked with "...". Binary backends get the raw bytes
+     *       (ILogBackend::writeBytes()). Formatted on the calling task.
+     */
+    void logHex(esp_log_level_t level, const char* tag, const void* data, size_t length,
+                const char* label = nullptr);
+
+    /**
+     * @brief Start a structured key/value event (see LogEvent)
+     * @param message Optional text in front of the fields, kept by pointer
+     *
+     *   logger.event(ESP_LOG_INFO, "WIFI").kv("rssi", -71).kv("ms", dt).emit();
+     *
+     * Backends get the typed fields through ILogBackend::writeFields();
+     * those that decline, and subscribers, get the text line
+     * "message key=value ..." (logfmt). Subscribers also see the encoded
+     * fields in LogSubscriberEntryView::fields.
+     */
+    LogEvent event(esp_log_level_t level, const char* tag, const char* message = nullptr);
+    LogEvent event(esp_log_level_t level, const LogTag& tag, const char* message = nullptr);
+
+    /**
+     * @brief Log from an interrupt handler (see LOG_ISR in LogInterface.h)
+     * @return true if the record is in the deferred ring; false if it was
+     *         filtered, rate limited or dropped (no deferred task, RAM format
+     *         or ring full - all counted in getDroppedLogs())
+     * @note Only enqueues: the record goes into the deferred ring and is
+     *       rendered and written by the "LogFmt" task, so startDeferredTask()
+     *       must be running. Level, tag and rate checks are lock-free; nothing
+     *       here takes a mutex, allocates or touches a backend. The format must
+     *       be a string literal, and %s arguments in RAM are copied into the
+     *       record. Without the deferred task, or with a RAM format, the call
+     *       is dropped and counted in getDroppedLogs(). Not usable from IRAM-only
+     *       handlers that run while the flash cache is disabled.
+     */
+    bool logFromISR(esp_log_level_t level, const char* tag, const char* format, ...);
+    bool logFromISRV(esp_log_level_t level, const char* tag, const char* format, va_list args);
+
+    /**
+     * @brief Type-safe logging with "{}" placeholders (see LogFormat.h)
+     *
+     *   logger.info("MQTT", "connected in {} ms", dt);
+     *   logger.warn(TAG, "rssi {} dBm, heap {:x}", rssi, ESP.getFreeHeap());
+     *
+     * Each argument is written into the pool buffer by an overload chosen at
+     * compile time; there is no printf parsing and nothing is boxed into a
+     * va_list. Types without a writer do not compile. Level, tag and rate
+     * checks are the same as log(). Always formatted on the calling task,
+     * also while the deferred task runs; binary backends get a TEXT frame.
+     */
+    template <typename Tag, typename... Args>
+    void print(esp_log_level_t level, const Tag& tag, const char* format, const Args&... args) {
+        if (isLevelEnabledForTag(tag, level)) logMessage(level, tag, LogFormat::bind(format, args...));
+    }
+
+    template <typename Tag, typename... Args>
+    void error(const Tag& tag, const char* format, const Args&... args) { print(ESP_LOG_ERROR, tag, format, args...); }
+    template <typename Tag, typename... Args>
+    void warn(const Tag& tag, const char* format, const Args&... args) { print(ESP_LOG_WARN, tag, format, args...); }
+    template <typename Tag, typename... Args>
+    void info(const Tag& tag, const char* format, const Args&... args) { print(ESP_LOG_INFO, tag, format, args...); }
+    template <typename Tag, typename... Args>
+    void debug(const Tag& tag, const char* format, const Args&... args) { print(ESP_LOG_DEBUG, tag, format, args...); }
+    template <typename Tag, typename... Args>
+    void verbose(const Tag& tag, const char* format, const Args&... args) { print(ESP_LOG_VERBOSE, tag, format, args...); }
+
+    /**
+     * @brief Log a bound "{}" message (print() and LOGF_* land here)
+     * @note Does not check the level - callers have already done so
+     */
+    void logMessage(esp_log_level_t level, const char* tag, const LogFormat::Message& message) {
+        logMessageImpl(level, tag, 0, message);
+    }
+    void logMessage(esp_log_level_t level, const LogTag& tag, const LogFormat::Message& message) {
+        logMessageImpl(level, tag.name, tag.id, message);
+    }
+
     // Metrics
     uint32_t getDroppedLogs() const noexcept { return droppedLogs.load(); }
     uint32_t getMutexTimeouts() const noexcept { return mutexTimeouts_.load(); }
+    uint32_t getLostWrites() const noexcept { return lostWrites_.load(); }  // Formatted lines no backend took
+    uint32_t getThrottledLogs() const noexcept { return throttledLogs_.load(); }  // Masked by setThrottle()
+    uint32_t getCoalescedLogs() const noexcept { return coalescedLogs_.load(); }  // Repeats folded by setDedupWindow()
+    uint32_t getSampledLogs() const noexcept { return sampledLogs_.load(); }  // Left out by setTagSampling()
     void resetDroppedLogs();
     void resetMutexTimeouts() { mutexTimeouts_.store(0); }
+    void resetLostWrites() { lostWrites_.store(0); }
+    void resetThrottledLogs() { throttledLogs_.store(0); }
+    void resetSampledLogs() { sampledLogs_.store(0); }
+
+    /**
+     * @brief Per-stage cycle histograms and per-tag line/byte counters
+     * @return false (stats untouched) unless built with CONFIG_LOG_INSTRUMENTATION=1
+     * @note Stages are timed with the CPU cycle counter on the synchronous
+     *       path; lines rendered by the deferred task count their envelope,
+     *       format and output stages there. Tags are counted once they are
+     *       in the tag registry (interned on their first line).
+     */
+    bool getStats(LogStats& stats) const;
+    void resetStats();
+
+    /**
+     * @brief Bytes of RAM the logger currently holds, per subsystem
+     * @note LoggerConfig::estimatedMemoryUsage() is the compile-time floor
+     */
+    LogFootprint getFootprint() const;
+    void resetCoalescedLogs() { coalescedLogs_.store(0); }
 
     // Professional tag-level filtering
+
+    /**
+     * @brief Set the level of a tag, or of every tag matching "Prefix*"
+     *
+     * A pattern ends in '*' ("Modbus.*", "Net.", "*"); the longest matching
+     * pattern applies to a tag that has no level of its own. Patterns are
+     * resolved once per tag (tags are interned on first use while patterns
+     * exist), so log calls never pattern-match.
+     *
+     * @note CONFIG_LOG_MAX_TAG_PATTERNS patterns. Patterns apply to this
+     *       logger only - ESP-IDF's own filter (esp_log_level_set) is exact.
+     * @note Level setters publish a new filter (see LogFilter.h) and wait
+     *       until no log call uses the old one - not for ISRs. Use
+     *       configure() to change several levels at once.
+     */
     void setTagLevel(const char* tag, esp_log_level_t level);
     esp_log_level_t getTagLevel(const char* tag) const;
     bool isLevelEnabledForTag(const char* tag, esp_log_level_t level) const;
 
+    /**
+     * @brief Most verbose level that would currently be logged for a tag
+     * @return ESP_LOG_NONE if logging is disabled, otherwise the tag or global level
+     * @note Used by the LOG_WRITE call site cache (see LogInterface.h)
+     */
+    esp_log_level_t getEffectiveLevel(const char* tag) const;
+
+    // Compile-time tag IDs (see LogTag.h) - filtering keys on the ID, no string compare
+    void setTagLevel(const LogTag& tag, esp_log_level_t level) { setTagLevel(tag.name, level); }
+    bool isLevelEnabledForTag(const LogTag& tag, esp_log_level_t level) const;
+
+    /**
+     * @brief Register a tag name in the tag registry
+     * @return Tag ID (same value LOG_TAG_ID() computes), or 0 if the registry is full
+     * @note Tags are registered automatically when they reach a subscriber
+     */
+    uint32_t registerTag(const char* tag);
+
+    /**
+     * @brief Resolve a tag ID back to its name
+     * @return Registered name, or nullptr if unknown
+     */
+    const char* getTagName(uint32_t tagId) const {
+        const TagLevelTable* table = tagTable();
+        return table ? table->nameOf(tagId) : nullptr;
+    }
+
     // Convert log level to string
     static const char* levelToString(esp_log_level_t level) {
         switch (level) {
@@ -291,55 +979,300 @@ public:
     // Flush all backends
     void flush() override;
     
-    // Enable ESP-IDF log redirection through this logger
+    /**
+     * @brief Enable ESP-IDF log redirection through this logger
+     * @note Lines are matched against IDF's "L (time) tag: " prefix without
+     *       formatting: the level comes from the prefix letter and tag filters
+     *       and rate limits apply before anything is printed. Accepted lines
+     *       are formatted once and keep IDF's own envelope; in deferred mode
+     *       only the message is captured and LogFmt adds ours instead. Text
+     *       without that prefix is logged as INFO under the tag "ESP".
+     */
     void enableESPLogRedirection();
 
 private:
-    bool checkRateLimit();
-    void writeToBackends(const char* message, size_t length);
-    void notifySubscribers(esp_log_level_t level, const char* tag, const char* message);
+    struct IdfLine;
+    static int espLogRedirect(const char* format, va_list args);
+    static bool parseIdfLine(const char* format, va_list& ap, IdfLine& line);
+    void logIdfLine(const IdfLine& line, const char* format, va_list args, va_list bodyArgs);
+
+    bool checkRateLimit(esp_log_level_t level, const char* tag, uint32_t tagId);
+    template <typename Configure>
+    bool configureSampler(const char* tag, Configure configure);
+    esp_log_level_t levelFor(const LogFilter& filter, const char* tag, uint32_t tagId) const;
+    bool loggingEnabled() const {
+        FilterGuard filter(filter_);
+        return filter->enabled();
+    }
+
+    // Cycle stamps for LogStats; compiled out without CONFIG_LOG_INSTRUMENTATION
+    static uint32_t stageStart() {
+#if CONFIG_LOG_INSTRUMENTATION
+        return LOG_STATS_CYCLES();
+#else
+        return 0;
+#endif
+    }
+    void stageEnd(LogStage stage, uint32_t start) {
+#if CONFIG_LOG_INSTRUMENTATION
+        stageStats_.record(stage, LOG_STATS_CYCLES() - start);
+#else
+        (void)stage;
+        (void)start;
+#endif
+    }
+    void updateThrottle(uint32_t nowUs);
+    void samplePressure(uint32_t& drops, uint8_t& fillPercent) const;
+    // One tracked call site of the repeat coalescer
+    struct RepeatSlot {
+        const char* format = nullptr;  // nullptr = free
+        char tag[CONFIG_LOG_SUBSCRIBER_TAG_SIZE];
+        esp_log_level_t level;
+        uint32_t startMs;              // First occurrence, logged in full
+        uint32_t lastMs;
+        uint32_t count;                // Repeats since then, not written
+    };
+    bool coalesceRepeat(esp_log_level_t level, const char* tag, const char* format);
+    void reportRepeats(const RepeatSlot& slot);
+    void flushRepeats();
+    void logNotice(esp_log_level_t level, const char* tag, const char* format, ...)
+        __attribute__((format(printf, 4, 5)));
+    static void bumpConfigGeneration();
+    void logImpl(esp_log_level_t level, const char* tag, uint32_t tagId, const char* format, va_list args);
+    void logMessageImpl(esp_log_level_t level, const char* tag, uint32_t tagId, const LogFormat::Message& message);
+    template <typename Render>
+    char* formatLineWith(esp_log_level_t level, const char* tag, const char* format, Render render,
+                         size_t& bodyOffset, size_t& bodyLength);
+    char* formatLine(esp_log_level_t level, const char* tag, const char* format, va_list args,
+                     size_t& bodyOffset, size_t& bodyLength);
+    // Envelope inputs, captured once per line
+    struct LineStamp {
+        uint64_t timeUs;
+        uint32_t deltaUs;
+        const char* task;   // Not necessarily NUL-terminated
+        uint8_t taskLength;
+        uint16_t taskId;    // 0 = no ID (ISR, before the scheduler)
+    };
+    LineStamp stampLine();
+    void stampDelta(LineStamp& stamp);
+    size_t formatEnvelope(char* buffer, size_t capacity, esp_log_level_t level, const char* tag,
+                          const LineStamp& stamp) const;
+    void outputMessage(esp_log_level_t level, const char* tag, uint32_t tagId, char* buffer,
+                       size_t bodyOffset, size_t bodyLength, const char* lineEnd, bool skipUnformatted = false);
+    bool logDeferred(esp_log_level_t level, const char* tag, uint32_t tagId, const char* format, va_list args,
+                     bool unformattedDone, bool trimLineEnd = false);
+    bool enqueueDeferred(esp_log_level_t level, const char* tag, uint32_t tagId, const char* format, va_list args,
+                         bool unformattedDone, bool trimLineEnd);
+    void renderDeferred(const uint8_t* record, size_t length);
+    friend class LogEvent;
+    bool emitEvent(esp_log_level_t level, const char* tag, uint32_t tagId, const char* message,
+                   const uint8_t* fields, size_t fieldsLength);
+    void writeToBackends(const char* message, size_t length, bool skipUnformatted = false);
+    void writeUnformattedToBackends(esp_log_level_t level, const char* tag, const char* format, va_list args);
+    bool writeBytesToBackends(esp_log_level_t level, const char* tag, const char* label,
+                              const uint8_t* data, size_t length);
+#if CONFIG_LOG_STATIC_ALLOCATION
+    // The subset of std::vector the backend edits use, in fixed slots
+    class BackendItems {
+    public:
+        using Item = std::shared_ptr<ILogBackend>;
+
+        void push_back(Item item) {
+            if (count_ < CONFIG_LOG_MAX_BACKENDS) {
+                items_[count_++] = std::move(item);
+            } else {
+                rejected_ = true;
+            }
+        }
+        Item* erase(Item* first, Item* last) {
+            Item* out = std::move(last, end(), first);
+            while (end() != out) items_[--count_].reset();
+            return first;
+        }
+        void clear() { erase(begin(), end()); }
+
+        bool empty() const { return count_ == 0; }
+        size_t size() const { return count_; }
+        Item& operator[](size_t i) { return items_[i]; }
+        const Item& operator[](size_t i) const { return items_[i]; }
+        Item* begin() { return items_; }
+        Item* end() { return items_ + count_; }
+        const Item* begin() const { return items_; }
+        const Item* end() const { return items_ + count_; }
+
+        // A push_back() found every slot taken; cleared by takeRejected()
+        bool takeRejected() {
+            bool rejected = rejected_;
+            rejected_ = false;
+            return rejected;
+        }
+
+    private:
+        Item items_[CONFIG_LOG_MAX_BACKENDS];
+        size_t count_ = 0;
+        bool rejected_ = false;
+    };
+#else
+    using BackendItems = std::vector<std::shared_ptr<ILogBackend>>;
+#endif
+    struct BackendList {
+        BackendItems items;
+    };
+    using BackendGuard = RcuPointer<BackendList>::ReadGuard;
+    using FilterGuard = RcuPointer<LogFilter>::ReadGuard;
+
+    template <typename Edit>
+    bool updateFilter(Edit edit);
+
+    template <typename Edit>
+    void updateBackends(Edit edit);
+    void updateBackendCounts(const BackendList& list);
+    BackendList* idleBackendList(const BackendList* current);
+    void publishBackends(BackendList* next);
+    void notifySubscribers(esp_log_level_t level, const char* tag, uint32_t tagId, const char* message,
+                           const uint8_t* fields = nullptr, size_t fieldsLength = 0);
+
+    static constexpr uint8_t MAX_SUBSCRIBERS = CONFIG_LOG_MAX_SUBSCRIBERS;
+    struct SubscriberEntry {
+        LogSubscriberCallback callback = nullptr;  // Exactly one of the two is set
+        LogBatchCallback batchCallback = nullptr;
+        LogSubscriberFilter filter;
+    };
+    struct SubscriberList {
+        SubscriberEntry items[MAX_SUBSCRIBERS];
+        uint8_t count = 0;
+    };
+    using SubscriberGuard = RcuPointer<SubscriberList>::ReadGuard;
+
+    template <typename Edit>
+    bool updateSubscribers(Edit edit);
+    bool addSubscriberEntry(const SubscriberEntry& entry);
+    bool removeSubscriberEntry(LogSubscriberCallback callback, LogBatchCallback batchCallback);
+    uint8_t snapshotSubscribers(SubscriberEntry* out) const;
+    bool anySubscriberAccepts(esp_log_level_t level, uint32_t tagId) const;
+    bool decodeSubscriberRecord(const uint8_t* record, size_t length, LogSubscriberEntryView& view,
+                                uint32_t& tagId) const;
+    void dispatchSubscriberBatch(const uint8_t* const* records, const size_t* lengths, size_t count,
+                                 const SubscriberEntry* subscribers, uint8_t entryCount);
+    uint32_t internTag(const char* tag, uint32_t tagId);
+    TagLevelTable* tagTable() const { return tagLevels_.load(std::memory_order_acquire); }
+    TagLevelTable* ensureTagTable();
+    void initStaticStorage();
+    void replayEarlyLines(const BackendList& list);
 
     // Core state with atomic operations for thread safety
     std::atomic<bool> initialized_{false};
-    std::atomic<esp_log_level_t> globalLogLevel{ESP_LOG_INFO};
-    std::atomic<bool> isLoggingEnabled{true};
+
+    // Level filter: one published, the other idle until the next change
+    // (updateFilter()). No heap, and no reader ever sees a filter being edited
+    LogFilter filters_[2];
+    RcuPointer<LogFilter> filter_{&filters_[0]};
 
     // Multiple backend support
-    std::vector<std::shared_ptr<ILogBackend>> backends;
-    mutable SemaphoreHandle_t backendMutex;
+    RcuPointer<BackendList> backends_;       // Immutable snapshot, replaced on change
+    mutable std::atomic<LogPlatform::MutexHandle> backendMutex{nullptr};  // Serializes backend list writers only
+    std::atomic<uint32_t> lostWrites_{0};
+    std::atomic<uint8_t> unformattedBackends_{0};  // acceptsUnformatted() backends
+    std::atomic<uint8_t> textBackends_{0};         // Backends that need formatted text
 
-    // Log subscribers (async queue-based callbacks)
-    static constexpr uint8_t MAX_SUBSCRIBERS = 4;
-    LogSubscriberCallback subscribers[MAX_SUBSCRIBERS] = {nullptr};
+    // Log subscribers (records in a lock-free ring, delivered on LogSub)
+    RcuPointer<SubscriberList> subscribers_;     // Immutable snapshot, replaced on change
     std::atomic<uint8_t> subscriberCount{0};
-    mutable SemaphoreHandle_t subscriberMutex;
-    QueueHandle_t subscriberQueue = nullptr;
-    TaskHandle_t subscriberTaskHandle = nullptr;
+    mutable std::atomic<LogPlatform::MutexHandle> subscriberMutex{nullptr};  // Serializes add/remove only
+    LogRingBuffer subscriberRing_;
+    std::atomic<LogPlatform::TaskHandle> subscriberTaskHandle{nullptr};  // Cleared by the task as it exits
     std::atomic<bool> subscriberTaskRunning{false};
+    std::atomic<bool> subscriberTaskWaiting{false};
+    std::atomic<uint32_t> subscriberDrops_{0};
 
     // Static task function for subscriber notifications
     static void subscriberTaskFunc(void* param);
 
-    // Tag-level filtering - uses fixed array for O(n) lookup without heap allocation
-    // Better than unordered_map for small N due to cache locality and no allocation per lookup
-    struct TagLevel {
-        char tag[CONFIG_LOG_SUBSCRIBER_TAG_SIZE];  // Owned copy of tag string
-        esp_log_level_t level;
-    };
-    TagLevel tagLevels_[CONFIG_LOG_MAX_TAGS];
-    std::atomic<size_t> tagLevelCount_{0};
-    mutable SemaphoreHandle_t tagMutex;
+    // Deferred formatting (records rendered on a background task)
+    LogRingBuffer deferredRing_;
+    std::atomic<LogPlatform::TaskHandle> deferredTaskHandle{nullptr};  // Cleared by the task as it exits
+    std::atomic<bool> deferredTaskRunning{false};
+    std::atomic<bool> deferredTaskWaiting{false};
+
+    static void deferredTaskFunc(void* param);
+
+    // Tag registry - hashed table with lock-free lookups, allocated by the
+    // first writer and kept for the program; LogFilter indexes its slots.
+    // Readers never block; tagMutex serializes table and filter writers.
+    // Lookups intern new tags so their pattern level is resolved once
+    std::atomic<TagLevelTable*> tagLevels_{nullptr};
+    mutable std::atomic<LogPlatform::MutexHandle> tagMutex{nullptr};
+
+    // Envelope layout (LoggerConfig::Envelope, read on every line)
+    std::atomic<uint8_t> envelopeTime_{0};
+    std::atomic<bool> envelopeDelta_{false};
+    std::atomic<bool> envelopeTaskId_{false};
+    std::atomic<uint32_t> lastLineUs_{0};  // For delta; wraps like micros()
 
     // Rate limiting
     std::atomic<uint32_t> maxLogsPerSecond{MAX_LOGS_PER_SECOND};
-    SemaphoreHandle_t rateLimitMutex;
-    uint32_t lastLogTime;
-    uint32_t logCounter;
+    RateBucket globalRate_;
+    RateBucket levelRates_[ESP_LOG_VERBOSE + 1];
+    std::atomic<uint8_t> tagRateLimits_{0};  // Tags with their own budget
+    std::atomic<uint8_t> tagSamplers_{0};    // Tags with an active sampler
+    std::atomic<uint32_t> sampledLogs_{0};
     std::atomic<uint32_t> droppedLogs{0};
 
+    // Adaptive throttle - sampled by whichever task first logs in a new window
+    LoggerConfig::Throttle throttle_;             // Only touched with throttleBusy_ held
+    mutable std::atomic<bool> throttleBusy_{false};
+    std::atomic<bool> throttleEnabled_{false};
+    std::atomic<uint32_t> throttleWindowUs_{0};
+    std::atomic<uint32_t> throttleWindowStart_{0};
+    std::atomic<esp_log_level_t> throttleLevel_{ESP_LOG_VERBOSE};
+    std::atomic<uint8_t> throttleSeen_{0};        // Bit per level that passed this window
+    std::atomic<uint32_t> throttledLogs_{0};
+    uint32_t throttleDrops_ = 0;                  // Drop total at the previous sample
+    uint32_t throttleSuppressedBase_ = 0;         // throttledLogs_ when masking started
+    uint32_t throttleSinceMs_ = 0;
+    uint8_t throttlePressured_ = 0;               // Consecutive windows, see LoggerConfig::Throttle
+    uint8_t throttleCalm_ = 0;
+
+    // Repeat coalescing (setDedupWindow) - try-locked, a busy cache is skipped
+    std::atomic<RepeatSlot*> repeats_{nullptr};  // CONFIG_LOG_DEDUP_SLOTS, allocated by setDedupWindow()
+    std::atomic<bool> repeatsBusy_{false};
+    std::atomic<uint32_t> dedupWindowMs_{0};
+    std::atomic<uint32_t> coalescedLogs_{0};
+
     // Diagnostic counters for mutex timeouts
     std::atomic<uint32_t> mutexTimeouts_{0};
+
+#if CONFIG_LOG_INSTRUMENTATION
+    LogStageRecorder stageStats_;
+#endif
+
+#if CONFIG_LOG_STATIC_ALLOCATION
+    // What the lazy paths above would otherwise take from the heap
+    LogPlatform::MutexStorage mutexStorage_[3];
+    TagLevelTable tagTableStorage_;
+    RepeatSlot repeatStorage_[CONFIG_LOG_DEDUP_SLOTS ? CONFIG_LOG_DEDUP_SLOTS : 1];
+    // One list published, the other idle until the next change (as filters_)
+    BackendList backendLists_[2];
+    SubscriberList subscriberLists_[2];
+#endif
+
+#if CONFIG_LOG_EARLY_BUFFER_SIZE
+    // Lines written while there is no backend, replayed into the first one
+    static_assert((CONFIG_LOG_EARLY_BUFFER_SIZE & (CONFIG_LOG_EARLY_BUFFER_SIZE - 1)) == 0 &&
+                      CONFIG_LOG_EARLY_BUFFER_SIZE >= 64,
+                  "CONFIG_LOG_EARLY_BUFFER_SIZE must be a power of two >= 64");
+    alignas(4) uint8_t earlyStorage_[CONFIG_LOG_EARLY_BUFFER_SIZE];
+    LogRingBuffer earlyRing_;
+    std::atomic<bool> earlyReplayed_{false};
+#endif
 };
 
+constexpr size_t LoggerConfig::estimatedMemoryUsage() {
+    return sizeof(Logger) +                                           // Singleton
+           sizeof(BufferPool) +                                       // SMALL + MEDIUM (+ LARGE if static)
+           (CONFIG_LOG_STATIC_ALLOCATION ? 0                          // Else heap (PSRAM when present)
+                                         : CONFIG_LOG_BUFFER_LARGE_SIZE * CONFIG_LOG_BUFFER_LARGE_COUNT);
+}
+
 // Global logger instance getter
 Logger& getLogger();
\ No newline at end of file
@@ -25,6 +25,11 @@
 
 #include <esp_log.h>
 #include <cstddef>
+#include <cstdint>
+
+#ifndef CONFIG_LOG_STATIC_ALLOCATION
+#define CONFIG_LOG_STATIC_ALLOCATION 0  // 1 = no heap from construction on (see Logger.h)
+#endif
 
 /**
  * @brief Logger configuration with static memory allocation
@@ -37,6 +42,7 @@ struct LoggerConfig {
     esp_log_level_t defaultLevel = ESP_LOG_INFO;
     bool enableLogging = true;
     uint32_t maxLogsPerSecond = 100;  // 0 = unlimited
+    uint32_t dedupWindowMs = 0;       // Coalesce repeats of a call site for this long (0 = off)
     
     // Backend configuration
     enum class BackendType {
@@ -50,7 +56,7 @@ struct LoggerConfig {
     // Tag-level configuration (static allocation)
     static constexpr size_t MAX_TAG_CONFIGS = 32;
     struct TagConfig {
-        const char* tag;         // Tag name (must be static string)
+        const char* tag;         // Tag name or "Prefix*" pattern (must be static string)
         esp_log_level_t level;   // Log level for this tag
     };
     TagConfig tagConfigs[MAX_TAG_CONFIGS] = {};
@@ -60,21 +66,58 @@ struct LoggerConfig {
     static constexpr size_t BUFFER_SIZE = 256;        // Size of each buffer
     static constexpr size_t BUFFER_COUNT = 8;         // Number of buffers in pool
 
+    // What BufferPool::acquire() does when every buffer is in use
+    enum class BufferExhaustion {
+        HEAP_FALLBACK,          // malloc() a buffer (never drops, fragments heap over time)
+        DROP,                   // Return nullptr - the message is dropped and counted
+        SPIN                    // Yield and retry CONFIG_LOG_BUFFER_SPIN_RETRIES times, then drop
+    };
+    BufferExhaustion bufferExhaustion =
+        CONFIG_LOG_STATIC_ALLOCATION ? BufferExhaustion::DROP : BufferExhaustion::HEAP_FALLBACK;
+
+    // Line envelope "[time][task][L] tag: "
+    struct Envelope {
+        enum class Time : uint8_t {
+            MILLIS,             // "[12345]" milliseconds since boot (default)
+            MICROS,             // "[12345678]" microseconds since boot (esp_timer)
+            NONE                // No time field
+        };
+        Time time = Time::MILLIS;
+        bool delta = false;     // Append "+elapsed" since the previous line, same unit
+        bool taskId = false;    // "[#3]" per-task short ID instead of the task name
+    };
+    Envelope envelope;
+
+    // Adaptive throttling: under sustained backpressure mask the most verbose
+    // levels first, instead of letting full queues drop messages at random
+    struct Throttle {
+        bool enabled = false;
+        esp_log_level_t minLevel = ESP_LOG_WARN;  // Never masks this level or anything more severe
+        uint32_t windowMs = 250;                  // Pressure is sampled once per window
+        uint32_t dropsPerWindow = 1;              // New drops in a window that count as pressure
+        uint8_t highWaterPercent = 75;            // Ring/queue fill that counts as pressure
+        uint8_t lowWaterPercent = 25;             // Fill below which a window counts as calm
+        uint8_t pressureWindows = 2;              // Consecutive pressured windows per masking step
+        uint8_t calmWindows = 8;                  // Consecutive calm windows before restoring
+    };
+    Throttle throttle;
+
     // Mutex timeout configuration (milliseconds)
     static constexpr uint32_t MUTEX_SHORT_TIMEOUT_MS = 10;    // Quick operations
-    static constexpr uint32_t MUTEX_MEDIUM_TIMEOUT_MS = 50;   // Rate limit checks
+    static constexpr uint32_t MUTEX_MEDIUM_TIMEOUT_MS = 50;   // Medium operations
     static constexpr uint32_t MUTEX_STANDARD_TIMEOUT_MS = 100; // Buffer pool, backend
 
     // Rate limit configuration
     static constexpr uint32_t RATE_LIMIT_WINDOW_MS = 1000;    // Rate limit window
     
-    // Memory usage estimates
-    static constexpr size_t estimatedMemoryUsage() {
-        return sizeof(LoggerConfig) +                   // Config struct
-               (BUFFER_SIZE * BUFFER_COUNT) +           // Buffer pool
-               (MAX_TAG_CONFIGS * 32) +                 // Tag string storage
-               1024;                                    // Logger internals
-    }
+    /**
+     * @brief RAM the logger takes before any optional subsystem is used
+     * @note Defined in Logger.h (needs the complete Logger). Counts the
+     *       singleton, the buffer pool and its LARGE class; the tag table,
+     *       rings, tasks and mutexes come on first use - Logger::getFootprint()
+     *       reports what is actually allocated.
+     */
+    static constexpr size_t estimatedMemoryUsage();
     
     // Helper to add tag configuration
     bool addTagConfig(const char* tag, esp_log_level_t level) {
@@ -109,6 +152,7 @@ struct LoggerConfig {
         config.defaultLevel = ESP_LOG_WARN;
         config.maxLogsPerSecond = 100;
         config.primaryBackend = BackendType::NON_BLOCKING_CONSOLE;  // Critical for production
+        config.bufferExhaustion = BufferExhaustion::DROP;  // No heap churn on long uptimes
         return config;
     }
 };
\ No newline at end of file
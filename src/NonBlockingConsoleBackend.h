@@ -25,7 +25,7 @@
 #pragma once
 
 #include "ILogBackend.h"
-#include <Arduino.h>
+#include "LogPlatform.h"
 #include <atomic>
 #include <inttypes.h>
 
@@ -38,7 +38,7 @@
  * Features:
  * - Never blocks - drops messages instead
  * - Tracks dropped messages and bytes
- * - Uses Serial.availableForWrite() to check buffer space
+ * - Uses LogPlatform::consoleAvailableForWrite() to check buffer space
  * - NEVER calls Serial.flush() which blocks
  * - Adds truncation markers when messages are partially written
  * 
@@ -67,7 +67,7 @@ public:
         if (!logMessage || length == 0) return;
         
         // Check available buffer space
-        size_t available = Serial.availableForWrite();
+        size_t available = LogPlatform::consoleAvailableForWrite();
         
         // If buffer is too full, drop the entire message
         if (available < MIN_BUFFER_SPACE) {
@@ -81,13 +81,13 @@ public:
         
         if (available >= length) {
             // Entire message fits
-            written = Serial.write(logMessage, length);
+            written = LogPlatform::consoleWrite(logMessage, length);
         } else {
             // Partial write - leave room for truncation marker
             size_t toWrite = available - TRUNCATION_MARKER_LEN;
             if (toWrite > 0) {
-                written = Serial.write(logMessage, toWrite);
-                Serial.write(TRUNCATION_MARKER, TRUNCATION_MARKER_LEN);
+                written = LogPlatform::consoleWrite(logMessage, toWrite);
+                LogPlatform::consoleWrite(TRUNCATION_MARKER, TRUNCATION_MARKER_LEN);
                 partialWrites.fetch_add(1);
             } else {
                 // Not enough room even for truncated message
@@ -110,7 +110,7 @@ public:
     }
     
     // Statistics methods
-    uint32_t getDroppedMessages() const { 
+    uint32_t getDroppedMessages() const override { 
         return droppedMessages.load(); 
     }
     
@@ -130,7 +130,7 @@ public:
     
     // Get current buffer status
     size_t getAvailableBuffer() const {
-        return Serial.availableForWrite();
+        return LogPlatform::consoleAvailableForWrite();
     }
     
     // Check if we're in a critical state (buffer nearly full)
@@ -140,12 +140,12 @@ public:
     
     // Print statistics (useful for debugging)
     void printStats() {
-        // Use direct Serial.printf to avoid recursion
-        Serial.printf("\r\n=== NonBlockingConsoleBackend Stats ===\r\n");
-        Serial.printf("Dropped messages: %" PRIu32 "\r\n", droppedMessages.load());
-        Serial.printf("Dropped bytes: %" PRIu32 "\r\n", droppedBytes.load());
-        Serial.printf("Partial writes: %" PRIu32 "\r\n", partialWrites.load());
-        Serial.printf("Current buffer available: %u bytes\r\n", (unsigned int)Serial.availableForWrite());
-        Serial.printf("=====================================\r\n");
+        // Straight to the console to avoid recursion
+        LogPlatform::consolePrintf("\r\n=== NonBlockingConsoleBackend Stats ===\r\n");
+        LogPlatform::consolePrintf("Dropped messages: %" PRIu32 "\r\n", droppedMessages.load());
+        LogPlatform::consolePrintf("Dropped bytes: %" PRIu32 "\r\n", droppedBytes.load());
+        LogPlatform::consolePrintf("Partial writes: %" PRIu32 "\r\n", partialWrites.load());
+        LogPlatform::consolePrintf("Current buffer available: %u bytes\r\n", (unsigned int)LogPlatform::consoleAvailableForWrite());
+        LogPlatform::consolePrintf("=====================================\r\n");
     }
 };
\ No newline at end of file
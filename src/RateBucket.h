@@ -0,0 +1,105 @@
+/*
+ * RateBucket.h - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// RateBucket.h
+// Lock-free token bucket (GCRA) for log rate limiting
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Token bucket in one atomic word, using the Generic Cell Rate Algorithm
+ *
+ * Instead of a token count plus a refill timestamp, the bucket stores one
+ * "theoretical arrival time" (TAT) in microseconds. A message is allowed if
+ * TAT is at most `tolerance` ahead of now, and the TAT then advances by one
+ * emission interval. So `perSecond` messages per second pass in the long
+ * run, and up to `burst` may go back-to-back. The only state that changes is
+ * the single CAS on tat_, so any number of tasks on both cores (and ISRs)
+ * can call tryAcquire() concurrently without a mutex.
+ *
+ * Times wrap every ~71 minutes (32-bit micros); a TAT that appears further
+ * ahead than any valid state allows is treated as stale (bucket full).
+ */
+class RateBucket {
+public:
+    RateBucket() = default;
+
+    // Non-copyable (shared between tasks by reference)
+    RateBucket(const RateBucket&) = delete;
+    RateBucket& operator=(const RateBucket&) = delete;
+
+    /**
+     * @brief Set the budget
+     * @param perSecond Sustained messages per second (0 = unlimited)
+     * @param burst Messages allowed back-to-back (0 = one second's worth)
+     */
+    void configure(uint32_t perSecond, uint32_t burst = 0) {
+        if (perSecond == 0) {
+            interval_.store(0, std::memory_order_relaxed);
+            return;
+        }
+        if (perSecond > 1000000) perSecond = 1000000;
+        if (burst == 0) burst = perSecond;
+        uint32_t interval = 1000000 / perSecond;
+        uint64_t tolerance = static_cast<uint64_t>(burst - 1) * interval;
+        tolerance_.store(tolerance > 0x3FFFFFFF ? 0x3FFFFFFF : static_cast<uint32_t>(tolerance),
+                         std::memory_order_relaxed);
+        interval_.store(interval, std::memory_order_relaxed);
+    }
+
+    bool isLimited() const { return interval_.load(std::memory_order_relaxed) != 0; }
+
+    /**
+     * @brief Take one message's worth of budget
+     * @param nowUs Current time in microseconds (micros())
+     * @return true if the message may be logged
+     */
+    bool tryAcquire(uint32_t nowUs) {
+        uint32_t interval = interval_.load(std::memory_order_relaxed);
+        if (interval == 0) return true;
+        uint32_t tolerance = tolerance_.load(std::memory_order_relaxed);
+
+        uint32_t tat = tat_.load(std::memory_order_relaxed);
+        for (;;) {
+            int32_t ahead = static_cast<int32_t>(tat - nowUs);
+            if (ahead < 0 || static_cast<uint32_t>(ahead) > tolerance + interval) {
+                ahead = 0;  // Idle (or stale after wrap-around): bucket is full
+            }
+            if (static_cast<uint32_t>(ahead) > tolerance) return false;
+
+            if (tat_.compare_exchange_weak(tat, nowUs + static_cast<uint32_t>(ahead) + interval,
+                                           std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    // Refill to a full burst
+    void reset() { tat_.store(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint32_t> interval_{0};   // Microseconds per message, 0 = unlimited
+    std::atomic<uint32_t> tolerance_{0};  // How far TAT may run ahead of now
+    std::atomic<uint32_t> tat_{0};        // Theoretical arrival time
+};
@@ -0,0 +1,122 @@
+/*
+ * RcuPointer.h - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// RcuPointer.h
+// Read-copy-update pointer: lock-free readers, writers publish immutable copies
+
+#pragma once
+
+#include "LogPlatform.h"
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Atomically published pointer to an immutable object, with safe reclamation
+ *
+ * Readers take a ReadGuard: two atomic increments/decrements on a reader
+ * counter, no lock, no allocation - usable from any task on either core.
+ * Writers build a new object and call replace(), which publishes it and
+ * deletes the previous object once no reader can still be using it.
+ *
+ * Reclamation is a two-phase epoch wait (as in userspace RCU): readers count
+ * themselves in the counter of the current epoch. After publishing, the
+ * writer flips the epoch and waits for the old epoch's counter to drain,
+ * twice, so every reader that could have loaded the old pointer has left.
+ * Readers that arrive meanwhile see the new pointer and never delay the
+ * writer beyond the second flip.
+ *
+ * Writers must be serialized by the caller, and must not call replace()
+ * while holding a ReadGuard themselves (it would wait for itself).
+ */
+template <typename T>
+class RcuPointer {
+public:
+    explicit RcuPointer(T* initial = nullptr) : ptr_(initial) {}
+    ~RcuPointer() { delete ptr_.load(); }
+
+    RcuPointer(const RcuPointer&) = delete;
+    RcuPointer& operator=(const RcuPointer&) = delete;
+
+    /**
+     * @brief Scoped read access - the object stays alive until destruction
+     */
+    class ReadGuard {
+    public:
+        explicit ReadGuard(const RcuPointer& rcu) : rcu_(rcu) {
+            slot_ = rcu_.epoch_.load() & 1;
+            rcu_.readers_[slot_].fetch_add(1);
+            ptr_ = rcu_.ptr_.load();  // After the increment - see replace()
+        }
+        ~ReadGuard() { rcu_.readers_[slot_].fetch_sub(1); }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        const T* get() const { return ptr_; }
+        const T* operator->() const { return ptr_; }
+        explicit operator bool() const { return ptr_ != nullptr; }
+
+    private:
+        const RcuPointer& rcu_;
+        uint32_t slot_;
+        const T* ptr_;
+    };
+
+    /**
+     * @brief Current object for writers (caller serializes writers)
+     */
+    const T* writerView() const { return ptr_.load(); }
+
+    /**
+     * @brief Publish `next` and delete the previous object once unreferenced
+     * @note Blocks until in-flight readers of the old object are done
+     */
+    void replace(T* next) {
+        delete exchange(next);
+    }
+
+    /**
+     * @brief Publish `next` and hand back the previous object, unreferenced
+     * @return Previous object - no reader uses it any more; the caller owns
+     *         it (for objects that are reused instead of deleted)
+     * @note Blocks like replace()
+     */
+    T* exchange(T* next) {
+        T* old = ptr_.exchange(next);
+        synchronize();
+        return old;
+    }
+
+private:
+    void synchronize() {
+        for (int phase = 0; phase < 2; phase++) {
+            uint32_t previous = epoch_.fetch_add(1) & 1;
+            while (readers_[previous].load() != 0) {
+                // No readers exist before the scheduler starts, so this only runs with it
+                LogPlatform::delayMs(1);
+            }
+        }
+    }
+
+    std::atomic<T*> ptr_;
+    mutable std::atomic<uint32_t> epoch_{0};
+    mutable std::atomic<uint32_t> readers_[2] = {};
+};
@@ -0,0 +1,149 @@
+/*
+ * RtcTailBackend.cpp - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// RtcTailBackend.cpp
+// Needs RTC memory: not part of the native build (LogPlatform.h)
+#if !defined(LOG_PLATFORM_NATIVE)
+
+#include "RtcTailBackend.h"
+#include <esp_attr.h>
+#include <esp_system.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+struct RtcTail {
+    uint32_t magic;
+    uint32_t state;  // Check byte (high 8 bits) | end (low 24 bits)
+    char data[RtcTailBackend::CAPACITY];
+};
+
+RTC_NOINIT_ATTR RtcTail rtcTail;
+
+// Bytes ever reserved; the ring index is the low bits
+std::atomic<uint32_t> cursor{0};
+
+constexpr uint32_t END_MASK = 0x00FFFFFF;
+constexpr size_t INDEX_MASK = RtcTailBackend::CAPACITY - 1;
+
+inline uint32_t checkByte(uint32_t end) {
+    return (end ^ (end >> 8) ^ (end >> 16) ^ 0xA5) & 0xFF;
+}
+
+// The stored end stays below 2 * CAPACITY: CAPACITY + index once the ring has wrapped
+inline uint32_t packState(uint32_t end) {
+    if (end >= RtcTailBackend::CAPACITY) end = RtcTailBackend::CAPACITY | (end & INDEX_MASK);
+    return (checkByte(end) << 24) | end;
+}
+
+const char* resetReasonName(esp_reset_reason_t reason) {
+    switch (reason) {
+        case ESP_RST_POWERON:   return "power-on";
+        case ESP_RST_EXT:       return "external";
+        case ESP_RST_SW:        return "software";
+        case ESP_RST_PANIC:     return "panic";
+        case ESP_RST_INT_WDT:   return "interrupt watchdog";
+        case ESP_RST_TASK_WDT:  return "task watchdog";
+        case ESP_RST_WDT:       return "watchdog";
+        case ESP_RST_DEEPSLEEP: return "deep sleep";
+        case ESP_RST_BROWNOUT:  return "brownout";
+        default:                return "other";
+    }
+}
+
+inline bool unpackState(uint32_t state, uint32_t& end) {
+    end = state & END_MASK;
+    return (state >> 24) == checkByte(end) && end < 2 * RtcTailBackend::CAPACITY;
+}
+}  // namespace
+
+RtcTailBackend::RtcTailBackend() {
+    uint32_t end;
+    if (rtcTail.magic == MAGIC && unpackState(rtcTail.state, end)) {
+        // Continue the ring; replay() shows everything up to here
+        cursor.store(end, std::memory_order_relaxed);
+        previousLength_ = end < CAPACITY ? end : CAPACITY;
+    } else {
+        clear();
+    }
+}
+
+void RtcTailBackend::clear() {
+    cursor.store(0, std::memory_order_relaxed);
+    rtcTail.state = packState(0);
+    rtcTail.magic = MAGIC;
+    previousLength_ = 0;
+}
+
+void RtcTailBackend::write(const char* logMessage, size_t length) {
+    if (!logMessage || length == 0) return;
+    if (length > CAPACITY) {
+        // Only the end of an over-long message can be kept
+        logMessage += length - CAPACITY;
+        length = CAPACITY;
+    }
+
+    uint32_t pos = cursor.fetch_add(static_cast<uint32_t>(length), std::memory_order_relaxed);
+    size_t index = pos & INDEX_MASK;
+    size_t first = std::min(length, CAPACITY - index);
+    memcpy(rtcTail.data + index, logMessage, first);
+    memcpy(rtcTail.data, logMessage + first, length - first);
+
+    // One aligned store: a reset never sees a torn end offset
+    rtcTail.state = packState(pos + static_cast<uint32_t>(length));
+    writtenMessages_.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t RtcTailBackend::replay(ILogBackend& target) {
+    if (previousLength_ == 0) return 0;
+
+    uint32_t end;
+    unpackState(rtcTail.state, end);
+    char* data = rtcTail.data;
+    char* stop = data + previousLength_;
+
+    if (end >= CAPACITY) {
+        // Wrapped: rotate the ring into order and drop the partial first line
+        size_t start = end & INDEX_MASK;
+        std::rotate(data, data + start, data + CAPACITY);
+        char* firstLine = static_cast<char*>(memchr(data, '\n', CAPACITY));
+        if (firstLine) data = firstLine + 1;
+    }
+
+    char marker[80];
+    int n = snprintf(marker, sizeof(marker), "--- %u bytes of log before %s reset ---\r\n",
+                     static_cast<unsigned>(stop - data), resetReasonName(esp_reset_reason()));
+    if (n > 0) target.write(marker, std::min<size_t>(n, sizeof(marker) - 1));
+
+    size_t replayed = stop - data;
+    while (data < stop) {
+        char* lineEnd = static_cast<char*>(memchr(data, '\n', stop - data));
+        size_t length = lineEnd ? lineEnd + 1 - data : stop - data;
+        target.write(data, length);
+        data += length;
+    }
+
+    clear();
+    return replayed;
+}
+
+#endif  // !LOG_PLATFORM_NATIVE
@@ -0,0 +1,106 @@
+/*
+ * RtcTailBackend.h - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// RtcTailBackend.h
+// Last few hundred bytes of log output in RTC memory, replayed after a reset
+#pragma once
+
+#include "ILogBackend.h"
+#include <atomic>
+
+#ifndef CONFIG_LOG_RTC_TAIL_SIZE
+#define CONFIG_LOG_RTC_TAIL_SIZE 1024  // Bytes of RTC memory for the tail (power of two)
+#endif
+
+/**
+ * @brief Backend that keeps the newest log bytes in RTC_NOINIT memory
+ *
+ * RTC memory survives software resets, panics and watchdog resets (not power
+ * loss), so the lines leading up to a crash are still there on the next boot.
+ * A write is a lock-free reservation, a memcpy into the ring and one 32-bit
+ * store of the new end - cheap enough to leave on in production, and safe
+ * from any task or before the scheduler starts.
+ *
+ * The end offset is stored together with a check byte in a single word, so
+ * a reset between two stores cannot leave a half-updated header, and the
+ * power-on garbage in uninitialized RTC memory is rejected (magic marker +
+ * check byte). Concurrent writers may finish out of order; the stored end
+ * is then the one of the last writer, and the replay can stop a record
+ * early or end in one that was still being copied.
+ *
+ * All instances share the one RTC region: create a single backend.
+ *
+ * Usage (in setup(), before the normal backends):
+ *   auto tail = std::make_shared<RtcTailBackend>();
+ *   tail->replay(*serialBackend);  // Previous boot's tail, then cleared
+ *   logger.setBackend(serialBackend);
+ *   logger.addBackend(tail);
+ */
+class RtcTailBackend : public ILogBackend {
+public:
+    static constexpr size_t CAPACITY = CONFIG_LOG_RTC_TAIL_SIZE;
+    static constexpr uint32_t MAGIC = 0x4C475452;  // "RTGL"
+
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CONFIG_LOG_RTC_TAIL_SIZE must be a power of two");
+    static_assert(CAPACITY <= (1u << 16), "CONFIG_LOG_RTC_TAIL_SIZE too large for RTC memory");
+
+    /**
+     * @brief Validate the RTC region; keeps a previous tail for replay()
+     */
+    RtcTailBackend();
+
+    RtcTailBackend(const RtcTailBackend&) = delete;
+    RtcTailBackend& operator=(const RtcTailBackend&) = delete;
+
+    void write(const std::string& logMessage) override {
+        write(logMessage.c_str(), logMessage.length());
+    }
+    void write(const char* logMessage, size_t length) override;
+
+    void flush() override {}  // Nothing buffered: RTC memory is the store
+
+    /**
+     * @brief Bytes held from before this boot (0 if none or invalid)
+     */
+    size_t getPreviousLength() const { return previousLength_; }
+
+    /**
+     * @brief Write the tail from before this boot to target, line by line
+     * @return Bytes replayed
+     * @note Starts with a marker line naming the reset reason, then clears
+     *       the tail. Call it before the backend is added to the Logger.
+     */
+    size_t replay(ILogBackend& target);
+
+    /**
+     * @brief Drop everything stored so far
+     */
+    void clear();
+
+    // Statistics getters
+    uint32_t getWrittenMessages() const { return writtenMessages_.load(std::memory_order_relaxed); }
+
+    void resetStats() { writtenMessages_.store(0); }
+
+private:
+    std::atomic<uint32_t> writtenMessages_{0};
+    size_t previousLength_ = 0;
+};
@@ -23,5 +23,5 @@
 #include "SynchronizedConsoleBackend.h"
 
 // Static member initialization
-std::atomic<SemaphoreHandle_t> SynchronizedConsoleBackend::serialMutex{nullptr};
+std::atomic<LogPlatform::MutexHandle> SynchronizedConsoleBackend::serialMutex{nullptr};
 std::atomic<bool> SynchronizedConsoleBackend::mutexInitialized{false};
\ No newline at end of file
@@ -24,9 +24,7 @@
 
 #include "ILogBackend.h"
 #include "LoggerConfig.h"
-#include <Arduino.h>
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
+#include "LogPlatform.h"
 #include <atomic>
 
 /**
@@ -43,7 +41,7 @@
  */
 class SynchronizedConsoleBackend : public ILogBackend {
 private:
-    static std::atomic<SemaphoreHandle_t> serialMutex;
+    static std::atomic<LogPlatform::MutexHandle> serialMutex;
     static std::atomic<bool> mutexInitialized;
 
     static void ensureMutexInitialized() {
@@ -51,17 +49,17 @@ private:
         if (!mutexInitialized.load(std::memory_order_acquire)) {
             // Create mutex - if two threads race here, one will get nullptr
             // which is fine since we check before use
-            SemaphoreHandle_t newMutex = xSemaphoreCreateMutex();
+            LogPlatform::MutexHandle newMutex = LogPlatform::createMutex();
             if (newMutex) {
                 // Try to set serialMutex atomically using std::atomic
-                SemaphoreHandle_t expected = nullptr;
+                LogPlatform::MutexHandle expected = nullptr;
                 if (serialMutex.compare_exchange_strong(expected, newMutex,
                                                          std::memory_order_seq_cst,
                                                          std::memory_order_seq_cst)) {
                     mutexInitialized.store(true, std::memory_order_release);
                 } else {
                     // Another thread won the race, delete our mutex
-                    vSemaphoreDelete(newMutex);
+                    LogPlatform::deleteMutex(newMutex);
                 }
             }
         }
@@ -79,15 +77,15 @@ public:
     void write(const char* logMessage, size_t length) override {
         if (!mutexInitialized.load() || !logMessage) return;
 
-        SemaphoreHandle_t mutex = serialMutex.load();
+        LogPlatform::MutexHandle mutex = serialMutex.load();
         if (!mutex) return;
 
         // Take mutex with reasonable timeout
-        if (xSemaphoreTake(mutex, pdMS_TO_TICKS(LoggerConfig::MUTEX_STANDARD_TIMEOUT_MS)) == pdTRUE) {
+        if (LogPlatform::takeMutex(mutex, LoggerConfig::MUTEX_STANDARD_TIMEOUT_MS)) {
             // Write directly to Serial - already includes \r\n from Logger
-            Serial.write(logMessage, length);
-            Serial.flush(); // Ensure complete message is sent before releasing mutex
-            xSemaphoreGive(mutex);
+            LogPlatform::consoleWrite(logMessage, length);
+            LogPlatform::consoleFlush(); // Ensure complete message is sent before releasing mutex
+            LogPlatform::giveMutex(mutex);
         }
     }
 
@@ -96,10 +94,10 @@ public:
         // Only flush if we can get the mutex quickly
         if (!mutexInitialized.load()) return;
 
-        SemaphoreHandle_t mutex = serialMutex.load();
-        if (mutex && xSemaphoreTake(mutex, pdMS_TO_TICKS(LoggerConfig::MUTEX_SHORT_TIMEOUT_MS / 2)) == pdTRUE) {
-            Serial.flush();
-            xSemaphoreGive(mutex);
+        LogPlatform::MutexHandle mutex = serialMutex.load();
+        if (mutex && LogPlatform::takeMutex(mutex, LoggerConfig::MUTEX_SHORT_TIMEOUT_MS / 2)) {
+            LogPlatform::consoleFlush();
+            LogPlatform::giveMutex(mutex);
         }
     }
 };
\ No newline at end of file
@@ -0,0 +1,317 @@
+/*
+ * TagLevelTable.h - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// TagLevelTable.h
+// Read-mostly hashed tag table with lock-free lookups
+// Doubles as the tag registry that maps tag IDs (LogTag.h) back to names
+// Levels live in LogFilter, indexed by this table's slots
+
+#pragma once
+
+#include <esp_log.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "LogTag.h"
+#include "RateBucket.h"
+#include "LogSampler.h"
+#include "LogStats.h"
+
+#ifndef CONFIG_LOG_MAX_TAGS
+#define CONFIG_LOG_MAX_TAGS 32      // Maximum number of tag-specific levels
+#endif
+
+// Smallest power of two >= n (C++11 constexpr, usable in array bounds)
+static constexpr size_t tagTableNextPow2(size_t n, size_t p = 1) {
+    return p >= n ? p : tagTableNextPow2(n, p << 1);
+}
+
+/**
+ * @brief Hashed tag table that readers can query without locking
+ *
+ * Entries are append-only: once a tag is published it is never moved or
+ * removed. Publication order is "fill entry, then store its index into the
+ * hash slot with release", so a reader that observes the slot with acquire
+ * also observes the complete entry. This gives wait-free lookups for any
+ * number of concurrent tasks, and name pointers returned by nameOf() stay
+ * valid forever.
+ *
+ * Each entry holds the tag's rate budget (unlimited by default) and its
+ * sampler (off by default). Levels are not stored here: LogFilter keeps
+ * them per slot, so a whole level configuration can be swapped at once.
+ * An entry only caches the level a filter resolved for a tag that was
+ * added after that filter was built (see cachedLevel()).
+ *
+ * Writers (intern(), slotFor(), ...) must be serialized by the caller -
+ * Logger uses tagMutex.
+ */
+class TagLevelTable {
+public:
+    static constexpr size_t CAPACITY = CONFIG_LOG_MAX_TAGS;
+    static constexpr size_t NAME_SIZE = CONFIG_LOG_SUBSCRIBER_TAG_SIZE;
+
+    TagLevelTable() = default;
+
+    // Non-copyable (entries are referenced by slot index)
+    TagLevelTable(const TagLevelTable&) = delete;
+    TagLevelTable& operator=(const TagLevelTable&) = delete;
+
+    /**
+     * @brief FNV-1a hash over the significant part of a tag
+     * @note Only the first NAME_SIZE - 1 characters are hashed, matching the
+     *       truncation applied when a tag is stored. Runtime twin of
+     *       logTagHash() - both must produce identical IDs.
+     */
+    static uint32_t hash(const char* tag) {
+        uint32_t h = FNV_OFFSET;
+        for (size_t i = 0; i < NAME_SIZE - 1 && tag[i] != '\0'; i++) {
+            h = (h ^ static_cast<uint8_t>(tag[i])) * FNV_PRIME;
+        }
+        return h == 0 ? 1u : h;
+    }
+
+    /**
+     * @brief True if the tag is a prefix pattern: ends in '*'
+     */
+    static bool isPattern(const char* tag) {
+        size_t len = strnlen(tag, NAME_SIZE - 1);
+        return len > 0 && tag[len - 1] == '*';
+    }
+
+    /**
+     * @brief Slot of a tag, by ID if non-zero, else by name (lock-free)
+     * @return Slot, or -1 if the tag is not in the table
+     */
+    int slotOf(const char* tag, uint32_t id) const {
+        if (count_.load(std::memory_order_acquire) == 0) return -1;
+        return id ? findSlot(id, nullptr) : findSlot(hash(tag), tag);
+    }
+
+    /**
+     * @brief Name stored in a slot (slot < size())
+     */
+    const char* nameAt(size_t slot) const { return entries_[slot].name; }
+
+    /**
+     * @brief Resolve a tag ID back to its registered name
+     * @return Name, or nullptr if the ID was never registered
+     */
+    const char* nameOf(uint32_t id) const {
+        int slot = findSlot(id, nullptr);
+        return slot < 0 ? nullptr : entries_[slot].name;
+    }
+
+    /**
+     * @brief Check whether a tag ID is registered (lock-free)
+     */
+    bool contains(uint32_t id) const { return findSlot(id, nullptr) >= 0; }
+
+    /**
+     * @brief Slot of a tag, inserting the tag if needed
+     * @return -1 if the tag is new and the table is full
+     * @note Caller must serialize writers
+     */
+    int slotFor(const char* tag) {
+        Entry* entry = insert(tag, hash(tag));
+        return entry ? static_cast<int>(entry - entries_) : -1;
+    }
+
+    /**
+     * @brief Register a tag name for its ID without configuring a level
+     * @return false if the table is full
+     * @note Caller must serialize writers
+     */
+    bool intern(const char* tag, uint32_t id) {
+        return insert(tag, id) != nullptr;
+    }
+
+    /**
+     * @brief Insert a tag (if needed) and set its rate budget
+     * @return false if the tag is new and the table is full
+     * @note Caller must serialize writers
+     */
+    bool setRate(const char* tag, uint32_t perSecond, uint32_t burst) {
+        Entry* entry = insert(tag, hash(tag));
+        if (!entry) return false;
+        entry->rate.configure(perSecond, burst);
+        return true;
+    }
+
+    /**
+     * @brief Rate bucket of a tag, by ID if non-zero, else by name (lock-free)
+     * @return Bucket, or nullptr if the tag is not in the table
+     */
+    RateBucket* rateOf(const char* tag, uint32_t id) {
+        if (count_.load(std::memory_order_acquire) == 0) return nullptr;
+        int slot = id ? findSlot(id, nullptr) : findSlot(hash(tag), tag);
+        return slot < 0 ? nullptr : &entries_[slot].rate;
+    }
+
+    /**
+     * @brief Sampler of a tag, inserting the tag if needed
+     * @return nullptr if the tag is new and the table is full
+     * @note Caller must serialize writers (and the sampler's configure calls)
+     */
+    LogSampler* samplerFor(const char* tag) {
+        Entry* entry = insert(tag, hash(tag));
+        return entry ? &entry->sampler : nullptr;
+    }
+
+    /**
+     * @brief Sampler of a tag, by ID if non-zero, else by name (lock-free)
+     * @return Sampler, or nullptr if the tag is not in the table
+     */
+    LogSampler* samplerOf(const char* tag, uint32_t id) {
+        if (count_.load(std::memory_order_acquire) == 0) return nullptr;
+        int slot = id ? findSlot(id, nullptr) : findSlot(hash(tag), tag);
+        return slot < 0 ? nullptr : &entries_[slot].sampler;
+    }
+
+    size_t size() const { return count_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Level a filter resolved for a slot, if it was resolved under `stamp`
+     * @note Lock-free; the cache belongs to whichever filter wrote it last.
+     *       Any reader may fill it, since the level follows from the
+     *       immutable filter named by the stamp.
+     */
+    bool cachedLevel(int slot, uint32_t stamp, uint8_t& level) const {
+        uint32_t cached = entries_[slot].resolved.load(std::memory_order_relaxed);
+        if ((cached >> 8) != (stamp & STAMP_MASK)) return false;
+        level = static_cast<uint8_t>(cached);
+        return true;
+    }
+
+    void cacheLevel(int slot, uint32_t stamp, uint8_t level) const {
+        entries_[slot].resolved.store(((stamp & STAMP_MASK) << 8) | level, std::memory_order_relaxed);
+    }
+
+#if CONFIG_LOG_INSTRUMENTATION
+    /**
+     * @brief Count a written line for a tag (by ID if non-zero, else by name)
+     * @return false if the tag is not in the table
+     */
+    bool countLine(const char* tag, uint32_t id, size_t length) {
+        if (count_.load(std::memory_order_acquire) == 0) return false;
+        int slot = id ? findSlot(id, nullptr) : findSlot(hash(tag), tag);
+        if (slot < 0) return false;
+        entries_[slot].messages.fetch_add(1, std::memory_order_relaxed);
+        entries_[slot].bytes.fetch_add(static_cast<uint32_t>(length), std::memory_order_relaxed);
+        return true;
+    }
+
+    // Tags that wrote at least one line, in registration order
+    size_t snapshotCounts(LogTagStats* out, size_t maxCount) const {
+        size_t count = count_.load(std::memory_order_acquire);
+        size_t n = 0;
+        for (size_t i = 0; i < count && n < maxCount; i++) {
+            uint32_t messages = entries_[i].messages.load(std::memory_order_relaxed);
+            if (messages == 0) continue;
+            out[n].tag = entries_[i].name;
+            out[n].messages = messages;
+            out[n].bytes = entries_[i].bytes.load(std::memory_order_relaxed);
+            n++;
+        }
+        return n;
+    }
+
+    void resetCounts() {
+        size_t count = count_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; i++) {
+            entries_[i].messages.store(0, std::memory_order_relaxed);
+            entries_[i].bytes.store(0, std::memory_order_relaxed);
+        }
+    }
+#endif
+
+private:
+    static constexpr uint32_t FNV_OFFSET = 2166136261u;
+    static constexpr uint32_t FNV_PRIME = 16777619u;
+
+    // Open-addressing index kept at <= 50% load so probes stay short
+    static constexpr size_t INDEX_SIZE = tagTableNextPow2(CAPACITY * 2);
+    static constexpr size_t INDEX_MASK = INDEX_SIZE - 1;
+
+    static_assert(CAPACITY < 0xFFFF, "CONFIG_LOG_MAX_TAGS too large for 16-bit slot index");
+
+    // cachedLevel() keeps 24 bits of the stamp next to the level; 0 means empty
+    static constexpr uint32_t STAMP_MASK = 0xFFFFFF;
+
+    struct Entry {
+        uint32_t hash;
+        mutable std::atomic<uint32_t> resolved;  // Filter stamp << 8 | level (cachedLevel())
+        char name[NAME_SIZE];
+        RateBucket rate;
+        LogSampler sampler;
+#if CONFIG_LOG_INSTRUMENTATION
+        std::atomic<uint32_t> messages;
+        std::atomic<uint32_t> bytes;
+#endif
+    };
+
+    // Probe for an entry by hash; when `tag` is given the name must match too
+    int findSlot(uint32_t h, const char* tag) const {
+        for (size_t probe = 0, i = h & INDEX_MASK; probe < INDEX_SIZE;
+             probe++, i = (i + 1) & INDEX_MASK) {
+            uint16_t slot = index_[i].load(std::memory_order_acquire);
+            if (slot == 0) return -1;  // Empty slot terminates the probe
+
+            const Entry& entry = entries_[slot - 1];
+            if (entry.hash == h && (!tag || strncmp(entry.name, tag, NAME_SIZE - 1) == 0)) {
+                return slot - 1;
+            }
+        }
+        return -1;
+    }
+
+    Entry* insert(const char* tag, uint32_t h) {
+        size_t i = h & INDEX_MASK;
+        for (size_t probe = 0; probe < INDEX_SIZE; probe++, i = (i + 1) & INDEX_MASK) {
+            uint16_t slot = index_[i].load(std::memory_order_relaxed);
+            if (slot == 0) break;
+
+            Entry& entry = entries_[slot - 1];
+            if (entry.hash == h && strncmp(entry.name, tag, NAME_SIZE - 1) == 0) {
+                return &entry;
+            }
+        }
+
+        size_t count = count_.load(std::memory_order_relaxed);
+        if (count >= CAPACITY) return nullptr;
+
+        // Fill the entry completely before making it reachable
+        Entry& entry = entries_[count];
+        size_t len = strnlen(tag, NAME_SIZE - 1);
+        memcpy(entry.name, tag, len);
+        entry.name[len] = '\0';
+        entry.hash = h;
+        entry.resolved.store(0, std::memory_order_relaxed);
+
+        index_[i].store(static_cast<uint16_t>(count + 1), std::memory_order_release);
+        count_.store(count + 1, std::memory_order_release);
+        return &entry;
+    }
+
+    Entry entries_[CAPACITY] = {};
+    std::atomic<uint16_t> index_[INDEX_SIZE] = {};  // 0 = empty, else entry index + 1
+    std::atomic<size_t> count_{0};
+};
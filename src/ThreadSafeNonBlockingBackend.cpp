@@ -23,5 +23,80 @@
 #include "ThreadSafeNonBlockingBackend.h"
 
 // Static member initialization
-std::atomic<SemaphoreHandle_t> ThreadSafeNonBlockingBackend::writeMutex_{nullptr};
-std::atomic<bool> ThreadSafeNonBlockingBackend::mutexInitialized_{false};
+LogRingBuffer ThreadSafeNonBlockingBackend::ring_;
+std::atomic<uint8_t> ThreadSafeNonBlockingBackend::ringState_{0};
+std::atomic<bool> ThreadSafeNonBlockingBackend::flushing_{false};
+std::atomic<bool> ThreadSafeNonBlockingBackend::drainPending_{false};
+size_t ThreadSafeNonBlockingBackend::headSent_ = 0;
+
+static constexpr uint8_t RING_NONE = 0;
+static constexpr uint8_t RING_INITIALIZING = 1;
+static constexpr uint8_t RING_READY = 2;
+
+void ThreadSafeNonBlockingBackend::ensureRingInitialized() {
+    // First constructor allocates; a racing one sees INITIALIZING and its
+    // writes drop until READY
+    uint8_t expected = RING_NONE;
+    if (ringState_.compare_exchange_strong(expected, RING_INITIALIZING)) {
+        ringState_.store(ring_.init(CONFIG_LOG_TSNB_BUFFER_SIZE) ? RING_READY : RING_NONE,
+                         std::memory_order_release);
+    }
+}
+
+void ThreadSafeNonBlockingBackend::write(const char* logMessage, size_t length) {
+    if (!logMessage || length == 0) return;
+
+    // Copy straight into the shared ring - no lock, no stack buffer
+    if (ringState_.load(std::memory_order_acquire) != RING_READY || !ring_.push(logMessage, length)) {
+        droppedMessages_.fetch_add(1, std::memory_order_relaxed);
+        droppedBytes_.fetch_add(length, std::memory_order_relaxed);
+        bufferFull_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    writtenMessages_.fetch_add(1, std::memory_order_relaxed);
+
+    if (!drain()) {
+        // Another task is flushing and will send this message too
+        mutexContention_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool ThreadSafeNonBlockingBackend::drain() {
+    if (ringState_.load(std::memory_order_acquire) != RING_READY) return true;
+
+    for (;;) {
+        // Announce work before the election: a losing writer's flag is seen
+        // by the flusher after it lets go, so no committed record is stranded
+        drainPending_.store(true);
+        if (flushing_.exchange(true)) return false;
+        drainPending_.store(false);
+
+        // Only the flusher touches Serial and headSent_
+        bool stalled = false;
+        const uint8_t* data;
+        size_t length;
+        while (ring_.peek(data, length)) {
+            size_t available = LogPlatform::consoleAvailableForWrite();
+            if (available == 0) {
+                stalled = true;
+                break;
+            }
+            size_t chunk = length - headSent_;
+            if (chunk > available) chunk = available;
+            LogPlatform::consoleWrite(reinterpret_cast<const char*>(data) + headSent_, chunk);
+            headSent_ += chunk;
+            if (headSent_ < length) {
+                stalled = true;
+                break;
+            }
+            headSent_ = 0;
+            ring_.pop();
+        }
+
+        flushing_.store(false);
+
+        // Someone lost the election meanwhile - take their record too,
+        // unless Serial is the bottleneck
+        if (stalled || !drainPending_.load()) return true;
+    }
+}
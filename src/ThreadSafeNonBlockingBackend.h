@@ -25,22 +25,33 @@
 #pragma once
 
 #include "ILogBackend.h"
-#include <Arduino.h>
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
+#include "LogRingBuffer.h"
+#include "LogPlatform.h"
 #include <atomic>
-#include <cstring>
 #include <inttypes.h>
 
+#ifndef CONFIG_LOG_TSNB_BUFFER_SIZE
+#define CONFIG_LOG_TSNB_BUFFER_SIZE 2048  // Shared staging ring (bytes, power of two)
+#endif
+
 /**
  * @brief Thread-safe non-blocking console backend
  *
  * Combines the best features of SynchronizedConsoleBackend and NonBlockingConsoleBackend:
- * - Thread-safe: Uses mutex to prevent message interleaving
- * - Non-blocking: Never waits for mutex or serial buffer
- * - Drops messages rather than blocking the calling task
+ * - Thread-safe: messages are never interleaved
+ * - Non-blocking: never waits for a lock or the serial buffer
+ * - Drops messages only when the staging ring is full
  * - Tracks statistics for monitoring dropped messages
  *
+ * write() reserves space in a shared lock-free ring (LogRingBuffer) and
+ * copies the message straight in - no stack copy, no length limit beyond
+ * the ring size. The writer that wins the flusher election then moves
+ * records from the ring to Serial while there is room (a record may go out
+ * in pieces, but only the flusher writes, so nothing interleaves); writers
+ * that lose the election leave their message for the flusher, so contention
+ * is not loss. Bytes that do not fit the serial buffer yet go out with the
+ * next write() or flush().
+ *
  * This is the recommended backend for production systems with multiple logging tasks.
  *
  * Usage:
@@ -49,99 +60,45 @@
  */
 class ThreadSafeNonBlockingBackend : public ILogBackend {
 private:
-    static std::atomic<SemaphoreHandle_t> writeMutex_;
-    static std::atomic<bool> mutexInitialized_;
+    // Shared by all instances - there is only one Serial
+    static LogRingBuffer ring_;
+    static std::atomic<uint8_t> ringState_;   // 0 = none, 1 = initializing, 2 = ready
+    static std::atomic<bool> flushing_;       // Elected flusher holds this
+    static std::atomic<bool> drainPending_;   // Set before each election, cleared by the winner
+    static size_t headSent_;                  // Bytes of the oldest record already sent (flusher only)
 
     // Atomic counters for statistics (lock-free)
+    std::atomic<uint32_t> writtenMessages_{0};
     std::atomic<uint32_t> droppedMessages_{0};
     std::atomic<uint32_t> droppedBytes_{0};
-    std::atomic<uint32_t> mutexContention_{0};  // Times mutex was unavailable
-    std::atomic<uint32_t> bufferFull_{0};        // Times buffer was too full
-
-    // Configuration - reduced buffer size to save stack space
-    static constexpr size_t LOCAL_BUFFER_SIZE = 128;   // Reduced from 256 for stack safety
-    static constexpr size_t MIN_BUFFER_SPACE = 20;     // Minimum serial buffer space needed
-    static constexpr TickType_t MUTEX_TIMEOUT = 0;     // Zero timeout = non-blocking
-
-    static void ensureMutexInitialized() {
-        // Double-checked locking with atomic to prevent race condition
-        if (!mutexInitialized_.load(std::memory_order_acquire)) {
-            SemaphoreHandle_t newMutex = xSemaphoreCreateMutex();
-            if (newMutex) {
-                // Try to set writeMutex_ atomically using std::atomic
-                SemaphoreHandle_t expected = nullptr;
-                if (writeMutex_.compare_exchange_strong(expected, newMutex,
-                                                         std::memory_order_seq_cst,
-                                                         std::memory_order_seq_cst)) {
-                    mutexInitialized_.store(true, std::memory_order_release);
-                } else {
-                    // Another thread won the race, delete our mutex
-                    vSemaphoreDelete(newMutex);
-                }
-            }
-        }
-    }
+    std::atomic<uint32_t> mutexContention_{0};  // Writers that handed their message to another flusher
+    std::atomic<uint32_t> bufferFull_{0};        // Times the staging ring was too full
+
+    static void ensureRingInitialized();
+    static bool drain();
 
 public:
     ThreadSafeNonBlockingBackend() {
-        ensureMutexInitialized();
+        ensureRingInitialized();
     }
 
     void write(const std::string& logMessage) override {
         write(logMessage.c_str(), logMessage.length());
     }
 
-    void write(const char* logMessage, size_t length) override {
-        if (!mutexInitialized_.load() || !logMessage || length == 0) return;
-
-        SemaphoreHandle_t mutex = writeMutex_.load();
-        if (!mutex) return;
-
-        // Copy message to local buffer first (ensures atomic composition)
-        char localBuffer[LOCAL_BUFFER_SIZE];
-        size_t copyLen = (length < LOCAL_BUFFER_SIZE - 1) ? length : LOCAL_BUFFER_SIZE - 1;
-        memcpy(localBuffer, logMessage, copyLen);
-        localBuffer[copyLen] = '\0';
-
-        // Try to acquire mutex without blocking
-        if (xSemaphoreTake(mutex, MUTEX_TIMEOUT) != pdTRUE) {
-            // Mutex busy - drop message rather than wait
-            droppedMessages_.fetch_add(1, std::memory_order_relaxed);
-            droppedBytes_.fetch_add(length, std::memory_order_relaxed);
-            mutexContention_.fetch_add(1, std::memory_order_relaxed);
-            return;
-        }
-
-        // Got mutex - check buffer space
-        size_t available = Serial.availableForWrite();
-        if (available < MIN_BUFFER_SPACE) {
-            // Buffer too full - drop rather than block
-            xSemaphoreGive(mutex);
-            droppedMessages_.fetch_add(1, std::memory_order_relaxed);
-            droppedBytes_.fetch_add(length, std::memory_order_relaxed);
-            bufferFull_.fetch_add(1, std::memory_order_relaxed);
-            return;
-        }
-
-        // Write what fits
-        size_t toWrite = (copyLen < available) ? copyLen : available;
-        Serial.write(localBuffer, toWrite);
-
-        // Track partial writes
-        if (toWrite < length) {
-            droppedBytes_.fetch_add(length - toWrite, std::memory_order_relaxed);
-        }
-
-        xSemaphoreGive(mutex);
-    }
+    void write(const char* logMessage, size_t length) override;
 
     void flush() override {
-        // NEVER call Serial.flush() - it blocks!
-        // This is intentionally empty
+        // NEVER call Serial.flush() - it blocks! Only push out what fits now
+        drain();
     }
 
     // Statistics getters
-    uint32_t getDroppedMessages() const {
+    uint32_t getWrittenMessages() const {
+        return writtenMessages_.load(std::memory_order_relaxed);
+    }
+
+    uint32_t getDroppedMessages() const override {
         return droppedMessages_.load(std::memory_order_relaxed);
     }
 
@@ -149,6 +106,7 @@ public:
         return droppedBytes_.load(std::memory_order_relaxed);
     }
 
+    // Contended writes - these are delivered by the flusher, not dropped
     uint32_t getMutexContentionCount() const {
         return mutexContention_.load(std::memory_order_relaxed);
     }
@@ -157,7 +115,13 @@ public:
         return bufferFull_.load(std::memory_order_relaxed);
     }
 
+    // Bytes staged but not yet handed to Serial
+    size_t getQueuedBytes() const {
+        return ring_.used();
+    }
+
     void resetStats() {
+        writtenMessages_.store(0, std::memory_order_relaxed);
         droppedMessages_.store(0, std::memory_order_relaxed);
         droppedBytes_.store(0, std::memory_order_relaxed);
         mutexContention_.store(0, std::memory_order_relaxed);
@@ -172,13 +136,15 @@ public:
 
     // Print statistics (use carefully - direct Serial access)
     void printStats() {
-        Serial.printf("\r\n=== ThreadSafeNonBlockingBackend Stats ===\r\n");
-        Serial.printf("Dropped messages: %" PRIu32 "\r\n", getDroppedMessages());
-        Serial.printf("Dropped bytes: %" PRIu32 "\r\n", getDroppedBytes());
-        Serial.printf("Mutex contention: %" PRIu32 "\r\n", getMutexContentionCount());
-        Serial.printf("Buffer full events: %" PRIu32 "\r\n", getBufferFullCount());
-        Serial.printf("Buffer available: %u bytes\r\n", (unsigned int)Serial.availableForWrite());
-        Serial.printf("==========================================\r\n");
+        LogPlatform::consolePrintf("\r\n=== ThreadSafeNonBlockingBackend Stats ===\r\n");
+        LogPlatform::consolePrintf("Written messages: %" PRIu32 "\r\n", getWrittenMessages());
+        LogPlatform::consolePrintf("Dropped messages: %" PRIu32 "\r\n", getDroppedMessages());
+        LogPlatform::consolePrintf("Dropped bytes: %" PRIu32 "\r\n", getDroppedBytes());
+        LogPlatform::consolePrintf("Contended writes: %" PRIu32 "\r\n", getMutexContentionCount());
+        LogPlatform::consolePrintf("Buffer full events: %" PRIu32 "\r\n", getBufferFullCount());
+        LogPlatform::consolePrintf("Staged bytes: %u\r\n", (unsigned int)getQueuedBytes());
+        LogPlatform::consolePrintf("Buffer available: %u bytes\r\n", (unsigned int)LogPlatform::consoleAvailableForWrite());
+        LogPlatform::consolePrintf("==========================================\r\n");
     }
 };
 
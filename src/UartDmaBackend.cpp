@@ -0,0 +1,101 @@
+/*
+ * UartDmaBackend.cpp - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+
+// UartDmaBackend.cpp
+// Needs the ESP-IDF UART driver: not part of the native build (LogPlatform.h)
+#if !defined(LOG_PLATFORM_NATIVE)
+
+#include "UartDmaBackend.h"
+#include "LoggerConfig.h"
+
+// IDF 5.0 added uart_get_tx_buffer_free_size(); before that a full ring blocks
+#if defined(ESP_IDF_VERSION) && ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+#define UART_DMA_HAS_FREE_SIZE 1
+#else
+#define UART_DMA_HAS_FREE_SIZE 0
+#endif
+
+bool UartDmaBackend::begin() {
+    if (installed_) return true;
+
+    // Serial.begin() installs the driver with a small TX buffer; replace it
+    if (uart_is_driver_installed(config_.port)) {
+        uart_wait_tx_done(config_.port, pdMS_TO_TICKS(LoggerConfig::MUTEX_STANDARD_TIMEOUT_MS));
+        uart_driver_delete(config_.port);
+    }
+
+    if (uart_driver_install(config_.port, CONFIG_LOG_UART_RX_BUFFER_SIZE,
+                            static_cast<int>(config_.txBufferSize), 0, nullptr, 0) != ESP_OK) {
+        return false;
+    }
+
+    if (config_.baudRate > 0) {
+        uart_set_baudrate(config_.port, config_.baudRate);
+    }
+    if (config_.txPin != UART_PIN_NO_CHANGE || config_.rxPin != UART_PIN_NO_CHANGE) {
+        uart_set_pin(config_.port, config_.txPin, config_.rxPin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    }
+
+    installed_ = true;
+    return true;
+}
+
+size_t UartDmaBackend::getFreeBuffer() const {
+#if UART_DMA_HAS_FREE_SIZE
+    size_t freeSize = 0;
+    if (installed_ && uart_get_tx_buffer_free_size(config_.port, &freeSize) == ESP_OK) {
+        return freeSize;
+    }
+#endif
+    return 0;
+}
+
+void UartDmaBackend::write(const char* logMessage, size_t length) {
+    if (!logMessage || length == 0) return;
+    if (!installed_) {
+        drop(length);
+        return;
+    }
+
+#if UART_DMA_HAS_FREE_SIZE
+    // Whole message or nothing; two racing writers can at worst wait briefly
+    if (getFreeBuffer() < length) {
+        drop(length);
+        return;
+    }
+#endif
+
+    // The driver holds its TX lock for the whole call, so messages never interleave
+    if (uart_write_bytes(config_.port, logMessage, length) < 0) {
+        drop(length);
+        return;
+    }
+    writtenMessages_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void UartDmaBackend::flush() {
+    if (installed_) {
+        uart_wait_tx_done(config_.port, pdMS_TO_TICKS(LoggerConfig::MUTEX_STANDARD_TIMEOUT_MS));
+    }
+}
+
+#endif  // !LOG_PLATFORM_NATIVE
@@ -0,0 +1,130 @@
+/*
+ * UartDmaBackend.h - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+
+// UartDmaBackend.h
+// Console output through the IDF UART driver's large TX ring buffer
+#pragma once
+
+#include "ILogBackend.h"
+#include <driver/uart.h>
+#include <esp_idf_version.h>
+#include <atomic>
+
+#ifndef CONFIG_LOG_UART_TX_BUFFER_SIZE
+#define CONFIG_LOG_UART_TX_BUFFER_SIZE 8192  // Driver TX ring buffer (bytes)
+#endif
+
+#ifndef CONFIG_LOG_UART_RX_BUFFER_SIZE
+#define CONFIG_LOG_UART_RX_BUFFER_SIZE 256   // Driver RX buffer (minimum the driver accepts)
+#endif
+
+/**
+ * @brief Non-blocking console backend backed by the IDF UART driver
+ *
+ * NonBlockingConsoleBackend and ThreadSafeNonBlockingBackend are limited by
+ * the Serial TX buffer: once it is full they truncate or drop. This backend
+ * (re)installs the IDF UART driver with a large TX ring buffer and hands each
+ * message to it with uart_write_bytes(); the UART interrupt drains the ring in
+ * the background, so callers only pay for a memcpy.
+ *
+ * Messages are written whole or dropped whole - never truncated. On IDF 5.x
+ * free ring space is checked first so write() never waits. IDF 4.x has no
+ * way to query it, so a full ring makes the caller wait for space there;
+ * size the ring for your bursts.
+ *
+ * Serial on the same port keeps working (it writes through the same driver).
+ * Not for use from ISRs.
+ *
+ * Usage:
+ *   auto uart = std::make_shared<UartDmaBackend>();   // UART0, 8 KB ring
+ *   uart->begin();
+ *   logger.setBackend(uart);
+ */
+class UartDmaBackend : public ILogBackend {
+public:
+    struct Config {
+        uart_port_t port = UART_NUM_0;
+        size_t txBufferSize = CONFIG_LOG_UART_TX_BUFFER_SIZE;
+        uint32_t baudRate = 0;       // 0 = keep the current baud rate
+        int txPin = UART_PIN_NO_CHANGE;
+        int rxPin = UART_PIN_NO_CHANGE;
+    };
+
+    UartDmaBackend() : UartDmaBackend(Config()) {}
+    explicit UartDmaBackend(const Config& config) : config_(config) {}
+    // The driver stays installed on destruction - Serial may still use it
+
+    UartDmaBackend(const UartDmaBackend&) = delete;
+    UartDmaBackend& operator=(const UartDmaBackend&) = delete;
+
+    /**
+     * @brief Install the UART driver with the configured TX ring
+     *
+     * Replaces a driver installed by Serial.begin() on the same port, keeping
+     * its line settings unless baudRate/pins are given.
+     *
+     * @return true if the driver is installed
+     */
+    bool begin();
+
+    bool isInstalled() const { return installed_; }
+
+    void write(const std::string& logMessage) override {
+        write(logMessage.c_str(), logMessage.length());
+    }
+    void write(const char* logMessage, size_t length) override;
+
+    /**
+     * @brief Wait (bounded) until the ring and FIFO are empty
+     * @note Waits at most LoggerConfig::MUTEX_STANDARD_TIMEOUT_MS
+     */
+    void flush() override;
+
+    // Statistics getters
+    uint32_t getWrittenMessages() const { return writtenMessages_.load(std::memory_order_relaxed); }
+    uint32_t getDroppedMessages() const override { return droppedMessages_.load(std::memory_order_relaxed); }
+    uint32_t getDroppedBytes() const { return droppedBytes_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Free bytes in the TX ring (0 if unknown or not installed)
+     */
+    size_t getFreeBuffer() const;
+
+    void resetStats() {
+        writtenMessages_.store(0);
+        droppedMessages_.store(0);
+        droppedBytes_.store(0);
+    }
+
+private:
+    void drop(size_t length) {
+        droppedMessages_.fetch_add(1, std::memory_order_relaxed);
+        droppedBytes_.fetch_add(length, std::memory_order_relaxed);
+    }
+
+    Config config_;
+    bool installed_ = false;
+
+    std::atomic<uint32_t> writtenMessages_{0};
+    std::atomic<uint32_t> droppedMessages_{0};
+    std::atomic<uint32_t> droppedBytes_{0};
+};
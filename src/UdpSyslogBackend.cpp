@@ -0,0 +1,184 @@
+/*
+ * UdpSyslogBackend.cpp - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+
+// UdpSyslogBackend.cpp
+// Needs lwIP: not part of the native build (LogPlatform.h)
+#if !defined(LOG_PLATFORM_NATIVE)
+
+#include "UdpSyslogBackend.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <lwip/netdb.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+// Records per LINES datagram; the iovecs live on the caller's stack
+static constexpr size_t MAX_LINES_PER_DATAGRAM = 16;
+
+// Room for "<PRI>1 - hostname app-name - - - "
+static constexpr size_t SYSLOG_HEADER_SIZE = 96;
+
+UdpSyslogBackend::~UdpSyslogBackend() {
+    if (socket_ >= 0) close(socket_);
+}
+
+bool UdpSyslogBackend::begin() {
+    if (socket_ >= 0) return true;
+    if (!config_.host) return false;
+
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    struct addrinfo* result = nullptr;
+    if (getaddrinfo(config_.host, nullptr, &hints, &result) != 0 || !result) return false;
+    memcpy(&destination_, result->ai_addr, sizeof(destination_));
+    freeaddrinfo(result);
+    destination_.sin_port = htons(config_.port);
+
+    socket_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    return socket_ >= 0;
+}
+
+// Errors that mean "the stack is out of buffers", not "the network is gone"
+static bool isCongestion(int error) {
+    return error == ENOMEM || error == ENOBUFS || error == EAGAIN || error == EWOULDBLOCK;
+}
+
+bool UdpSyslogBackend::send(struct iovec* iov, size_t iovCount, size_t records) {
+    struct msghdr message = {};
+    message.msg_name = &destination_;
+    message.msg_namelen = sizeof(destination_);
+    message.msg_iov = iov;
+    message.msg_iovlen = iovCount;
+
+    for (int attempt = 0;; attempt++) {
+        if (sendmsg(socket_, &message, MSG_DONTWAIT) >= 0) {
+            sentDatagrams_.fetch_add(1, std::memory_order_relaxed);
+            backoffMs_.store(0, std::memory_order_relaxed);
+            return true;
+        }
+        if (!isCongestion(errno) || attempt >= CONFIG_LOG_UDP_RETRIES) break;
+
+        // Let the TX queue drain, longer each time it is still full
+        uint32_t wait = backoffMs_.load(std::memory_order_relaxed);
+        wait = wait ? std::min<uint32_t>(wait * 2, CONFIG_LOG_UDP_MAX_BACKOFF_MS) : CONFIG_LOG_UDP_BACKOFF_MS;
+        backoffMs_.store(wait, std::memory_order_relaxed);
+        backoffs_.fetch_add(1, std::memory_order_relaxed);
+        vTaskDelay(pdMS_TO_TICKS(wait));
+    }
+
+    droppedDatagrams_.fetch_add(1, std::memory_order_relaxed);
+    droppedMessages_.fetch_add(records, std::memory_order_relaxed);
+    return false;
+}
+
+void UdpSyslogBackend::writeBatch(const LogRecordView* records, size_t count) {
+    if (!records || count == 0) return;
+    if (socket_ < 0) {
+        droppedMessages_.fetch_add(count, std::memory_order_relaxed);
+        return;
+    }
+
+    if (config_.format == Format::SYSLOG) {
+        writeSyslog(records, count);
+    } else {
+        writeLines(records, count);
+    }
+}
+
+void UdpSyslogBackend::writeLines(const LogRecordView* records, size_t count) {
+    struct iovec iov[MAX_LINES_PER_DATAGRAM];
+    size_t lines = 0;
+    size_t bytes = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        if (!records[i].data || records[i].length == 0) continue;
+
+        // A record longer than a datagram is cut; everything else goes out whole
+        size_t length = std::min(records[i].length, config_.maxDatagram);
+        if (lines == MAX_LINES_PER_DATAGRAM || (lines > 0 && bytes + length > config_.maxDatagram)) {
+            send(iov, lines, lines);
+            lines = 0;
+            bytes = 0;
+        }
+        iov[lines].iov_base = const_cast<char*>(records[i].data);
+        iov[lines].iov_len = length;
+        lines++;
+        bytes += length;
+    }
+    if (lines > 0) send(iov, lines, lines);
+}
+
+unsigned UdpSyslogBackend::severityOf(const char* text, size_t length) {
+    char letter = 0;
+    if (length > 2 && text[1] == ' ' && text[2] == '(') {
+        letter = text[0];
+    } else {
+        // Match the level field by shape, not position: the time field is
+        // optional (Envelope::Time::NONE) and task names may contain '['
+        static constexpr size_t SCAN_LIMIT = 96;  // Time, delta and task fields fit well inside
+        for (size_t i = 0; i + 4 < length && i < SCAN_LIMIT; i++) {
+            if (text[i] == ']' && text[i + 1] == '[' && text[i + 3] == ']' && text[i + 4] == ' ' &&
+                memchr("EWIDV", text[i + 2], 5)) {
+                letter = text[i + 2];
+                break;
+            }
+        }
+    }
+
+    switch (letter) {
+        case 'E': return 3;  // Error
+        case 'W': return 4;  // Warning
+        case 'D':
+        case 'V': return 7;  // Debug
+        default:  return 6;  // Informational
+    }
+}
+
+void UdpSyslogBackend::writeSyslog(const LogRecordView* records, size_t count) {
+    char header[SYSLOG_HEADER_SIZE];
+    struct iovec iov[2];
+
+    for (size_t i = 0; i < count; i++) {
+        const char* text = records[i].data;
+        size_t length = records[i].length;
+        if (!text || length == 0) continue;
+        while (length > 0 && (text[length - 1] == '\n' || text[length - 1] == '\r')) length--;
+
+        // RFC 5424 with NILVALUE timestamp: the collector stamps receipt time
+        unsigned priority = config_.facility * 8u + severityOf(text, length);
+        int headerLength = snprintf(header, sizeof(header), "<%u>1 - %s %s - - - ", priority,
+                                    config_.hostname ? config_.hostname : "-", config_.appName ? config_.appName : "-");
+        if (headerLength < 0) continue;
+        size_t used = std::min<size_t>(headerLength, sizeof(header) - 1);
+
+        iov[0].iov_base = header;
+        iov[0].iov_len = used;
+        iov[1].iov_base = const_cast<char*>(text);
+        iov[1].iov_len = std::min(length, config_.maxDatagram > used ? config_.maxDatagram - used : 0);
+        send(iov, 2, 1);
+    }
+}
+
+#endif  // !LOG_PLATFORM_NATIVE
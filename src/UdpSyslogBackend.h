@@ -0,0 +1,155 @@
+/*
+ * UdpSyslogBackend.h - part of the ESP32-Logger library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+
+// UdpSyslogBackend.h
+// Log datagrams (RFC 5424 syslog or packed lines) sent straight from ring records
+#pragma once
+
+#include "ILogBackend.h"
+#include <lwip/sockets.h>
+#include <atomic>
+
+#ifndef CONFIG_LOG_UDP_MAX_DATAGRAM
+#define CONFIG_LOG_UDP_MAX_DATAGRAM 1472  // Ethernet/WiFi MTU minus IP and UDP headers
+#endif
+
+#ifndef CONFIG_LOG_UDP_BACKOFF_MS
+#define CONFIG_LOG_UDP_BACKOFF_MS 20      // First wait after the stack runs out of buffers
+#endif
+
+#ifndef CONFIG_LOG_UDP_MAX_BACKOFF_MS
+#define CONFIG_LOG_UDP_MAX_BACKOFF_MS 500 // Backoff doubles up to this while congested
+#endif
+
+#ifndef CONFIG_LOG_UDP_RETRIES
+#define CONFIG_LOG_UDP_RETRIES 2          // Retries per datagram before it is dropped
+#endif
+
+/**
+ * @brief Backend that ships log records off-device over UDP
+ *
+ * Meant to sit behind an AsyncRingBackend (Logger::addIsolatedBackend()):
+ * writeBatch() receives records still in the ring and hands them to lwIP
+ * with sendmsg() and one iovec per record, so the only copy is into the
+ * outgoing pbuf - no subscriber message, queue or staging buffer.
+ *
+ * Formats:
+ * - LINES:  records packed back to back up to maxDatagram bytes per datagram
+ *           (read with `nc -ul 514` or any line-based collector)
+ * - SYSLOG: one RFC 5424 message per datagram (RFC 5426), severity taken
+ *           from the "[L]" field of the Logger's envelope
+ *
+ * Sends never block. When the stack reports congestion (ENOMEM, ENOBUFS,
+ * EAGAIN - typically a full WiFi TX queue) the calling task waits
+ * CONFIG_LOG_UDP_BACKOFF_MS, doubling up to CONFIG_LOG_UDP_MAX_BACKOFF_MS,
+ * and retries; after CONFIG_LOG_UDP_RETRIES the datagram is dropped and
+ * counted. Those waits happen on the drain task, never on logging tasks,
+ * as long as the backend is wrapped. Pair with AsyncRingBackend::Config::
+ * batchDelayMs to collect fuller datagrams.
+ *
+ * Usage:
+ *   UdpSyslogBackend::Config cfg;
+ *   cfg.host = "192.168.1.10";
+ *   auto udp = std::make_shared<UdpSyslogBackend>(cfg);
+ *   if (udp->begin()) logger.addIsolatedBackend(udp);   // After WiFi is up
+ */
+class UdpSyslogBackend : public ILogBackend {
+public:
+    enum class Format : uint8_t {
+        LINES,
+        SYSLOG
+    };
+
+    struct Config {
+        const char* host = nullptr;           // IPv4 address or host name
+        uint16_t port = 514;
+        Format format = Format::LINES;
+        size_t maxDatagram = CONFIG_LOG_UDP_MAX_DATAGRAM;
+        // SYSLOG only
+        uint8_t facility = 16;                // local0
+        const char* hostname = "esp32";
+        const char* appName = "logger";
+    };
+
+    explicit UdpSyslogBackend(const Config& config) : config_(config) {}
+    ~UdpSyslogBackend() override;
+
+    UdpSyslogBackend(const UdpSyslogBackend&) = delete;
+    UdpSyslogBackend& operator=(const UdpSyslogBackend&) = delete;
+
+    /**
+     * @brief Resolve the host and open the socket
+     * @return true if datagrams can be sent
+     * @note Resolving a host name may block on DNS - call it from setup code
+     */
+    bool begin();
+
+    bool isReady() const { return socket_ >= 0; }
+
+    void write(const std::string& logMessage) override {
+        write(logMessage.c_str(), logMessage.length());
+    }
+    void write(const char* logMessage, size_t length) override {
+        LogRecordView record = {logMessage, length};
+        writeBatch(&record, 1);
+    }
+    void writeBatch(const LogRecordView* records, size_t count) override;
+
+    // Datagrams leave on sendmsg(); nothing is buffered here
+    void flush() override {}
+
+    // Statistics getters
+    uint32_t getSentDatagrams() const { return sentDatagrams_.load(std::memory_order_relaxed); }
+    uint32_t getDroppedDatagrams() const { return droppedDatagrams_.load(std::memory_order_relaxed); }
+    uint32_t getDroppedMessages() const override { return droppedMessages_.load(std::memory_order_relaxed); }
+    uint32_t getBackoffCount() const { return backoffs_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Syslog severity (3 error .. 7 debug) of one formatted line
+     * @param text Line with the Logger's envelope ("[time][task][L] tag: ",
+     *             time field optional) or IDF's "L (time) tag: "
+     * @return 6 (informational) when no level field is found
+     */
+    static unsigned severityOf(const char* text, size_t length);
+
+    void resetStats() {
+        sentDatagrams_.store(0);
+        droppedDatagrams_.store(0);
+        droppedMessages_.store(0);
+        backoffs_.store(0);
+    }
+
+private:
+    bool send(struct iovec* iov, size_t iovCount, size_t records);
+    void writeLines(const LogRecordView* records, size_t count);
+    void writeSyslog(const LogRecordView* records, size_t count);
+
+    Config config_;
+    int socket_ = -1;
+    struct sockaddr_in destination_ = {};
+    std::atomic<uint32_t> backoffMs_{0};  // Current congestion wait, 0 = not congested
+
+    std::atomic<uint32_t> sentDatagrams_{0};
+    std::atomic<uint32_t> droppedDatagrams_{0};
+    std::atomic<uint32_t> droppedMessages_{0};
+    std::atomic<uint32_t> backoffs_{0};
+};
@@ -0,0 +1,240 @@
+/**
+ * @file test_benchmark.cpp
+ * @brief On-device throughput / latency benchmarks for Logger
+ *
+ * Built only by the esp32-benchmark env (LOG_BENCHMARK). Every result is one
+ * line "BENCH {json}" on the console, so runs can be captured with
+ *   pio test -e esp32-benchmark | grep '^BENCH ' > bench-<version>.jsonl
+ * and compared release to release. Cycle counts are CPU cycles at
+ * getCpuFrequencyMhz() MHz.
+ */
+
+#if defined(UNIT_TEST) && defined(LOG_BENCHMARK)
+
+#include <Arduino.h>
+#include <unity.h>
+#include <Logger.h>
+#include <NonBlockingConsoleBackend.h>
+#include <ThreadSafeNonBlockingBackend.h>
+#include <AsyncRingBackend.h>
+#include <algorithm>
+#include <vector>
+
+#define BENCH_CALLS 2000           // Calls per cycles-per-call measurement
+#define BENCH_LATENCY_SAMPLES 200  // Calls per task in the latency sweep
+#define BENCH_MAX_TASKS 20
+#define BENCH_THROUGHPUT_MS 1000   // Length of each throughput run
+
+// Accepts everything, does nothing: measures the logger, not a sink
+class NullBackend : public ILogBackend {
+public:
+    std::atomic<uint32_t> writes{0};
+
+    void write(const std::string& message) override { writes++; }
+    void write(const char* message, size_t length) override { writes++; }
+    void flush() override {}
+};
+
+static Logger& logger = Logger::getInstance();
+static std::shared_ptr<NullBackend> nullBackend;
+
+static void printResult(const char* name, const char* fields) {
+    // Own line, even if a console backend left a partial one
+    Serial.printf("\r\nBENCH {\"name\":\"%s\",%s}\r\n", name, fields);
+}
+
+void setUp() {
+    if (!nullBackend) nullBackend = std::make_shared<NullBackend>();
+    logger.setBackend(nullBackend);
+    logger.setLogLevel(ESP_LOG_INFO);
+    logger.setMaxLogsPerSecond(0);
+}
+
+void tearDown() {}
+
+// ============= Cycles per call =============
+
+static uint32_t cyclesPerCall(esp_log_level_t level) {
+    uint32_t start = ESP.getCycleCount();
+    for (int i = 0; i < BENCH_CALLS; i++) {
+        logger.log(level, "BENCH", "value %d of %s", i, "bench");
+    }
+    return (ESP.getCycleCount() - start) / BENCH_CALLS;
+}
+
+void test_cycles_per_call() {
+    char fields[96];
+
+    uint32_t filtered = cyclesPerCall(ESP_LOG_DEBUG);
+    snprintf(fields, sizeof(fields), "\"cycles\":%u", (unsigned)filtered);
+    printResult("filtered_out", fields);
+
+    uint32_t toNull = cyclesPerCall(ESP_LOG_INFO);
+    snprintf(fields, sizeof(fields), "\"cycles\":%u", (unsigned)toNull);
+    printResult("enabled_null_backend", fields);
+
+    auto console = std::make_shared<NonBlockingConsoleBackend>();
+    logger.setBackend(console);
+    Serial.flush();
+    uint32_t toConsole = cyclesPerCall(ESP_LOG_INFO);
+    Serial.flush();
+    snprintf(fields, sizeof(fields), "\"cycles\":%u,\"dropped\":%u", (unsigned)toConsole,
+             (unsigned)console->getDroppedMessages());
+    printResult("enabled_non_blocking_console", fields);
+
+    TEST_ASSERT_TRUE(filtered < toNull);
+}
+
+// ============= Latency vs. task count =============
+
+static uint32_t latencySamples[BENCH_MAX_TASKS][BENCH_LATENCY_SAMPLES];
+static SemaphoreHandle_t startGate = nullptr;
+static std::atomic<int> tasksDone{0};
+
+static void latencyTask(void* param) {
+    uint32_t* samples = latencySamples[(int)(intptr_t)param];
+    xSemaphoreTake(startGate, portMAX_DELAY);
+    xSemaphoreGive(startGate);  // Release the next task at once
+
+    for (int i = 0; i < BENCH_LATENCY_SAMPLES; i++) {
+        uint32_t start = ESP.getCycleCount();
+        logger.log(ESP_LOG_INFO, "BENCH", "latency %d", i);
+        samples[i] = ESP.getCycleCount() - start;
+        if ((i & 15) == 0) vTaskDelay(1);  // Let the other tasks interleave
+    }
+
+    tasksDone++;
+    vTaskDelete(NULL);
+}
+
+void test_latency_scaling() {
+    static const int TASK_COUNTS[] = {1, 2, 4, 8, 12, 16, 20};
+    std::vector<uint32_t> all;
+    all.reserve(BENCH_MAX_TASKS * BENCH_LATENCY_SAMPLES);
+
+    for (int tasks : TASK_COUNTS) {
+        tasksDone = 0;
+        startGate = xSemaphoreCreateBinary();
+
+        // Alternate the cores so both are logging at once
+        for (int t = 0; t < tasks; t++) {
+            xTaskCreatePinnedToCore(latencyTask, "Bench", 4096, (void*)(intptr_t)t, 1, NULL, t & 1);
+        }
+        xSemaphoreGive(startGate);
+
+        unsigned long start = millis();
+        while (tasksDone < tasks && (millis() - start) < 30000) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+        TEST_ASSERT_EQUAL(tasks, tasksDone.load());
+        vSemaphoreDelete(startGate);
+
+        all.clear();
+        for (int t = 0; t < tasks; t++) {
+            all.insert(all.end(), latencySamples[t], latencySamples[t] + BENCH_LATENCY_SAMPLES);
+        }
+        std::sort(all.begin(), all.end());
+
+        char fields[128];
+        snprintf(fields, sizeof(fields), "\"tasks\":%d,\"p50_cycles\":%u,\"p99_cycles\":%u,\"max_cycles\":%u",
+                 tasks, (unsigned)all[all.size() / 2], (unsigned)all[all.size() * 99 / 100],
+                 (unsigned)all.back());
+        printResult("latency", fields);
+    }
+}
+
+// ============= Sustained throughput per backend =============
+
+static void measureThroughput(const char* backendName, std::shared_ptr<ILogBackend> backend) {
+    logger.setBackend(backend);
+    uint32_t droppedBefore = backend->getDroppedMessages();
+
+    uint32_t calls = 0;
+    unsigned long start = millis();
+    while (millis() - start < BENCH_THROUGHPUT_MS) {
+        logger.log(ESP_LOG_INFO, "BENCH", "throughput message %u with some payload", (unsigned)calls);
+        calls++;
+    }
+    logger.flush();
+    unsigned long elapsed = millis() - start;
+
+    uint32_t dropped = backend->getDroppedMessages() - droppedBefore;
+    uint32_t delivered = calls - dropped;
+
+    char fields[160];
+    snprintf(fields, sizeof(fields), "\"backend\":\"%s\",\"calls_per_s\":%u,\"delivered_per_s\":%u,\"dropped\":%u",
+             backendName, (unsigned)(calls * 1000ULL / elapsed), (unsigned)(delivered * 1000ULL / elapsed),
+             (unsigned)dropped);
+    printResult("throughput", fields);
+}
+
+void test_backend_throughput() {
+    measureThroughput("null", nullBackend);
+    measureThroughput("non_blocking_console", std::make_shared<NonBlockingConsoleBackend>());
+    measureThroughput("thread_safe_non_blocking", std::make_shared<ThreadSafeNonBlockingBackend>());
+
+    auto ring = std::make_shared<AsyncRingBackend>(std::make_shared<NullBackend>());
+    TEST_ASSERT_TRUE(ring->start());
+    measureThroughput("async_ring_null", ring);
+    logger.setBackend(nullBackend);
+    ring->stop();
+}
+
+// ============= Worst-case stack depth =============
+
+static const uint32_t STACK_TASK_SIZE = 8192;
+static std::atomic<uint32_t> stackUsed{0};
+
+static void stackTask(void* param) {
+    // Every front-end, with the widest argument lists the paths see
+    const uint8_t payload[64] = {0};
+    logger.log(ESP_LOG_INFO, "BENCH", "%d %u %ld %lu %s %c %x %p %08.3f %lld",
+               -1, 2u, 3L, 4UL, "five", '6', 7, (void*)8, 9.0, 10LL);
+    logger.info("BENCH", "typed {} {} {:x} {:.2} {}", 1, "two", 3u, 4.5, true);
+    logger.logHex(ESP_LOG_INFO, "BENCH", payload, sizeof(payload), "payload");
+    logger.logDirect(ESP_LOG_INFO, "BENCH", "direct");
+
+    stackUsed = STACK_TASK_SIZE - uxTaskGetStackHighWaterMark(NULL);  // Bytes on ESP-IDF
+    tasksDone++;
+    vTaskDelete(NULL);
+}
+
+void test_stack_depth() {
+    auto console = std::make_shared<NonBlockingConsoleBackend>();
+    logger.setBackend(console);
+    tasksDone = 0;
+
+    xTaskCreate(stackTask, "BenchStk", STACK_TASK_SIZE, NULL, 1, NULL);
+    unsigned long start = millis();
+    while (tasksDone < 1 && (millis() - start) < 5000) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    TEST_ASSERT_EQUAL(1, tasksDone.load());
+    Serial.flush();
+
+    char fields[64];
+    snprintf(fields, sizeof(fields), "\"stack_bytes\":%u", (unsigned)stackUsed.load());
+    printResult("stack_depth", fields);
+}
+
+void setup() {
+    delay(2000);
+    Serial.begin(115200);
+    Serial.println("\n=== Logger Benchmarks ===\n");
+
+    char fields[96];
+    snprintf(fields, sizeof(fields), "\"cpu_mhz\":%u,\"idf\":\"%s\"", (unsigned)getCpuFrequencyMhz(),
+             esp_get_idf_version());
+    printResult("meta", fields);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_cycles_per_call);
+    RUN_TEST(test_latency_scaling);
+    RUN_TEST(test_backend_throughput);
+    RUN_TEST(test_stack_depth);
+    UNITY_END();
+}
+
+void loop() {}
+
+#endif // UNIT_TEST && LOG_BENCHMARK
@@ -8,6 +8,10 @@
 #include <Arduino.h>
 #include <unity.h>
 #include <Logger.h>
+#include <BinarySerialBackend.h>
+#include <AsyncRingBackend.h>
+#include <RtcTailBackend.h>
+#include <UdpSyslogBackend.h>
 #include <vector>
 #include <string>
 
@@ -15,13 +19,10 @@
 class TestLogBackend : public ILogBackend {
 public:
     std::vector<std::string> messages;
-    bool writeResult = true;
 
-    bool write(const char* message, size_t length) override {
-        if (writeResult) {
-            messages.push_back(std::string(message, length));
-        }
-        return writeResult;
+    void write(const std::string& message) override { write(message.c_str(), message.length()); }
+    void write(const char* message, size_t length) override {
+        messages.push_back(std::string(message, length));
     }
 
     void flush() override {}
@@ -83,6 +84,84 @@ void test_log_with_format() {
     TEST_ASSERT_TRUE(testBackend->messages[0].find("test") != std::string::npos);
 }
 
+void test_long_message_keeps_envelope_and_newline() {
+    // Longer than the largest size class: clipped, envelope and newline intact
+    std::string body(BufferPool::LARGE_BUFFER_SIZE * 2, 'x');
+    logger->log(ESP_LOG_INFO, "LONG", "%s", body.c_str());
+
+    TEST_ASSERT_EQUAL(1, testBackend->messages.size());
+    const std::string& line = testBackend->messages[0];
+    TEST_ASSERT_EQUAL(BufferPool::LARGE_BUFFER_SIZE - 1, line.size());
+    TEST_ASSERT_TRUE(line.find("[I] LONG: xxx") != std::string::npos);
+    TEST_ASSERT_EQUAL_STRING("\r\n", line.c_str() + line.size() - 2);
+}
+
+void test_envelope_options() {
+    LoggerConfig::Envelope envelope;
+    envelope.time = LoggerConfig::Envelope::Time::MICROS;
+    envelope.delta = true;
+    envelope.taskId = true;
+    logger->setEnvelope(envelope);
+    logger->log(ESP_LOG_INFO, "ENV", "stamped");
+
+    // No time field, task by name again
+    envelope.time = LoggerConfig::Envelope::Time::NONE;
+    envelope.taskId = false;
+    logger->setEnvelope(envelope);
+    logger->log(ESP_LOG_INFO, "ENV", "bare");
+
+    logger->setEnvelope(LoggerConfig::Envelope());
+
+    TEST_ASSERT_EQUAL(2, testBackend->messages.size());
+    const std::string& stamped = testBackend->messages[0];
+    TEST_ASSERT_TRUE(stamped.find("+") != std::string::npos);
+    TEST_ASSERT_TRUE(stamped.find("][#") != std::string::npos);
+    TEST_ASSERT_TRUE(stamped.find("[I] ENV: stamped") != std::string::npos);
+    TEST_ASSERT_EQUAL('[', testBackend->messages[1][0]);
+    TEST_ASSERT_TRUE(testBackend->messages[1].find(pcTaskGetName(NULL)) == 1);
+}
+
+void test_syslog_severity_without_time() {
+    LoggerConfig::Envelope envelope;
+    envelope.time = LoggerConfig::Envelope::Time::NONE;
+    logger->setEnvelope(envelope);
+    logger->log(ESP_LOG_ERROR, "SYS", "failed [x] here");
+    logger->log(ESP_LOG_WARN, "SYS", "low");
+    logger->setEnvelope(LoggerConfig::Envelope());
+    logger->log(ESP_LOG_DEBUG, "SYS", "stamped");
+
+    TEST_ASSERT_EQUAL(3, testBackend->messages.size());
+    const std::string& error = testBackend->messages[0];
+    TEST_ASSERT_EQUAL(3, UdpSyslogBackend::severityOf(error.c_str(), error.size()));
+    const std::string& warning = testBackend->messages[1];
+    TEST_ASSERT_EQUAL(4, UdpSyslogBackend::severityOf(warning.c_str(), warning.size()));
+    const std::string& debug = testBackend->messages[2];
+    TEST_ASSERT_EQUAL(7, UdpSyslogBackend::severityOf(debug.c_str(), debug.size()));
+
+    // Task names may contain brackets; IDF's own line shape still parses
+    const char* bracketTask = "[io[1][2]][W] SYS: odd task";
+    TEST_ASSERT_EQUAL(4, UdpSyslogBackend::severityOf(bracketTask, strlen(bracketTask)));
+    const char* idf = "E (123) SYS: idf";
+    TEST_ASSERT_EQUAL(3, UdpSyslogBackend::severityOf(idf, strlen(idf)));
+}
+
+void test_typed_front_end() {
+    std::string host = "broker";
+    logger->info("MQTT", "{} up in {} ms, rssi {}, {:.1} V, flags {:x}", host, 12u, -70, 3.25f, 0xA5);
+    logger->debug("MQTT", "{} {{literal}}", true);
+
+    TEST_ASSERT_EQUAL(2, testBackend->messages.size());
+    TEST_ASSERT_TRUE(testBackend->messages[0].find("[I] MQTT: broker up in 12 ms, rssi -70, 3.3 V, flags a5\r\n") !=
+                     std::string::npos);
+    TEST_ASSERT_TRUE(testBackend->messages[1].find("MQTT: true {literal}") != std::string::npos);
+
+    // Same filtering as log()
+    logger->setTagLevel("MQTT", ESP_LOG_WARN);
+    logger->info("MQTT", "filtered {}", 1);
+    TEST_ASSERT_EQUAL(2, testBackend->messages.size());
+    logger->setTagLevel("MQTT", ESP_LOG_VERBOSE);
+}
+
 // ============= Log Level Filtering Tests =============
 
 void test_log_level_filtering() {
@@ -137,6 +216,155 @@ void test_is_level_enabled_for_tag() {
     TEST_ASSERT_TRUE(logger->isLevelEnabledForTag("DEBUG_TAG", ESP_LOG_DEBUG));
 }
 
+void test_tag_level_update_and_long_tags() {
+    logger->setLogLevel(ESP_LOG_INFO);
+    logger->setTagLevel("UPDATE_TAG", ESP_LOG_ERROR);
+    TEST_ASSERT_EQUAL(ESP_LOG_ERROR, logger->getTagLevel("UPDATE_TAG"));
+
+    // Updating an existing tag must not create a second entry
+    logger->setTagLevel("UPDATE_TAG", ESP_LOG_DEBUG);
+    TEST_ASSERT_EQUAL(ESP_LOG_DEBUG, logger->getTagLevel("UPDATE_TAG"));
+
+    // Tags longer than the stored name are matched on their truncated prefix
+    const char* longTag = "A_VERY_LONG_TAG_NAME_THAT_EXCEEDS_THE_LIMIT";
+    logger->setTagLevel(longTag, ESP_LOG_WARN);
+    TEST_ASSERT_EQUAL(ESP_LOG_WARN, logger->getTagLevel(longTag));
+
+    // Unknown tags fall back to the global level
+    TEST_ASSERT_EQUAL(ESP_LOG_INFO, logger->getTagLevel("UNKNOWN_TAG"));
+
+    logger->setLogLevel(ESP_LOG_VERBOSE);
+}
+
+void test_tag_patterns() {
+    logger->setLogLevel(ESP_LOG_WARN);
+    logger->setTagLevel("Pat.*", ESP_LOG_DEBUG);
+    logger->setTagLevel("Pat.Net.*", ESP_LOG_INFO);
+    logger->setTagLevel("Pat.TCP", ESP_LOG_ERROR);
+
+    // Longest prefix wins, a tag's own level beats any pattern
+    TEST_ASSERT_EQUAL(ESP_LOG_DEBUG, logger->getTagLevel("Pat.RTU"));
+    TEST_ASSERT_EQUAL(ESP_LOG_INFO, logger->getTagLevel("Pat.Net.WiFi"));
+    TEST_ASSERT_EQUAL(ESP_LOG_ERROR, logger->getTagLevel("Pat.TCP"));
+    TEST_ASSERT_EQUAL(ESP_LOG_WARN, logger->getTagLevel("Other"));
+    TEST_ASSERT_EQUAL(ESP_LOG_DEBUG, logger->getTagLevel("Pat.*"));
+
+    // Changing a pattern re-resolves tags already in the table
+    logger->setTagLevel("Pat.*", ESP_LOG_ERROR);
+    TEST_ASSERT_FALSE(logger->isLevelEnabledForTag("Pat.RTU", ESP_LOG_WARN));
+    TEST_ASSERT_TRUE(logger->isLevelEnabledForTag("Pat.RTU", ESP_LOG_ERROR));
+
+    logger->setLogLevel(ESP_LOG_VERBOSE);
+}
+
+void test_compile_time_tag_id() {
+    static constexpr LogTag TAG_ID = LOG_TAG_ID("TAG_ID_TEST");
+
+    // Compile-time and runtime hashing must agree
+    TEST_ASSERT_EQUAL_UINT32(TagLevelTable::hash("TAG_ID_TEST"), TAG_ID.id);
+    TEST_ASSERT_EQUAL_UINT32(TAG_ID.id, logger->registerTag("TAG_ID_TEST"));
+    TEST_ASSERT_EQUAL_STRING("TAG_ID_TEST", logger->getTagName(TAG_ID.id));
+
+    logger->setTagLevel(TAG_ID, ESP_LOG_WARN);
+    TEST_ASSERT_FALSE(logger->isLevelEnabledForTag(TAG_ID, ESP_LOG_INFO));
+    TEST_ASSERT_TRUE(logger->isLevelEnabledForTag(TAG_ID, ESP_LOG_WARN));
+
+    logger->log(ESP_LOG_INFO, TAG_ID, "Filtered by ID");
+    logger->log(ESP_LOG_WARN, TAG_ID, "Passed by ID");
+    TEST_ASSERT_EQUAL(1, testBackend->messages.size());
+    TEST_ASSERT_TRUE(testBackend->messages[0].find("TAG_ID_TEST") != std::string::npos);
+}
+
+void test_deferred_formatting() {
+    TEST_ASSERT_TRUE(logger->startDeferredTask());
+
+    char ramString[] = "captured";
+    logger->log(ESP_LOG_INFO, "DEFER", "Value %d %.1f %s", 42, 2.5, ramString);
+    ramString[0] = 'X';  // Must not affect the already captured record
+
+    logger->flush();
+    logger->stopDeferredTask();
+    TEST_ASSERT_FALSE(logger->isDeferredTaskRunning());
+
+    TEST_ASSERT_EQUAL(1, testBackend->messages.size());
+    TEST_ASSERT_TRUE(testBackend->messages[0].find("DEFER: Value 42 2.5 captured") != std::string::npos);
+}
+
+void test_log_from_isr() {
+    // Nothing to defer to: dropped, never formatted in place
+    uint32_t dropped = logger->getDroppedLogs();
+    TEST_ASSERT_FALSE(logger->logFromISR(ESP_LOG_INFO, "ISR", "Edge %u", 1u));
+    TEST_ASSERT_EQUAL(dropped + 1, logger->getDroppedLogs());
+    TEST_ASSERT_EQUAL(0, testBackend->messages.size());
+
+    TEST_ASSERT_TRUE(logger->startDeferredTask());
+    logger->setLogLevel(ESP_LOG_INFO);
+    TEST_ASSERT_TRUE(logger->logFromISR(ESP_LOG_INFO, "ISR", "Edge %u", 2u));
+    TEST_ASSERT_FALSE(logger->logFromISR(ESP_LOG_DEBUG, "ISR", "Filtered"));
+    logger->setLogLevel(ESP_LOG_VERBOSE);
+
+    logger->flush();
+    logger->stopDeferredTask();
+
+    TEST_ASSERT_EQUAL(1, testBackend->messages.size());
+    TEST_ASSERT_TRUE(testBackend->messages[0].find("ISR: Edge 2") != std::string::npos);
+}
+
+void test_esp_log_redirect_uses_idf_prefix() {
+    logger->enableESPLogRedirection();
+    logger->setTagLevel("idf_test", ESP_LOG_WARN);
+
+    // What ESP_LOGE / ESP_LOGI expand to inside IDF components
+    esp_log_write(ESP_LOG_ERROR, "idf_test", LOG_FORMAT(E, "failed %d"), esp_log_timestamp(), "idf_test", 7);
+    esp_log_write(ESP_LOG_INFO, "idf_test", LOG_FORMAT(I, "filtered %d"), esp_log_timestamp(), "idf_test", 8);
+
+    esp_log_set_vprintf(vprintf);
+    logger->setTagLevel("idf_test", ESP_LOG_VERBOSE);
+
+    TEST_ASSERT_EQUAL(1, testBackend->messages.size());
+    TEST_ASSERT_TRUE(testBackend->messages[0].find("E (") != std::string::npos);
+    TEST_ASSERT_TRUE(testBackend->messages[0].find("idf_test: failed 7") != std::string::npos);
+}
+
+// Records unformatted calls so routing can be checked without a UART
+class TestUnformattedBackend : public ILogBackend {
+public:
+    std::vector<std::string> formats;
+    size_t textWrites = 0;
+
+    bool acceptsUnformatted() const override { return true; }
+    void writeUnformatted(esp_log_level_t level, const char* tag, const char* format, va_list args) override {
+        formats.push_back(format);
+    }
+    void write(const std::string& message) override { textWrites++; }
+    void write(const char* message, size_t length) override { textWrites++; }
+    void flush() override {}
+};
+
+void test_unformatted_backend_routing() {
+    auto binary = std::make_shared<TestUnformattedBackend>();
+    logger->addBackend(binary);
+
+    // Flash format: binary backend gets the raw call, text backend the formatted line
+    logger->log(ESP_LOG_INFO, "BIN", "Reading %d", 7);
+    TEST_ASSERT_EQUAL(1, binary->formats.size());
+    TEST_ASSERT_EQUAL_STRING("Reading %d", binary->formats[0].c_str());
+    TEST_ASSERT_EQUAL(0, binary->textWrites);
+    TEST_ASSERT_EQUAL(1, testBackend->messages.size());
+
+    // RAM format cannot be referenced by address - falls back to text
+    char ramFormat[] = "Runtime %d";
+    logger->log(ESP_LOG_INFO, "BIN", ramFormat, 8);
+    TEST_ASSERT_EQUAL(1, binary->formats.size());
+    TEST_ASSERT_EQUAL(1, binary->textWrites);
+
+    logger->removeBackend(binary);
+
+    // CRC-8/SMBUS check value
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    TEST_ASSERT_EQUAL_HEX8(0xF4, BinarySerialBackend::crc8(check, sizeof(check)));
+}
+
 // ============= Level String Conversion Tests =============
 
 void test_level_to_string() {
@@ -167,6 +395,149 @@ void test_rate_limiting() {
     logger->setMaxLogsPerSecond(MAX_LOGS_PER_SECOND);
 }
 
+void test_level_and_tag_rate_limits() {
+    logger->setMaxLogsPerSecond(10);
+    logger->setLevelRateLimit(ESP_LOG_ERROR, 5);
+
+    // An INFO flood uses up the global budget...
+    for (int i = 0; i < 50; i++) {
+        logger->log(ESP_LOG_INFO, "WiFi", "Flood %d", i);
+    }
+    testBackend->clear();
+
+    // ...but ERROR has its own
+    for (int i = 0; i < 5; i++) {
+        logger->log(ESP_LOG_ERROR, "SAFETY", "Fault %d", i);
+    }
+    TEST_ASSERT_EQUAL(5, testBackend->messages.size());
+
+    // A capped tag cannot use up the budget other tags share
+    logger->setMaxLogsPerSecond(1000);
+    TEST_ASSERT_TRUE(logger->setTagRateLimit("WiFi", 3));
+    testBackend->clear();
+    for (int i = 0; i < 20; i++) {
+        logger->log(ESP_LOG_INFO, "WiFi", "Flood %d", i);
+    }
+    TEST_ASSERT_EQUAL(3, testBackend->messages.size());
+    logger->log(ESP_LOG_INFO, "OTHER", "Still logging");
+    TEST_ASSERT_EQUAL(4, testBackend->messages.size());
+
+    // Reset
+    logger->setTagRateLimit("WiFi", 0);
+    logger->setLevelRateLimit(ESP_LOG_ERROR, 0);
+    logger->setMaxLogsPerSecond(MAX_LOGS_PER_SECOND);
+}
+
+void test_repeats_are_coalesced() {
+    logger->setMaxLogsPerSecond(5);
+    logger->setDedupWindow(1000);
+
+    // A flapping call site costs one line and one unit of budget...
+    for (int i = 0; i < 100; i++) {
+        logger->log(ESP_LOG_WARN, "SENSOR", "Out of range: %d", i);
+    }
+    TEST_ASSERT_EQUAL(1, testBackend->messages.size());
+    logger->log(ESP_LOG_INFO, "OTHER", "Still logging");
+    TEST_ASSERT_EQUAL(2, testBackend->messages.size());
+
+    // ...plus the summary when the run is reported
+    logger->flush();
+    TEST_ASSERT_EQUAL(3, testBackend->messages.size());
+    TEST_ASSERT_TRUE(testBackend->messages[2].find("SENSOR: last message repeated 99 times over") !=
+                     std::string::npos);
+
+    // Reset
+    logger->setDedupWindow(0);
+    logger->setMaxLogsPerSecond(MAX_LOGS_PER_SECOND);
+}
+
+// Backend that reports every write as dropped until `lossy` is cleared
+class LossyBackend : public TestLogBackend {
+public:
+    bool lossy = true;
+    uint32_t drops = 0;
+
+    using TestLogBackend::write;
+    void write(const char* message, size_t length) override {
+        if (lossy) {
+            drops++;
+            return;
+        }
+        TestLogBackend::write(message, length);
+    }
+
+    uint32_t getDroppedMessages() const override { return drops; }
+};
+
+void test_adaptive_throttle() {
+    auto lossy = std::make_shared<LossyBackend>();
+    logger->setBackend(lossy);
+    logger->setMaxLogsPerSecond(0);
+
+    LoggerConfig::Throttle throttle;
+    throttle.enabled = true;
+    throttle.windowMs = 10;
+    throttle.pressureWindows = 1;
+    throttle.calmWindows = 2;
+    logger->setThrottle(throttle);
+    uint32_t throttledBefore = logger->getThrottledLogs();
+
+    // Sustained drops mask VERBOSE/DEBUG, then INFO - never WARN
+    for (int i = 0; i < 100; i++) {
+        logger->log(ESP_LOG_DEBUG, "FLOOD", "Debug %d", i);
+        logger->log(ESP_LOG_INFO, "FLOOD", "Info %d", i);
+        logger->log(ESP_LOG_WARN, "FLOOD", "Warn %d", i);
+        delay(1);
+    }
+    TEST_ASSERT_EQUAL(ESP_LOG_WARN, logger->getThrottleLevel());
+    TEST_ASSERT_GREATER_THAN(throttledBefore, logger->getThrottledLogs());
+
+    // Pressure gone: restored, with one summary line
+    lossy->lossy = false;
+    for (int i = 0; i < 100 && logger->getThrottleLevel() != ESP_LOG_VERBOSE; i++) {
+        logger->log(ESP_LOG_WARN, "FLOOD", "Calm %d", i);
+        delay(1);
+    }
+    TEST_ASSERT_EQUAL(ESP_LOG_VERBOSE, logger->getThrottleLevel());
+    size_t summaries = 0;
+    for (auto& message : lossy->messages) {
+        if (message.find("Log throttling lifted") != std::string::npos) summaries++;
+    }
+    TEST_ASSERT_EQUAL(1, summaries);
+
+    // Reset
+    logger->setThrottle(LoggerConfig::Throttle());
+    logger->setMaxLogsPerSecond(MAX_LOGS_PER_SECOND);
+    logger->setBackend(testBackend);
+}
+
+void test_stats_instrumentation() {
+    LogStats* stats = new LogStats();
+#if CONFIG_LOG_INSTRUMENTATION
+    logger->resetStats();
+    logger->log(ESP_LOG_INFO, "STATS", "Counted %d", 1);
+    logger->log(ESP_LOG_INFO, "STATS", "Counted %d", 2);
+
+    TEST_ASSERT_TRUE(logger->getStats(*stats));
+    TEST_ASSERT_EQUAL(2, stats->stage(LogStage::FORMAT).count);
+    TEST_ASSERT_EQUAL(2, stats->stage(LogStage::BACKENDS).count);
+    bool found = false;
+    for (size_t i = 0; i < stats->tagCount; i++) {
+        if (strcmp(stats->tags[i].tag, "STATS") == 0) {
+            TEST_ASSERT_EQUAL(2, stats->tags[i].messages);
+            TEST_ASSERT_EQUAL(testBackend->messages[0].size() + testBackend->messages[1].size(),
+                              stats->tags[i].bytes);
+            found = true;
+        }
+    }
+    TEST_ASSERT_TRUE(found);
+#else
+    // Compiled out: nothing to read
+    TEST_ASSERT_FALSE(logger->getStats(*stats));
+#endif
+    delete stats;
+}
+
 // ============= Buffer Pool Tests =============
 
 void test_buffer_pool_acquire_release() {
@@ -207,6 +578,60 @@ void test_buffer_pool_exhaustion() {
     TEST_PASS();  // Test passes if no crash
 }
 
+void test_buffer_pool_exhaustion_policy() {
+    auto& pool = BufferPool::getInstance();
+    std::vector<char*> buffers;
+    // acquire() moves up to LARGE once MEDIUM is empty - drain both
+    while (pool.getFreeCount() > 0 || pool.getFreeCount(BufferPool::SizeClass::LARGE) > 0) {
+        buffers.push_back(pool.acquire());
+    }
+
+    // Drop: nullptr and counted
+    pool.resetStats();
+    pool.setExhaustionPolicy(BufferPool::ExhaustionPolicy::DROP);
+    TEST_ASSERT_NULL(pool.acquire());
+    TEST_ASSERT_EQUAL(1, pool.getDroppedAcquires());
+
+    // Heap fallback: a heap buffer that release() frees
+    pool.setExhaustionPolicy(BufferPool::ExhaustionPolicy::HEAP_FALLBACK);
+    char* heap = pool.acquire();
+    TEST_ASSERT_NOT_NULL(heap);
+    TEST_ASSERT_EQUAL(1, pool.getHeapFallbacks());
+    pool.release(heap);
+
+    for (char* buf : buffers) {
+        pool.release(buf);
+    }
+    TEST_ASSERT_EQUAL(CONFIG_LOG_BUFFER_POOL_SIZE, pool.getFreeCount());
+}
+
+void test_buffer_pool_size_classes() {
+    auto& pool = BufferPool::getInstance();
+    size_t capacity = 0;
+
+    char* small = pool.acquire(40, capacity);
+    TEST_ASSERT_NOT_NULL(small);
+    TEST_ASSERT_EQUAL(BufferPool::SMALL_BUFFER_SIZE, capacity);
+
+    char* large = pool.acquire(600, capacity);
+    TEST_ASSERT_NOT_NULL(large);
+    TEST_ASSERT_EQUAL(BufferPool::LARGE_BUFFER_SIZE, capacity);
+
+    auto stats = pool.getClassStats(BufferPool::SizeClass::LARGE);
+    TEST_ASSERT_EQUAL(1, stats.inUse);
+    TEST_ASSERT_TRUE(stats.peakInUse >= 1);
+
+    pool.release(small);
+    pool.release(large);
+    TEST_ASSERT_EQUAL(0, pool.getClassStats(BufferPool::SizeClass::LARGE).inUse);
+
+    // A line longer than MEDIUM is no longer clipped at CONFIG_LOG_BUFFER_SIZE
+    std::string dump(CONFIG_LOG_BUFFER_SIZE + 100, 'h');
+    logger->log(ESP_LOG_INFO, "DUMP", "%s", dump.c_str());
+    TEST_ASSERT_EQUAL(1, testBackend->messages.size());
+    TEST_ASSERT_TRUE(testBackend->messages[0].find(dump) != std::string::npos);
+}
+
 // ============= Multiple Backend Tests =============
 
 void test_multiple_backends() {
@@ -227,6 +652,116 @@ void test_multiple_backends() {
     logger->addBackend(testBackend);
 }
 
+// Backend that records how messages were grouped
+class BatchingBackend : public ILogBackend {
+public:
+    std::vector<std::string> messages;
+    size_t batchCalls = 0;
+
+    void write(const std::string& logMessage) override { messages.push_back(logMessage); }
+    void write(const char* logMessage, size_t length) override { messages.emplace_back(logMessage, length); }
+    void writeBatch(const LogRecordView* records, size_t count) override {
+        batchCalls++;
+        for (size_t i = 0; i < count; i++) {
+            messages.emplace_back(records[i].data, records[i].length);
+        }
+    }
+    void flush() override {}
+};
+
+void test_async_ring_batches_writes() {
+    auto sink = std::make_shared<BatchingBackend>();
+    AsyncRingBackend ring(sink);  // Not started: flush() drains on this task
+
+    for (int i = 0; i < 20; i++) {
+        char line[16];
+        int n = snprintf(line, sizeof(line), "batch %02d\n", i);
+        ring.write(line, n);
+    }
+    ring.flush();
+
+    // 20 records in ceil(20 / batch size) calls, in order
+    TEST_ASSERT_EQUAL(20, sink->messages.size());
+    TEST_ASSERT_EQUAL((20 + CONFIG_LOG_ASYNC_BATCH_SIZE - 1) / CONFIG_LOG_ASYNC_BATCH_SIZE, sink->batchCalls);
+    TEST_ASSERT_EQUAL_STRING("batch 00\n", sink->messages.front().c_str());
+    TEST_ASSERT_EQUAL_STRING("batch 19\n", sink->messages.back().c_str());
+}
+
+void test_async_ring_batch_delay() {
+    auto sink = std::make_shared<BatchingBackend>();
+    AsyncRingBackend::Config config;
+    config.batchDelayMs = 50;
+    AsyncRingBackend ring(sink, config);
+    TEST_ASSERT_TRUE(ring.start());
+
+    // Written well inside the delay: one wake-up, one batch
+    for (int i = 0; i < 5; i++) {
+        ring.write("burst\n", 6);
+    }
+    delay(150);
+
+    TEST_ASSERT_EQUAL(5, sink->messages.size());
+    TEST_ASSERT_EQUAL(1, sink->batchCalls);
+    ring.stop();
+}
+
+void test_rtc_tail_replays_lines() {
+    {
+        RtcTailBackend tail;
+        tail.clear();
+        tail.write("first line\r\n", 12);
+        tail.write("second line\r\n", 13);
+    }
+
+    // A new instance sees what the previous "boot" left behind
+    RtcTailBackend tail;
+    TEST_ASSERT_EQUAL(25, tail.getPreviousLength());
+    TEST_ASSERT_EQUAL(25, tail.replay(*testBackend));
+
+    TEST_ASSERT_EQUAL(3, testBackend->messages.size());  // Marker + two lines
+    TEST_ASSERT_EQUAL_STRING("first line\r\n", testBackend->messages[1].c_str());
+    TEST_ASSERT_EQUAL_STRING("second line\r\n", testBackend->messages[2].c_str());
+    TEST_ASSERT_EQUAL(0, tail.getPreviousLength());
+}
+
+// ============= Subscriber Tests =============
+
+static int filteredHits = 0;
+static size_t batchedMessages = 0;
+
+static void filteredSubscriber(esp_log_level_t level, const char* tag, const char* message) {
+    filteredHits++;
+}
+
+static void batchSubscriber(const LogSubscriberEntryView* messages, size_t count) {
+    batchedMessages += count;
+}
+
+void test_subscriber_filters() {
+    filteredHits = 0;
+    batchedMessages = 0;
+
+    LogSubscriberFilter warnings;
+    warnings.levelMask = LogSubscriberFilter::upTo(ESP_LOG_WARN);
+    TEST_ASSERT_TRUE(warnings.addTag("MQTT"));
+
+    // No subscriber task: delivered synchronously, filters still apply
+    TEST_ASSERT_TRUE(logger->addLogSubscriber(filteredSubscriber, warnings));
+    TEST_ASSERT_TRUE(logger->addLogBatchSubscriber(batchSubscriber));
+    TEST_ASSERT_FALSE(logger->addLogSubscriber(filteredSubscriber));  // Duplicate
+
+    logger->log(ESP_LOG_WARN, "MQTT", "kept");
+    logger->log(ESP_LOG_INFO, "MQTT", "level filtered");
+    logger->log(ESP_LOG_ERROR, "OTHER", "tag filtered");
+
+    TEST_ASSERT_EQUAL(1, filteredHits);
+    TEST_ASSERT_EQUAL(3, batchedMessages);  // Unfiltered batch subscriber sees all
+
+    TEST_ASSERT_TRUE(logger->removeLogSubscriber(filteredSubscriber));
+    TEST_ASSERT_TRUE(logger->removeLogSubscriber(batchSubscriber));
+    TEST_ASSERT_EQUAL(0, logger->getSubscriberCount());
+}
+
 // ============= Direct Logging Tests =============
 
 void test_log_direct() {
@@ -242,6 +777,18 @@ void test_log_direct() {
     logger->setMaxLogsPerSecond(MAX_LOGS_PER_SECOND);
 }
 
+void test_log_hex_is_one_message() {
+    const uint8_t frame[] = {0x01, 0x03, 0x00, 0x10, 0x00, 0x02, 0xC5, 0xCE};
+    logger->setMaxLogsPerSecond(1);
+    logger->logHex(ESP_LOG_INFO, "MODBUS", frame, sizeof(frame), "TX");
+
+    TEST_ASSERT_EQUAL(1, testBackend->messages.size());
+    TEST_ASSERT_TRUE(testBackend->messages[0].find("MODBUS: TX (8 bytes): 01 03 00 10 00 02 C5 CE\r\n") !=
+                     std::string::npos);
+
+    logger->setMaxLogsPerSecond(MAX_LOGS_PER_SECOND);
+}
+
 // Test runner
 void runLoggerTests() {
     UNITY_BEGIN();
@@ -250,16 +797,38 @@ void runLoggerTests() {
     RUN_TEST(test_log_level_setting);
     RUN_TEST(test_log_message_capture);
     RUN_TEST(test_log_with_format);
+    RUN_TEST(test_long_message_keeps_envelope_and_newline);
+    RUN_TEST(test_envelope_options);
+    RUN_TEST(test_syslog_severity_without_time);
+    RUN_TEST(test_typed_front_end);
     RUN_TEST(test_log_level_filtering);
     RUN_TEST(test_logging_disabled);
     RUN_TEST(test_tag_level_filtering);
     RUN_TEST(test_is_level_enabled_for_tag);
+    RUN_TEST(test_tag_level_update_and_long_tags);
+    RUN_TEST(test_tag_patterns);
+    RUN_TEST(test_compile_time_tag_id);
+    RUN_TEST(test_deferred_formatting);
+    RUN_TEST(test_log_from_isr);
+    RUN_TEST(test_esp_log_redirect_uses_idf_prefix);
+    RUN_TEST(test_unformatted_backend_routing);
     RUN_TEST(test_level_to_string);
     RUN_TEST(test_rate_limiting);
+    RUN_TEST(test_level_and_tag_rate_limits);
+    RUN_TEST(test_repeats_are_coalesced);
+    RUN_TEST(test_stats_instrumentation);
+    RUN_TEST(test_adaptive_throttle);
     RUN_TEST(test_buffer_pool_acquire_release);
     RUN_TEST(test_buffer_pool_exhaustion);
+    RUN_TEST(test_buffer_pool_exhaustion_policy);
+    RUN_TEST(test_buffer_pool_size_classes);
     RUN_TEST(test_multiple_backends);
+    RUN_TEST(test_async_ring_batches_writes);
+    RUN_TEST(test_async_ring_batch_delay);
+    RUN_TEST(test_rtc_tail_replays_lines);
+    RUN_TEST(test_subscriber_filters);
     RUN_TEST(test_log_direct);
+    RUN_TEST(test_log_hex_is_one_message);
 
     UNITY_END();
 }
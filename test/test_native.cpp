@@ -0,0 +1,400 @@
+/**
+ * @file test_native.cpp
+ * @brief Host tests of the core pipeline (native env, std::thread platform)
+ *
+ * Runs without hardware: pio test -e native (or -e native-tsan for
+ * ThreadSanitizer). Threads are std::threads, so the races these tests
+ * provoke are visible to the sanitizers.
+ */
+
+#if defined(UNIT_TEST) && defined(LOG_PLATFORM_NATIVE)
+
+#include <unity.h>
+#include <Logger.h>
+#include <AsyncRingBackend.h>
+#include <DeferredFormat.h>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Keeps every line it is given
+class CaptureBackend : public ILogBackend {
+public:
+    void write(const std::string& message) override { write(message.c_str(), message.length()); }
+    void write(const char* message, size_t length) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lines_.emplace_back(message, length);
+    }
+    void flush() override {}
+
+    size_t count() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lines_.size();
+    }
+    bool contains(const char* text) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const std::string& line : lines_) {
+            if (line.find(text) != std::string::npos) return true;
+        }
+        return false;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::string> lines_;
+};
+
+// Takes Logger::event() fields typed, renders them as JSON
+class FieldsBackend : public CaptureBackend {
+public:
+    bool writeFields(esp_log_level_t level, const char* tag, const char* message,
+                     const uint8_t* fields, size_t length) override {
+        char json[128];
+        LogFormat::Writer out(json, sizeof(json));
+        LogFields::renderJson(out, fields, length);
+        write(json, out.finish());
+        return true;
+    }
+};
+
+static Logger& logger = Logger::getInstance();
+static std::shared_ptr<CaptureBackend> capture;
+
+void setUp() {
+    capture = std::make_shared<CaptureBackend>();
+    logger.setBackend(capture);
+    logger.setLogLevel(ESP_LOG_INFO);
+    logger.setMaxLogsPerSecond(0);
+}
+
+void tearDown() {}
+
+#if CONFIG_LOG_EARLY_BUFFER_SIZE
+// Logged in main() before any backend existed, replayed by the first setBackend()
+void test_native_early_lines_replayed() {
+    TEST_ASSERT_TRUE(capture->contains("BOOT: before any backend 1\r\n"));
+    TEST_ASSERT_EQUAL(0, logger.getLostWrites());
+}
+#endif
+
+void test_native_footprint_is_lazy() {
+    // Nothing optional has been used yet
+    LogFootprint before = logger.getFootprint();
+    TEST_ASSERT_EQUAL(sizeof(Logger), before.logger);
+    TEST_ASSERT_EQUAL(0, before.tagTable);
+    TEST_ASSERT_EQUAL(0, before.repeatSlots);
+    TEST_ASSERT_EQUAL(0, before.deferredRing);
+    TEST_ASSERT_EQUAL(0, before.taskStacks);
+
+    logger.setTagLevel("LAZY", ESP_LOG_WARN);
+    logger.setDedupWindow(100);
+    logger.setDedupWindow(0);
+
+    LogFootprint after = logger.getFootprint();
+#if CONFIG_LOG_STATIC_ALLOCATION
+    // All of it was already part of the singleton
+    TEST_ASSERT_EQUAL(before.internal(), after.internal());
+#else
+    TEST_ASSERT_EQUAL(sizeof(TagLevelTable), after.tagTable);
+    TEST_ASSERT_TRUE(after.repeatSlots > 0);
+    TEST_ASSERT_TRUE(after.mutexes > 0);
+    TEST_ASSERT_TRUE(after.internal() > before.internal());
+#endif
+    TEST_ASSERT_EQUAL(ESP_LOG_WARN, logger.getTagLevel("LAZY"));
+}
+
+#if CONFIG_LOG_STATIC_ALLOCATION
+void test_native_static_backend_slots() {
+    std::shared_ptr<CaptureBackend> extra[CONFIG_LOG_MAX_BACKENDS];
+    for (auto& backend : extra) backend = std::make_shared<CaptureBackend>();
+    for (int i = 1; i < CONFIG_LOG_MAX_BACKENDS; i++) logger.addBackend(extra[i - 1]);
+    logger.addBackend(extra[CONFIG_LOG_MAX_BACKENDS - 1]);  // One too many
+    logger.log(ESP_LOG_INFO, "SLOTS", "fanned out");
+
+    // The lists live in the singleton; the full one kept its backends
+    TEST_ASSERT_EQUAL(0, logger.getFootprint().backendList);
+    TEST_ASSERT_TRUE(capture->contains("CONFIG_LOG_MAX_BACKENDS"));
+    TEST_ASSERT_TRUE(extra[CONFIG_LOG_MAX_BACKENDS - 2]->contains("SLOTS: fanned out"));
+    TEST_ASSERT_EQUAL(0, extra[CONFIG_LOG_MAX_BACKENDS - 1]->count());
+
+    logger.removeBackend(extra[0]);
+    logger.log(ESP_LOG_INFO, "SLOTS", "after remove");
+    TEST_ASSERT_FALSE(extra[0]->contains("after remove"));
+    TEST_ASSERT_TRUE(extra[1]->contains("after remove"));
+    TEST_ASSERT_EQUAL(1, extra[0].use_count());  // The retired list let go of it
+}
+#endif
+
+void test_native_format_and_filter() {
+    logger.log(ESP_LOG_DEBUG, "NAT", "hidden %d", 1);
+    TEST_ASSERT_EQUAL(0, capture->count());
+
+    logger.log(ESP_LOG_INFO, "NAT", "value %d of %s", 42, "answer");
+    logger.info("NAT", "typed {} {}", 7, "args");
+    TEST_ASSERT_EQUAL(2, capture->count());
+    TEST_ASSERT_TRUE(capture->contains("[main][I] NAT: value 42 of answer\r\n"));
+    TEST_ASSERT_TRUE(capture->contains("NAT: typed 7 args"));
+}
+
+static std::string packAndRender(const char* format, ...) {
+    uint8_t packed[128];
+    bool truncated;
+    va_list args;
+    va_start(args, format);
+    size_t length = DeferredFormat::pack(format, args, packed, sizeof(packed), truncated);
+    va_end(args);
+    char out[128];
+    DeferredFormat::render(format, packed, length, out, sizeof(out));
+    return out;
+}
+
+void test_native_deferred_long_spec() {
+    // Too long to re-emit: a placeholder, and the arguments after it stay in step
+    TEST_ASSERT_EQUAL_STRING("a <?> b 7 c x",
+                             packAndRender("a %000000000000000000000000001d b %d c %s", 5, 7, "x").c_str());
+}
+
+void test_native_esp_log_redirection() {
+    logger.enableESPLogRedirection();
+    ESP_LOGW("IDF", "disk %d%% full", 93);
+    esp_log_set_vprintf(&vprintf);
+
+    // Parsed for level and tag; IDF's own envelope is kept
+    TEST_ASSERT_TRUE(capture->contains(") IDF: disk 93% full\n"));
+    TEST_ASSERT_EQUAL(1, capture->count());
+}
+
+void test_native_isr_record_is_deferred() {
+    TEST_ASSERT_TRUE(logger.startDeferredTask());
+    {
+        LogPlatform::IsrScope isr;
+        TEST_ASSERT_TRUE(logger.logFromISR(ESP_LOG_WARN, "IRQ", "edge %d", 3));
+    }
+    logger.flush();
+    logger.stopDeferredTask();
+
+    TEST_ASSERT_TRUE(capture->contains("[ISR][W] IRQ: edge 3"));
+}
+
+static std::mutex eventMutex;
+static std::string eventMessage;
+static std::string eventFieldKeys;
+static int64_t eventRssi = 0;
+
+static void captureEvents(const LogSubscriberEntryView* messages, size_t count) {
+    std::lock_guard<std::mutex> lock(eventMutex);
+    for (size_t i = 0; i < count; i++) {
+        eventMessage = messages[i].message;
+        LogFields::Reader fields(messages[i].fields, messages[i].fieldsLength);
+        LogFields::Field field;
+        while (fields.next(field)) {
+            eventFieldKeys.append(field.key, field.keyLength).append(";");
+            if (field.type == LogFields::Type::INT32) eventRssi = field.i;
+        }
+    }
+}
+
+void test_native_structured_event() {
+    auto typed = std::make_shared<FieldsBackend>();
+    logger.addBackend(typed);
+    TEST_ASSERT_TRUE(logger.startSubscriberTask());
+    TEST_ASSERT_TRUE(logger.addLogBatchSubscriber(&captureEvents));
+
+    std::string ssid = "home net";
+    TEST_ASSERT_TRUE(logger.event(ESP_LOG_INFO, "WIFI", "up").kv("rssi", -71).kv("ms", 12u)
+                         .kv("ok", true).kv("ssid", ssid).kv("q", 0.5f).emit());
+    TEST_ASSERT_FALSE(logger.event(ESP_LOG_DEBUG, "WIFI").kv("hidden", 1).emit());
+    logger.stopSubscriberTask();
+    logger.removeLogSubscriber(&captureEvents);
+    logger.removeBackend(typed);
+
+    // Text backends get logfmt, fields-aware ones the typed fields
+    TEST_ASSERT_TRUE(capture->contains("WIFI: up rssi=-71 ms=12 ok=true ssid=\"home net\" q=0.500\r\n"));
+    TEST_ASSERT_TRUE(typed->contains("{\"rssi\":-71,\"ms\":12,\"ok\":true,\"ssid\":\"home net\",\"q\":0.500}"));
+    TEST_ASSERT_EQUAL(1, typed->count());
+
+    std::lock_guard<std::mutex> lock(eventMutex);
+    TEST_ASSERT_EQUAL_STRING("up rssi=-71 ms=12 ok=true ssid=\"home net\" q=0.500", eventMessage.c_str());
+    TEST_ASSERT_EQUAL_STRING("rssi;ms;ok;ssid;q;", eventFieldKeys.c_str());
+    TEST_ASSERT_EQUAL(-71, eventRssi);
+}
+
+void test_native_event_truncates_fields() {
+    char key[40];
+    LogEvent event = logger.event(ESP_LOG_INFO, "EVT");
+    for (int i = 0; i < 64 && !event.truncated(); i++) {
+        snprintf(key, sizeof(key), "key_number_%02d", i);
+        event.kv(key, i);
+    }
+    TEST_ASSERT_TRUE(event.truncated());
+    TEST_ASSERT_TRUE(event.fieldsLength() <= CONFIG_LOG_EVENT_FIELDS_SIZE);
+    TEST_ASSERT_TRUE(event.emit());
+    TEST_ASSERT_TRUE(capture->contains("EVT: key_number_00=0 key_number_01=1"));
+}
+
+void test_native_tag_sampling() {
+    logger.setTagLevel("SAMPLE", ESP_LOG_DEBUG);
+    TEST_ASSERT_TRUE(logger.setTagSampling("SAMPLE", ESP_LOG_DEBUG, 1, 10));
+    logger.resetSampledLogs();
+
+    for (int i = 0; i < 100; i++) logger.log(ESP_LOG_DEBUG, "SAMPLE", "reading %d", i);
+    for (int i = 0; i < 5; i++) logger.log(ESP_LOG_WARN, "SAMPLE", "alarm %d", i);
+
+    // 1 in 10 DEBUG lines, the first of each ten; WARN is above the sampled level
+    TEST_ASSERT_EQUAL(15, capture->count());
+    TEST_ASSERT_TRUE(capture->contains("SAMPLE: reading 0\r\n"));
+    TEST_ASSERT_TRUE(capture->contains("SAMPLE: reading 90\r\n"));
+    TEST_ASSERT_FALSE(capture->contains("SAMPLE: reading 91\r\n"));
+    TEST_ASSERT_EQUAL(90, logger.getSampledLogs());
+    TEST_ASSERT_EQUAL(0, logger.getDroppedLogs());
+
+    // A budget instead of a ratio: a tight loop gets the burst, about 5
+    TEST_ASSERT_TRUE(logger.setTagSampling("SAMPLE", ESP_LOG_DEBUG, 0, 0));
+    TEST_ASSERT_TRUE(logger.setTagSamplingBudget("SAMPLE", ESP_LOG_DEBUG, 5, 5));
+    size_t before = capture->count();
+    for (int i = 0; i < 100; i++) logger.log(ESP_LOG_DEBUG, "SAMPLE", "burst %d", i);
+    TEST_ASSERT_TRUE(capture->count() - before >= 5 && capture->count() - before <= 6);
+
+    TEST_ASSERT_TRUE(logger.setTagSamplingBudget("SAMPLE", ESP_LOG_DEBUG, 0));
+    TEST_ASSERT_FALSE(logger.setTagSampling("SAMPLE*", ESP_LOG_DEBUG, 1, 10));
+    before = capture->count();
+    for (int i = 0; i < 10; i++) logger.log(ESP_LOG_DEBUG, "SAMPLE", "all %d", i);
+    TEST_ASSERT_EQUAL(before + 10, capture->count());
+}
+
+void test_native_configure_is_atomic() {
+    // Neither config logs ERROR for "Cfg.other"; only a mix of the two would
+    LoggerConfig off;
+    off.enableLogging = false;
+    off.defaultLevel = ESP_LOG_VERBOSE;
+    off.maxLogsPerSecond = 0;
+    off.primaryBackend = LoggerConfig::BackendType::CUSTOM;
+    off.addTagConfig("Cfg.tag", ESP_LOG_VERBOSE);
+    LoggerConfig on = off;
+    on.enableLogging = true;
+    on.defaultLevel = ESP_LOG_NONE;
+    on.tagConfigs[0].level = ESP_LOG_ERROR;
+    logger.configure(off);
+
+    std::atomic<bool> done{false};
+    std::atomic<int> reads{0};
+    std::atomic<int> mixed{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&]() {
+            while (!done.load()) {
+                if (logger.isLevelEnabledForTag("Cfg.other", ESP_LOG_ERROR)) mixed++;
+                esp_log_level_t level = logger.getEffectiveLevel("Cfg.tag");
+                if (level != ESP_LOG_NONE && level != ESP_LOG_ERROR) mixed++;
+                reads++;
+            }
+        });
+    }
+    for (int i = 0; i < 50; i++) {
+        // Let the readers run between swaps
+        int before = reads.load();
+        while (reads.load() < before + 8) std::this_thread::yield();
+        logger.configure(i % 2 ? on : off);
+    }
+    done.store(true);
+    for (std::thread& reader : readers) reader.join();
+
+    TEST_ASSERT_EQUAL(0, mixed.load());
+    TEST_ASSERT_EQUAL(ESP_LOG_ERROR, logger.getTagLevel("Cfg.tag"));
+    TEST_ASSERT_EQUAL(ESP_LOG_NONE, logger.getLogLevel());
+    logger.enableLogging(true);
+}
+
+void test_native_concurrent_threads() {
+    const int THREADS = 8;
+    const int ITERATIONS = 500;
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < ITERATIONS; i++) {
+                logger.log(ESP_LOG_INFO, "MT", "thread %d line %d", t, i);
+                if (i % 100 == 0) logger.setTagLevel("MT.other", (i / 100) % 2 ? ESP_LOG_WARN : ESP_LOG_DEBUG);
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    TEST_ASSERT_EQUAL(THREADS * ITERATIONS, capture->count() + logger.getDroppedLogs());
+}
+
+void test_native_async_ring_backend() {
+    auto sink = std::make_shared<CaptureBackend>();
+    auto ring = std::make_shared<AsyncRingBackend>(sink);
+    TEST_ASSERT_TRUE(ring->start());
+    logger.setBackend(ring);
+
+    for (int i = 0; i < 200; i++) {
+        logger.log(ESP_LOG_INFO, "RING", "record %d", i);
+    }
+    ring->stop();
+    logger.setBackend(capture);
+
+    TEST_ASSERT_EQUAL(200, sink->count() + ring->getDroppedMessages());
+    TEST_ASSERT_TRUE(sink->contains("RING: record 0\r\n"));
+}
+
+// Counts flushes, like a sink that stages output (FlashRingBackend)
+class FlushCountBackend : public CaptureBackend {
+public:
+    void flush() override { flushes++; }
+    std::atomic<int> flushes{0};
+};
+
+void test_native_async_ring_flushes_when_idle() {
+    auto sink = std::make_shared<FlushCountBackend>();
+    auto ring = std::make_shared<AsyncRingBackend>(sink);
+    TEST_ASSERT_TRUE(ring->start());
+    logger.setBackend(ring);
+
+    // Last line before going quiet - nobody calls flush()
+    logger.log(ESP_LOG_ERROR, "RING", "last words");
+    for (int i = 0; i < 50 && sink->flushes.load() == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    int idleFlushes = sink->flushes.load();
+    ring->stop();
+    logger.setBackend(capture);
+
+    TEST_ASSERT_TRUE(sink->contains("RING: last words"));
+    TEST_ASSERT_EQUAL(1, idleFlushes);
+}
+
+int main() {
+#if CONFIG_LOG_EARLY_BUFFER_SIZE
+    logger.log(ESP_LOG_INFO, "BOOT", "before any backend %d", 1);
+#endif
+
+    UNITY_BEGIN();
+#if CONFIG_LOG_EARLY_BUFFER_SIZE
+    RUN_TEST(test_native_early_lines_replayed);
+#endif
+    RUN_TEST(test_native_footprint_is_lazy);
+#if CONFIG_LOG_STATIC_ALLOCATION
+    RUN_TEST(test_native_static_backend_slots);
+#endif
+    RUN_TEST(test_native_format_and_filter);
+    RUN_TEST(test_native_deferred_long_spec);
+    RUN_TEST(test_native_esp_log_redirection);
+    RUN_TEST(test_native_isr_record_is_deferred);
+    RUN_TEST(test_native_structured_event);
+    RUN_TEST(test_native_event_truncates_fields);
+    RUN_TEST(test_native_tag_sampling);
+    RUN_TEST(test_native_configure_is_atomic);
+    RUN_TEST(test_native_concurrent_threads);
+    RUN_TEST(test_native_async_ring_backend);
+    RUN_TEST(test_native_async_ring_flushes_when_idle);
+    return UNITY_END();
+}
+
+#endif // UNIT_TEST && LOG_PLATFORM_NATIVE
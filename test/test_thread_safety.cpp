@@ -8,6 +8,8 @@
 #include <Arduino.h>
 #include <unity.h>
 #include <Logger.h>
+#include <AsyncRingBackend.h>
+#include <ThreadSafeNonBlockingBackend.h>
 
 #define TEST_THREADS 4
 #define TEST_ITERATIONS 200
@@ -21,9 +23,9 @@ class CountingBackend : public ILogBackend {
 public:
     std::atomic<int> writeCount{0};
 
-    bool write(const char* message, size_t length) override {
+    void write(const std::string& message) override { write(message.c_str(), message.length()); }
+    void write(const char* message, size_t length) override {
         writeCount++;
-        return true;
     }
 
     void flush() override {}
@@ -182,12 +184,215 @@ void test_concurrent_tag_level_changes() {
     vSemaphoreDelete(startSemaphore);
 }
 
+static std::shared_ptr<AsyncRingBackend> asyncBackend;
+
+void asyncWriterTask(void* param) {
+    for (int i = 0; i < TEST_ITERATIONS; i++) {
+        asyncBackend->write("async ring test message\r\n", 25);
+        if (i % 20 == 0) vTaskDelay(1);
+    }
+
+    threadsDone++;
+    vTaskDelete(NULL);
+}
+
+void test_async_ring_backend_concurrent_writers() {
+    threadsDone = 0;
+
+    auto sink = std::make_shared<CountingBackend>();
+    asyncBackend = std::make_shared<AsyncRingBackend>(sink);
+    TEST_ASSERT_TRUE(asyncBackend->start());
+
+    for (int i = 0; i < TEST_THREADS; i++) {
+        xTaskCreate(asyncWriterTask, "RingTask", 2048, NULL, 2, NULL);
+    }
+
+    unsigned long start = millis();
+    while (threadsDone < TEST_THREADS && (millis() - start) < 10000) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+    TEST_ASSERT_EQUAL(TEST_THREADS, threadsDone);
+
+    asyncBackend->stop();
+
+    // Every message is either delivered or counted as a ring overflow
+    int expected = TEST_THREADS * TEST_ITERATIONS;
+    TEST_ASSERT_EQUAL(expected, sink->writeCount.load() + (int)asyncBackend->getOverflowCount());
+    TEST_ASSERT_EQUAL(sink->writeCount.load(), (int)asyncBackend->getWrittenCount());
+    TEST_ASSERT_TRUE(asyncBackend->getHighWaterMark() > 0);
+
+    asyncBackend.reset();
+}
+
+void test_backend_swap_while_logging() {
+    threadsDone = 0;
+
+    countingBackend->reset();
+    Logger& logger = Logger::getInstance();
+    logger.setLogLevel(ESP_LOG_VERBOSE);
+    logger.setBackend(countingBackend);
+    logger.resetLostWrites();
+
+    startSemaphore = xSemaphoreCreateBinary();
+
+    for (int i = 0; i < TEST_THREADS; i++) {
+        xTaskCreate(loggerTask, "SwapTask", 4096, (void*)(intptr_t)i, 1, NULL);
+    }
+
+    xSemaphoreGive(startSemaphore);
+
+    // Churn the backend list under the writers; the write path takes no lock
+    unsigned long start = millis();
+    while (threadsDone < TEST_THREADS && (millis() - start) < 10000) {
+        auto extra = std::make_shared<CountingBackend>();
+        logger.addBackend(extra);
+        vTaskDelay(1);
+        logger.removeBackend(extra);
+    }
+    TEST_ASSERT_EQUAL(TEST_THREADS, threadsDone);
+
+    // countingBackend stayed in every snapshot, so nothing was lost
+    TEST_ASSERT_EQUAL(0, (int)logger.getLostWrites());
+    TEST_ASSERT_TRUE(countingBackend->writeCount.load() > 0);
+
+    vSemaphoreDelete(startSemaphore);
+}
+
+static std::shared_ptr<ThreadSafeNonBlockingBackend> sharedConsole;
+
+void consoleWriterTask(void* param) {
+    xSemaphoreTake(startSemaphore, portMAX_DELAY);
+    xSemaphoreGive(startSemaphore);  // Release the next task at once
+
+    static const char line[] = "[0][Writer][I] TSNB: contention test message well past 128 bytes, "
+                               "so the old 128-byte stack copy would have cut it off well before the end\r\n";
+    for (int i = 0; i < TEST_ITERATIONS; i++) {
+        sharedConsole->write(line, sizeof(line) - 1);
+    }
+
+    threadsDone++;
+    vTaskDelete(NULL);
+}
+
+void test_thread_safe_non_blocking_contention() {
+    const int writers = 15;
+    threadsDone = 0;
+
+    sharedConsole = std::make_shared<ThreadSafeNonBlockingBackend>();
+    startSemaphore = xSemaphoreCreateBinary();
+
+    for (int i = 0; i < writers; i++) {
+        xTaskCreate(consoleWriterTask, "TsnbTask", 2048, NULL, 1, NULL);
+    }
+    xSemaphoreGive(startSemaphore);
+
+    unsigned long start = millis();
+    while (threadsDone < writers && (millis() - start) < 10000) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+    TEST_ASSERT_EQUAL(writers, threadsDone);
+    sharedConsole->flush();
+
+    // Every message was staged or dropped, and drops only come from a full
+    // ring - collisions between writers are handed to the flusher
+    uint32_t total = writers * TEST_ITERATIONS;
+    TEST_ASSERT_EQUAL(total, sharedConsole->getWrittenMessages() + sharedConsole->getDroppedMessages());
+    TEST_ASSERT_EQUAL(sharedConsole->getBufferFullCount(), sharedConsole->getDroppedMessages());
+
+    vSemaphoreDelete(startSemaphore);
+    sharedConsole.reset();
+}
+
+// Backend that stalls like a blocked TCP socket
+class StalledBackend : public CountingBackend {
+public:
+    using CountingBackend::write;
+    void write(const char* message, size_t length) override {
+        vTaskDelay(pdMS_TO_TICKS(50));
+        CountingBackend::write(message, length);
+    }
+};
+
+void test_isolated_backend_does_not_stall_others() {
+    auto fast = std::make_shared<CountingBackend>();
+    auto stalled = std::make_shared<StalledBackend>();
+
+    Logger& logger = Logger::getInstance();
+    logger.setLogLevel(ESP_LOG_VERBOSE);
+    logger.setBackend(fast);
+    auto isolated = logger.addIsolatedBackend(stalled, 0);
+    TEST_ASSERT_NOT_NULL(isolated.get());
+
+    unsigned long start = millis();
+    for (int i = 0; i < TEST_ITERATIONS; i++) {
+        logger.logDirect(ESP_LOG_INFO, "ISO", "isolation test message");
+    }
+    unsigned long elapsed = millis() - start;
+
+    // Callers never waited on the stalled sink (200 x 50 ms if they had)
+    TEST_ASSERT_TRUE(elapsed < 1000);
+    TEST_ASSERT_EQUAL(TEST_ITERATIONS, fast->writeCount.load());
+
+    BackendQueueStats stats[2];
+    TEST_ASSERT_EQUAL(1, (int)logger.getBackendQueueStats(stats, 2));
+    TEST_ASSERT_TRUE(stats[0].dropped > 0);
+    TEST_ASSERT_TRUE(stats[0].written + stats[0].dropped <= (uint32_t)TEST_ITERATIONS);
+
+    logger.removeBackend(isolated);
+    logger.setBackend(countingBackend);
+}
+
+static std::atomic<int> subscriberHits{0};
+
+static void countingSubscriber(esp_log_level_t level, const char* tag, const char* message) {
+    if (strcmp(tag, "SUB") == 0 && strncmp(message, "sub ", 4) == 0) subscriberHits++;
+}
+
+void subscriberLogTask(void* param) {
+    for (int i = 0; i < TEST_ITERATIONS; i++) {
+        Logger::getInstance().logDirect(ESP_LOG_INFO, "SUB", "sub message");
+    }
+    threadsDone++;
+    vTaskDelete(NULL);
+}
+
+void test_subscriber_ring_concurrent_producers() {
+    threadsDone = 0;
+    subscriberHits = 0;
+
+    Logger& logger = Logger::getInstance();
+    logger.resetSubscriberDrops();
+    TEST_ASSERT_TRUE(logger.addLogSubscriber(countingSubscriber));
+    TEST_ASSERT_TRUE(logger.startSubscriberTask(1));
+
+    for (int i = 0; i < TEST_THREADS; i++) {
+        xTaskCreate(subscriberLogTask, "SubTask", 4096, NULL, 1, NULL);
+    }
+
+    unsigned long start = millis();
+    while (threadsDone < TEST_THREADS && (millis() - start) < 10000) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+    TEST_ASSERT_EQUAL(TEST_THREADS, threadsDone);
+
+    // Stopping delivers the backlog: every message arrived or was counted
+    logger.stopSubscriberTask();
+    logger.removeLogSubscriber(countingSubscriber);
+    TEST_ASSERT_EQUAL(TEST_THREADS * TEST_ITERATIONS,
+                      subscriberHits.load() + (int)logger.getSubscriberDrops());
+}
+
 void runThreadSafetyTests() {
     UNITY_BEGIN();
 
     RUN_TEST(test_concurrent_logging);
     RUN_TEST(test_concurrent_buffer_pool);
     RUN_TEST(test_concurrent_tag_level_changes);
+    RUN_TEST(test_async_ring_backend_concurrent_writers);
+    RUN_TEST(test_backend_swap_while_logging);
+    RUN_TEST(test_isolated_backend_does_not_stall_others);
+    RUN_TEST(test_thread_safe_non_blocking_contention);
+    RUN_TEST(test_subscriber_ring_concurrent_producers);
 
     UNITY_END();
 }
@@ -0,0 +1,333 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+# log_decode.py - part of the ESP32-Logger library
+#
+# Decodes the BinarySerialBackend wire format back into text log lines.
+# Format strings are recovered from the firmware ELF, so it must be the exact
+# image running on the device.
+#
+# Usage:
+#   python3 tools/log_decode.py firmware.elf --port /dev/ttyUSB0 [--baud 115200]
+#   python3 tools/log_decode.py firmware.elf capture.bin
+#   cat capture.bin | python3 tools/log_decode.py firmware.elf -
+#
+# PlatformIO: the ELF is .pio/build/<env>/firmware.elf
+# --port needs pyserial (pip install pyserial); files and stdin need nothing.
+
+import argparse
+import re
+import struct
+import sys
+
+FRAME_START = 0xA5
+FRAME_SYNC, FRAME_TAG, FRAME_LOG, FRAME_TEXT, FRAME_HEX, FRAME_FIELDS = 0x01, 0x02, 0x03, 0x04, 0x05, 0x06
+TAG_INLINE = 0x1F
+
+# LogFields.h value types -> struct format (FIELD_STRING has a length byte)
+FIELD_BOOL, FIELD_STRING = 0x07, 0x08
+FIELD_TYPES = {0x01: "<i", 0x02: "<I", 0x03: "<q", 0x04: "<Q", 0x05: "<f", 0x06: "<d", FIELD_BOOL: "<B",
+               FIELD_STRING: None}
+LEVELS = "NEWIDV"
+
+SPEC_RE = re.compile(
+    r"%(?P<flags>[-+ #0']*)(?P<width>\*|\d+)?(?:\.(?P<prec>\*|\d*))?"
+    r"(?P<len>hh|h|ll|l|j|z|t|L)?(?P<conv>[diouxXcsfFeEgGaApn%])"
+)
+
+
+class ElfImage:
+    """Minimal ELF reader: only what is needed to read strings by address."""
+
+    SHT_NOBITS = 8
+    SHF_ALLOC = 0x2
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF":
+            raise ValueError(f"{path}: not an ELF file")
+        is64 = self.data[4] == 2
+        endian = "<" if self.data[5] == 1 else ">"
+        if is64:
+            shoff, = struct.unpack_from(endian + "Q", self.data, 0x28)
+            shentsize, shnum = struct.unpack_from(endian + "HH", self.data, 0x3A)
+            fmt = endian + "IIQQQQIIQQ"
+        else:
+            shoff, = struct.unpack_from(endian + "I", self.data, 0x20)
+            shentsize, shnum = struct.unpack_from(endian + "HH", self.data, 0x2E)
+            fmt = endian + "IIIIIIIIII"
+
+        # (address, file offset, size) of every loaded section with contents
+        self.sections = []
+        for i in range(shnum):
+            fields = struct.unpack_from(fmt, self.data, shoff + i * shentsize)
+            sh_type, sh_flags, sh_addr, sh_offset, sh_size = fields[1], fields[2], fields[3], fields[4], fields[5]
+            if sh_flags & self.SHF_ALLOC and sh_type != self.SHT_NOBITS and sh_addr:
+                self.sections.append((sh_addr, sh_offset, sh_size))
+        self.cache = {}
+
+    def string_at(self, address):
+        if address in self.cache:
+            return self.cache[address]
+        for addr, offset, size in self.sections:
+            if addr <= address < addr + size:
+                start = offset + (address - addr)
+                end = self.data.find(b"\0", start, offset + size)
+                text = self.data[start:end if end >= 0 else offset + size].decode("utf-8", "replace")
+                self.cache[address] = text
+                return text
+        return None
+
+
+class Payload:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def remaining(self):
+        return len(self.data) - self.pos
+
+    def byte(self):
+        if self.pos >= len(self.data):
+            raise EOFError
+        b = self.data[self.pos]
+        self.pos += 1
+        return b
+
+    def bytes(self, n):
+        if self.remaining() < n:
+            raise EOFError
+        b = self.data[self.pos:self.pos + n]
+        self.pos += n
+        return b
+
+    def varint(self):
+        value, shift = 0, 0
+        while True:
+            b = self.byte()
+            value |= (b & 0x7F) << shift
+            shift += 7
+            if not b & 0x80:
+                return value
+
+    def zigzag(self):
+        v = self.varint()
+        return (v >> 1) ^ -(v & 1)
+
+
+def crc8(data, crc=0):
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+INT_BITS = {None: 32, "hh": 8, "h": 16, "l": 32, "ll": 64, "j": 64, "z": 32, "t": 32}
+
+
+def render(fmt, payload, elf, base):
+    """Re-run the printf conversions of `fmt` with arguments from `payload`."""
+    out = []
+    pos = 0
+    for m in SPEC_RE.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        conv = m.group("conv")
+        if conv == "%":
+            out.append("%")
+            continue
+        try:
+            width = m.group("width")
+            prec = m.group("prec")
+            if width == "*":
+                width = str(payload.zigzag())
+            if prec == "*":
+                prec = str(payload.zigzag())
+            flags = m.group("flags").replace("'", "")
+            spec = "%" + flags + (width or "") + ("." + prec if prec is not None else "")
+
+            if conv in "di":
+                bits = INT_BITS.get(m.group("len"), 32)
+                v = payload.zigzag()
+                if bits < 32:
+                    v = (v + (1 << (bits - 1))) % (1 << bits) - (1 << (bits - 1))
+                out.append((spec + "d") % v)
+            elif conv in "uoxX":
+                bits = INT_BITS.get(m.group("len"), 32)
+                v = payload.varint() & ((1 << bits) - 1)
+                out.append((spec + ("d" if conv == "u" else conv)) % v)
+            elif conv == "c":
+                out.append((spec + "c") % chr(payload.varint() & 0xFF))
+            elif conv in "fFeEgG":
+                v, = struct.unpack("<d", payload.bytes(8))
+                out.append((spec + conv) % v)
+            elif conv in "aA":
+                v, = struct.unpack("<d", payload.bytes(8))
+                out.append(v.hex() if conv == "a" else v.hex().upper())
+            elif conv == "p":
+                out.append("0x%x" % payload.varint())
+            elif conv == "s":
+                tagged = payload.varint()
+                if tagged & 1:
+                    s = elf.string_at(base + (tagged >> 1))
+                    if s is None:
+                        s = "<str@0x%x>" % (base + (tagged >> 1))
+                else:
+                    s = payload.bytes(tagged >> 1).decode("utf-8", "replace")
+                out.append((spec + "s") % s)
+            elif conv == "n":
+                pass
+        except EOFError:
+            out.append("<?>")  # Argument did not fit in the frame
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+class Decoder:
+    def __init__(self, elf, out):
+        self.elf = elf
+        self.out = out
+        self.base = None
+        self.timestamp = 0
+        self.tags = {}
+        self.buf = bytearray()
+        self.bad_frames = 0
+
+    def feed(self, data):
+        self.buf.extend(data)
+        while True:
+            start = self.buf.find(bytes([FRAME_START]))
+            if start < 0:
+                self.passthrough(self.buf)
+                self.buf.clear()
+                return
+            if start:
+                self.passthrough(self.buf[:start])
+                del self.buf[:start]
+            if len(self.buf) < 2:
+                return
+            length = self.buf[1]
+            if len(self.buf) < length + 3:
+                return
+            frame = bytes(self.buf[:length + 3])
+            if crc8(frame[1:length + 2]) != frame[length + 2]:
+                # Not a frame (or corrupted) - skip the start byte and resync
+                self.bad_frames += 1
+                self.passthrough(self.buf[:1])
+                del self.buf[:1]
+                continue
+            del self.buf[:length + 3]
+            self.handle(Payload(frame[2:length + 2]))
+
+    def passthrough(self, data):
+        # Bytes outside frames (ROM bootloader, panic output) are shown as-is
+        text = bytes(data).decode("utf-8", "replace")
+        if text:
+            self.out.write(text)
+
+    def handle(self, p):
+        kind = p.byte()
+        if kind == FRAME_SYNC:
+            self.timestamp = p.varint()
+            self.base, = struct.unpack("<I", p.bytes(4))
+            self.tags.clear()
+        elif kind == FRAME_TAG:
+            index = p.byte()
+            self.tags[index] = p.bytes(p.remaining()).decode("utf-8", "replace")
+        elif kind == FRAME_TEXT:
+            self.out.write(p.bytes(p.remaining()).decode("utf-8", "replace"))
+        elif kind in (FRAME_LOG, FRAME_HEX, FRAME_FIELDS):
+            if self.base is None:
+                return  # Wait for the first SYNC
+            self.timestamp = (self.timestamp + p.varint()) & 0xFFFFFFFF
+            levelTag = p.byte()
+            level, index = levelTag >> 5, levelTag & 0x1F
+            if index == TAG_INLINE:
+                tag = p.bytes(p.byte()).decode("utf-8", "replace")
+            else:
+                tag = self.tags.get(index, "#%d" % index)
+            if kind == FRAME_HEX:
+                message = self.hex_message(p)
+            elif kind == FRAME_FIELDS:
+                message = self.fields_message(p)
+            else:
+                address = self.base + p.varint()
+                fmt = self.elf.string_at(address)
+                if fmt is None:
+                    message = "<unknown format @0x%08x>" % address
+                else:
+                    message = render(fmt, p, self.elf, self.base)
+            lvl = LEVELS[level] if level < len(LEVELS) else "?"
+            self.out.write("[%d][%s] %s: %s\n" % (self.timestamp, lvl, tag, message.rstrip("\r\n")))
+        self.out.flush()
+
+    @staticmethod
+    def hex_message(p):
+        # Same text as Logger::logHex(); later chunks of a long payload show their offset
+        label = p.bytes(p.byte()).decode("utf-8", "replace")
+        total, offset = p.varint(), p.varint()
+        data = " ".join("%02X" % b for b in p.bytes(p.remaining()))
+        prefix = label + " " if label else ""
+        if offset:
+            return "%s(+%d of %d bytes): %s" % (prefix, offset, total, data)
+        return "%s(%d bytes): %s" % (prefix, total, data)
+
+    @staticmethod
+    def fields_message(p):
+        # Same text as Logger::event(): "message key=value ..." (logfmt)
+        text = p.bytes(p.byte()).decode("utf-8", "replace")
+        pairs = []
+        while p.remaining() >= 2:
+            kind, key = p.byte(), p.bytes(p.byte()).decode("utf-8", "replace")
+            if kind not in FIELD_TYPES:
+                break  # Unknown type: the rest cannot be sized
+            if kind == FIELD_STRING:
+                value = p.bytes(p.byte()).decode("utf-8", "replace")
+                if not value or any(c in value for c in ' "='):
+                    value = '"%s"' % value.replace("\\", "\\\\").replace('"', '\\"')
+            else:
+                fmt = FIELD_TYPES[kind]
+                value, = struct.unpack(fmt, p.bytes(struct.calcsize(fmt)))
+                if kind == FIELD_BOOL:
+                    value = "true" if value else "false"
+                elif isinstance(value, float):
+                    value = "%.3f" % value
+            pairs.append("%s=%s" % (key, value))
+        return " ".join(([text] if text else []) + pairs)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode BinarySerialBackend output")
+    parser.add_argument("elf", help="firmware ELF running on the device")
+    parser.add_argument("input", nargs="?", default="-", help="capture file, or - for stdin")
+    parser.add_argument("--port", help="read from a serial port (needs pyserial)")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    decoder = Decoder(ElfImage(args.elf), sys.stdout)
+
+    if args.port:
+        import serial  # Only needed for live capture
+        with serial.Serial(args.port, args.baud, timeout=0.1) as port:
+            while True:
+                decoder.feed(port.read(4096))
+    else:
+        stream = sys.stdin.buffer if args.input == "-" else open(args.input, "rb")
+        with stream:
+            while True:
+                chunk = stream.read(4096)
+                if not chunk:
+                    break
+                decoder.feed(chunk)
+
+    if decoder.bad_frames:
+        sys.stderr.write("%d corrupt frame(s) skipped\n" % decoder.bad_frames)
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass